@@ -8,11 +8,12 @@ struct fullcont {
   struct cont *prev_jmp;
 
   struct checkpoint *cp;
+  pic_value handlers;
 
   char *stk_pos, *stk_ptr;
   ptrdiff_t stk_len;
 
-  pic_value *st_ptr;
+  pic_value *st_ptr, *st_base;
   size_t sp_offset;
   ptrdiff_t st_len;
 
@@ -20,8 +21,6 @@ struct fullcont {
   size_t ci_offset;
   ptrdiff_t ci_len;
 
-  const struct code *ip;
-
   struct object **arena;
   size_t arena_size, arena_idx;
 
@@ -62,6 +61,9 @@ cont_mark(pic_state *pic, void *data, void (*mark)(pic_state *, pic_value))
     }
   }
 
+  /* exception handlers */
+  mark(pic, cont->handlers);
+
   /* stack */
   for (stack = cont->st_ptr; stack != cont->st_ptr + cont->sp_offset; ++stack) {
     mark(pic, *stack);
@@ -108,14 +110,14 @@ native_stack_length(char **pos)
 static void NOINLINE
 save_cont(pic_state *pic, struct fullcont *cont)
 {
-  void pic_vm_tear_off(pic_state *);
   char *pos;
 
-  pic_vm_tear_off(pic);         /* tear off */
+  pic_vm_tear_off(pic, pic->cibase); /* tear off */
 
   cont->prev_jmp = pic->cc;
 
   cont->cp = pic->cp;
+  cont->handlers = pic->handlers;
 
   cont->stk_len = native_stack_length(&pos);
   cont->stk_pos = pos;
@@ -123,18 +125,18 @@ save_cont(pic_state *pic, struct fullcont *cont)
   cont->stk_ptr = pic_malloc(pic, cont->stk_len);
   memcpy(cont->stk_ptr, cont->stk_pos, cont->stk_len);
 
+  /* only the live part; fp and regs are rebased against st_base on restore */
   cont->sp_offset = pic->sp - pic->stbase;
-  cont->st_len = pic->stend - pic->stbase;
+  cont->st_len = cont->sp_offset;
+  cont->st_base = pic->stbase;
   cont->st_ptr = pic_malloc(pic, sizeof(pic_value) * cont->st_len);
   memcpy(cont->st_ptr, pic->stbase, sizeof(pic_value) * cont->st_len);
 
   cont->ci_offset = pic->ci - pic->cibase;
-  cont->ci_len = pic->ciend - pic->cibase;
+  cont->ci_len = cont->ci_offset + 1;
   cont->ci_ptr = pic_malloc(pic, sizeof(struct callinfo) * cont->ci_len);
   memcpy(cont->ci_ptr, pic->cibase, sizeof(struct callinfo) * cont->ci_len);
 
-  cont->ip = pic->ip;
-
   cont->arena_idx = pic->arena_idx;
   cont->arena_size = pic->arena_size;
   cont->arena = pic_malloc(pic, sizeof(struct object *) * pic->arena_size);
@@ -159,6 +161,7 @@ restore_cont(pic_state *pic, struct fullcont *cont)
 {
   char v;
   struct fullcont *tmp = cont;
+  struct callinfo *ci;
 
   if (&v < picrin_native_stack_start) {
     if (&v > cont->stk_pos) native_stack_extend(pic, cont);
@@ -169,18 +172,25 @@ restore_cont(pic_state *pic, struct fullcont *cont)
 
   pic->cc = cont->prev_jmp;
   pic->cp = cont->cp;
+  pic->handlers = cont->handlers;
+
+  pic_vm_tear_off(pic, pic->cibase);
+  pic_vm_reserve(pic, (int)(cont->st_len - (pic->sp - pic->stbase)), (int)(cont->ci_len - (pic->ci - pic->cibase)));
 
-  assert(pic->stend - pic->stbase >= cont->st_len);
   memcpy(pic->stbase, cont->st_ptr, sizeof(pic_value) * cont->st_len);
   pic->sp = pic->stbase + cont->sp_offset;
-  pic->stend = pic->stbase + cont->st_len;
 
-  assert(pic->ciend - pic->cibase >= cont->ci_len);
   memcpy(pic->cibase, cont->ci_ptr, sizeof(struct callinfo) * cont->ci_len);
   pic->ci = pic->cibase + cont->ci_offset;
-  pic->ciend = pic->cibase + cont->ci_len;
 
-  pic->ip = cont->ip;
+  /* the stack may have moved since the continuation was captured */
+  for (ci = pic->ci; ci > pic->cibase; --ci) {
+    ci->fp = pic->stbase + (ci->fp - cont->st_base);
+    if (ci->irep != NULL) {
+      ci->regs = pic->stbase + (ci->regs - cont->st_base);
+    }
+  }
+  pic_vm_recover(pic);
 
   assert(pic->arena_size >= cont->arena_size);
   memcpy(pic->arena, cont->arena, sizeof(struct object *) * cont->arena_size);
@@ -0,0 +1,95 @@
+#include "picrin.h"
+#include "picrin/extra.h"
+
+static pic_value
+size_value(pic_state *pic, size_t n)
+{
+  if (n <= INT_MAX) {
+    return pic_int_value(pic, (int)n);
+  }
+  return pic_float_value(pic, (double)n);
+}
+
+static pic_value
+pic_gc_gc(pic_state *pic)
+{
+  pic_get_args(pic, "");
+
+  pic_gc(pic);
+
+  return pic_undef_value(pic);
+}
+
+static pic_value
+pic_gc_budget_(pic_state *pic)
+{
+  int budget = -1;
+
+  pic_get_args(pic, "|i", &budget);
+
+  return pic_int_value(pic, pic_gc_budget(pic, budget));
+}
+
+static pic_value
+allocation_alist(pic_state *pic, struct pic_gc_stats *stats)
+{
+  pic_value alist = pic_nil_value(pic), name;
+  size_t n = 0;
+  int type;
+
+  for (type = 0; type <= PIC_TYPE_MAX; ++type) {
+    if (stats->allocated[type] == 0) {
+      continue;
+    }
+    name = pic_intern_cstr(pic, pic_typename(pic, type));
+
+    /* adjacent types may share a name, e.g. procedure */
+    if (! pic_nil_p(pic, alist) && pic_eq_p(pic, pic_caar(pic, alist), name)) {
+      n += stats->allocated[type];
+      pic_set_cdr(pic, pic_car(pic, alist), size_value(pic, n));
+    } else {
+      n = stats->allocated[type];
+      alist = pic_cons(pic, pic_cons(pic, name, size_value(pic, n)), alist);
+    }
+  }
+  return pic_reverse(pic, alist);
+}
+
+static pic_value
+pic_gc_stats_(pic_state *pic)
+{
+  struct pic_gc_stats stats;
+  pic_value alist;
+
+  pic_get_args(pic, "");
+
+  pic_gc_stats(pic, &stats);
+
+#define FIELD(name, v) alist = pic_cons(pic, pic_cons(pic, pic_intern_lit(pic, name), v), alist)
+
+  alist = pic_nil_value(pic);
+  FIELD("allocated", allocation_alist(pic, &stats));
+  FIELD("weak-entries", size_value(pic, stats.weak_entries));
+  FIELD("weak-maps", size_value(pic, stats.weak_maps));
+  FIELD("pages", size_value(pic, stats.pages));
+  FIELD("heap", size_value(pic, stats.heap));
+  FIELD("live", size_value(pic, stats.live));
+  FIELD("max-pause", pic_float_value(pic, stats.max_pause));
+  FIELD("total-pause", pic_float_value(pic, stats.total_pause));
+  FIELD("minor-collections", size_value(pic, stats.minor_collections));
+  FIELD("collections", size_value(pic, stats.collections));
+
+#undef FIELD
+
+  return alist;
+}
+
+void
+pic_init_gc(pic_state *pic)
+{
+  pic_deflibrary(pic, "picrin.gc");
+
+  pic_defun(pic, "gc", pic_gc_gc);
+  pic_defun(pic, "gc-budget", pic_gc_budget_);
+  pic_defun(pic, "gc-stats", pic_gc_stats_);
+}
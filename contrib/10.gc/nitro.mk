@@ -0,0 +1,8 @@
+CONTRIB_INITS += gc
+CONTRIB_SRCS += contrib/10.gc/gc.c
+CONTRIB_TESTS += test-gc
+
+test-gc: bin/picrin
+	for test in `ls contrib/10.gc/t/*.scm`; do \
+	  $(TEST_RUNNER) $$test; \
+	done
@@ -0,0 +1,47 @@
+(import (scheme base)
+        (picrin base)
+        (picrin test)
+        (picrin gc))
+
+(define (stat name)
+  (cdr (assq name (gc-stats))))
+
+(let ((n (stat 'collections)))
+  (gc)
+  (test #t (> (stat 'collections) n)))
+
+(test #t (> (stat 'live) 0))
+(test #t (<= (stat 'live) (stat 'heap)))
+(test #t (> (stat 'pages) 0))
+(test #t (>= (stat 'total-pause) (stat 'max-pause)))
+(test #t (> (stat 'weak-maps) 0))
+
+(let ((n (cdr (assq 'pair (stat 'allocated)))))
+  (make-list 100)
+  (test #t (> (cdr (assq 'pair (stat 'allocated))) n)))
+
+(let ((old (gc-budget)))
+  (test old (gc-budget 0))
+  (test 0 (gc-budget old)))
+
+;; ephemerons
+(define e1 (make-ephemeron))
+(define e2 (make-ephemeron))
+(define k1 (list 'k1))
+
+(define (chain!)
+  (let ((k2 (list 'k2)))
+    (e1 k1 k2)
+    (e2 k2 (list 'v))))
+
+(chain!)
+(gc)
+(test '(v) (cdr (e2 (cdr (e1 k1)))))
+
+(let ((n (begin (gc) (stat 'weak-entries))))
+  (let loop ((i 0))
+    (when (< i 1000)
+      (e1 (list i) i)
+      (loop (+ i 1))))
+  (gc)
+  (test #t (< (stat 'weak-entries) (+ n 1000))))
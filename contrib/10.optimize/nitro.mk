@@ -0,0 +1,8 @@
+CONTRIB_INITS += optimize
+CONTRIB_SRCS += contrib/10.optimize/optimize.c
+CONTRIB_TESTS += test-optimize
+
+test-optimize: bin/picrin
+	for test in `ls contrib/10.optimize/t/*.scm`; do \
+	  $(TEST_RUNNER) $$test; \
+	done
@@ -0,0 +1,56 @@
+#include "picrin.h"
+#include "picrin/extra.h"
+
+static const struct {
+  const char *name;
+  int pass;
+} passes[] = {
+  { "beta", PIC_OPT_BETA },
+  { "inline", PIC_OPT_INLINE },
+  { "propagate", PIC_OPT_PROPAGATE },
+  { "fold", PIC_OPT_FOLD },
+  { "dce", PIC_OPT_DCE },
+  { "lift", PIC_OPT_LIFT }
+};
+
+#define NPASSES (sizeof passes / sizeof passes[0])
+
+static pic_value
+pic_optimize_passes_(pic_state *pic)
+{
+  pic_value list = pic_nil_value(pic), name, it;
+  int argc, set = 0, old;
+  size_t i;
+
+  argc = pic_get_args(pic, "|o", &list);
+
+  if (argc > 0) {
+    pic_for_each (name, list, it) {
+      for (i = 0; i < NPASSES; ++i) {
+        if (pic_sym_p(pic, name) && strcmp(pic_sym(pic, name), passes[i].name) == 0)
+          break;
+      }
+      if (i == NPASSES) {
+        pic_error(pic, "unknown optimizer pass", 1, name);
+      }
+      set |= passes[i].pass;
+    }
+  }
+  old = pic_optimize_passes(pic, argc > 0 ? set : -1);
+
+  list = pic_nil_value(pic);
+  for (i = NPASSES; i-- > 0;) {
+    if (old & passes[i].pass) {
+      list = pic_cons(pic, pic_intern_cstr(pic, passes[i].name), list);
+    }
+  }
+  return list;
+}
+
+void
+pic_init_optimize(pic_state *pic)
+{
+  pic_deflibrary(pic, "picrin.optimize");
+
+  pic_defun(pic, "optimize-passes", pic_optimize_passes_);
+}
@@ -0,0 +1,69 @@
+(import (scheme base)
+        (scheme eval)
+        (picrin base)
+        (picrin test)
+        (picrin optimize))
+
+(define all (optimize-passes))
+
+(test '(beta inline propagate fold dce lift) all)
+(test all (optimize-passes '(fold dce)))
+(test '(dce fold) (reverse (optimize-passes all)))
+(test #t (guard (e (#t (error-object? e)))
+           (optimize-passes '(no-such-pass))))
+
+(define program
+  '(lambda (n)
+     (define (twice x) (+ x x))
+     (define (square x) (* x x))
+     (let ((a 3) (b 4))
+       (list (if (< a b) (+ (square a) (square b)) 'no)
+             (twice n)
+             (let loop ((i 0) (s 0))
+               (if (= i n) s (loop (+ i 1) (+ s i))))))))
+
+;; every combination of passes computes the same
+(let loop ((sets '(() (beta) (inline) (propagate fold) (fold dce) (beta inline propagate fold dce lift))))
+  (unless (null? sets)
+    (optimize-passes (car sets))
+    (let ((f (eval program "picrin.base")))
+      (optimize-passes all)
+      (test '(25 20 45) (f 10)))
+    (loop (cdr sets))))
+
+;; folding leaves errors to the run time
+(define (bad) (car 1))
+
+(test #t (guard (e (#t (error-object? e)))
+           (bad)))
+
+(define (inc x) (+ x 1))
+(define (use-inc) (inc 1))
+
+(test 2 (use-inc))
+
+;; inlined copies see later assignments and definitions
+(set! inc (lambda (x) (* x 100)))
+(test 100 (use-inc))
+
+(define (ten) 10)
+(define (use-ten) (ten))
+(test 10 (use-ten))
+(define (ten) 20)
+(test 20 (use-ten))
+
+(define (slow x) (set! slow-count (+ slow-count 1)) x)
+(define slow-count 0)
+(define (drop) (let ((unused (slow 1))) 'done))
+
+(test 'done (drop))
+(test 1 slow-count)
+
+;; quoted data may be mutated, so it is not folded on
+(define (mutate-literal-list) (define l '(1 2)) (set-car! l 9) (car l))
+(define (mutate-literal-vector) (define v '#(1 2)) (vector-set! v 0 9) (vector-ref v 0))
+(define (mutate-literal-string) (define s "abc") (string-set! s 0 #\x) (string-ref s 0))
+
+(test 9 (mutate-literal-list))
+(test 9 (mutate-literal-vector))
+(test #\x (mutate-literal-string))
@@ -0,0 +1,8 @@
+CONTRIB_INITS += profile
+CONTRIB_SRCS += contrib/10.profile/profile.c
+CONTRIB_TESTS += test-profile
+
+test-profile: bin/picrin
+	for test in `ls contrib/10.profile/t/*.scm`; do \
+	  $(TEST_RUNNER) $$test; \
+	done
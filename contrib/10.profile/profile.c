@@ -0,0 +1,465 @@
+/**
+ * See Copyright Notice in picrin.h
+ */
+
+/*
+ * A sampling profiler. The VM calls profile_sample on every n-th
+ * procedure call or loop iteration, or on the first one after a SIGPROF
+ * tick, and the call stack found on pic->ci is added to a tree of stacks
+ * rooted at the outermost frame. Of deeper stacks only the innermost
+ * PIC_BACKTRACE_DEPTH frames are kept, under a frame standing for the
+ * rest. Frames are told apart by irep or native function and
+ * are only named when the profile is written out, after the global
+ * variables they are bound to. Each state has a profile of its own,
+ * released with it, but the timer is shared by the process, so only one
+ * state is sampled at a time.
+ */
+
+#include "picrin.h"
+#include "picrin/extra.h"
+#include "picrin/private/object.h"
+#include "picrin/private/state.h"
+#include "picrin/private/vm.h"
+
+#if PIC_USE_LIBC && (defined(__unix__) || (defined(__APPLE__) && defined(__MACH__)))
+# include <signal.h>
+# include <sys/time.h>
+# define PROFILE_TIMER 1
+#endif
+
+#ifndef PROFILE_INTERVAL
+# define PROFILE_INTERVAL 1000  /* microseconds of cpu time between ticks */
+#endif
+
+#ifndef PROFILE_PERIOD
+# define PROFILE_PERIOD 1000    /* calls between samples without the timer */
+#endif
+
+struct frame {
+  struct irep *irep;            /* NULL for native functions */
+  pic_func_t func;              /* both NULL for truncated frames */
+  int parent, child, sibling;   /* indices into frames, -1 if none */
+  int count;                    /* samples whose innermost frame is this */
+};
+
+struct profile {
+  pic_state *pic;
+  struct frame *frames;         /* frames[0] is the root */
+  int len, size;
+  int samples;
+};
+
+static struct profile *sampled; /* NULL if stopped */
+
+static int
+child_frame(pic_state *pic, struct profile *p, int parent, struct irep *irep, pic_func_t func)
+{
+  struct frame *f;
+  int i;
+
+  for (i = p->frames[parent].child; i != -1; i = p->frames[i].sibling) {
+    if (p->frames[i].irep == irep && p->frames[i].func == func) {
+      return i;
+    }
+  }
+
+  if (p->len == p->size) {
+    p->size *= 2;
+    p->frames = pic_realloc(pic, p->frames, sizeof(struct frame) * p->size);
+  }
+  i = p->len++;
+  f = p->frames + i;
+  f->irep = irep;
+  f->func = func;
+  f->parent = parent;
+  f->child = -1;
+  f->sibling = p->frames[parent].child;
+  f->count = 0;
+  p->frames[parent].child = i;
+
+  if (irep) {
+    pic_irep_incref(pic, irep); /* keep the address from being reused */
+  }
+  return i;
+}
+
+static void
+profile_sample(pic_state *pic)
+{
+  struct profile *p = sampled;
+  struct callinfo *ci;
+  struct proc *proc;
+  int node = 0;
+
+  if (pic->ci - pic->cibase > PIC_BACKTRACE_DEPTH) {
+    ci = pic->ci - PIC_BACKTRACE_DEPTH + 1;
+    node = child_frame(pic, p, node, NULL, NULL);
+  } else {
+    ci = pic->cibase + 1;
+  }
+  for (; ci <= pic->ci; ++ci) {
+    if (! pic_proc_p(pic, ci->fp[0])) {
+      continue;
+    }
+    proc = pic_proc_ptr(pic, ci->fp[0]);
+    if (proc->tt == PIC_TYPE_FUNC) {
+      node = child_frame(pic, p, node, NULL, proc->u.f.func);
+    } else {
+      node = child_frame(pic, p, node, proc->u.i.irep, NULL);
+    }
+  }
+  p->frames[node].count++;
+  p->samples++;
+}
+
+static void
+profile_clear(pic_state *pic, struct profile *p)
+{
+  int i;
+
+  for (i = 1; i < p->len; ++i) {
+    if (p->frames[i].irep) {
+      pic_irep_decref(pic, p->frames[i].irep);
+    }
+  }
+  p->len = 1;
+  p->samples = 0;
+  p->frames[0].child = -1;
+  p->frames[0].count = 0;
+}
+
+#if PROFILE_TIMER
+
+static void
+profile_tick(int PIC_UNUSED(sig))
+{
+  if (sampled) {
+    pic_sample_soon(sampled->pic);
+  }
+}
+
+static bool
+profile_timer(bool on)
+{
+  struct sigaction sa;
+  struct itimerval it;
+
+  it.it_interval.tv_sec = 0;
+  it.it_interval.tv_usec = on ? PROFILE_INTERVAL : 0;
+  it.it_value = it.it_interval;
+
+  if (on) {
+    sa.sa_handler = profile_tick;
+    sa.sa_flags = SA_RESTART;
+    sigemptyset(&sa.sa_mask);
+    if (sigaction(SIGPROF, &sa, NULL) != 0) {
+      return false;
+    }
+  }
+  return setitimer(ITIMER_PROF, &it, NULL) == 0;
+}
+
+#else
+
+static bool
+profile_timer(bool PIC_UNUSED(on))
+{
+  return false;
+}
+
+#endif
+
+/* naming */
+
+struct name {
+  const char *str;
+  bool inner;                   /* a lambda inside the named procedure */
+};
+
+KHASH_DECLARE(names, struct irep *, struct name)
+KHASH_DEFINE(names, struct irep *, struct name, kh_ptr_hash_func, kh_ptr_hash_equal)
+
+struct naming {
+  khash_t(names) ireps;
+  struct native {
+    pic_func_t func;
+    const char *str;
+  } *natives;
+  int nlen, nsize;
+  char **strs;                  /* copies of the names, freed afterwards */
+  int slen, ssize;
+};
+
+static const char *
+naming_str(pic_state *pic, struct naming *n, pic_value uid)
+{
+  const char *src = pic_str(pic, pic_sym_name(pic, uid));
+  char *str;
+
+  if (n->slen == n->ssize) {
+    n->ssize = n->ssize * 2 + 16;
+    n->strs = pic_realloc(pic, n->strs, sizeof(char *) * n->ssize);
+  }
+  str = pic_malloc(pic, strlen(src) + 1);
+  strcpy(str, src);
+  return n->strs[n->slen++] = str;
+}
+
+static void
+naming_irep(pic_state *pic, struct naming *n, struct irep *irep, const char *str, bool inner)
+{
+  int ret, it;
+  size_t i;
+
+  it = kh_put(names, &n->ireps, irep, &ret);
+  if (ret == 0) {
+    return;                     /* named through another binding */
+  }
+  kh_val(&n->ireps, it).str = str;
+  kh_val(&n->ireps, it).inner = inner;
+
+  for (i = 0; i < irep->nirep; ++i) {
+    naming_irep(pic, n, irep->irep[i], str, true);
+  }
+}
+
+static void
+naming_open(pic_state *pic, struct naming *n)
+{
+  khash_t(weak) *h = &pic_weak_ptr(pic, pic->globals)->hash;
+  struct cell *cell;
+  struct proc *proc;
+  int it;
+
+  kh_init(names, &n->ireps);
+  n->natives = NULL;
+  n->nlen = n->nsize = 0;
+  n->strs = NULL;
+  n->slen = n->ssize = 0;
+
+  for (it = kh_begin(h); it != kh_end(h); ++it) {
+    if (! kh_exist(h, it)) {
+      continue;
+    }
+    cell = pic_cell_ptr(pic, kh_val(h, it));
+    if (! cell->defined || ! pic_proc_p(pic, cell->value)) {
+      continue;
+    }
+    proc = pic_proc_ptr(pic, cell->value);
+    if (proc->tt == PIC_TYPE_FUNC) {
+      if (proc->u.f.localc > 0) {
+        continue;               /* closures such as parameters share their function */
+      }
+      if (n->nlen == n->nsize) {
+        n->nsize = n->nsize * 2 + 16;
+        n->natives = pic_realloc(pic, n->natives, sizeof(struct native) * n->nsize);
+      }
+      n->natives[n->nlen].func = proc->u.f.func;
+      n->natives[n->nlen].str = naming_str(pic, n, pic_obj_value(cell->uid));
+      n->nlen++;
+    } else if (kh_get(names, &n->ireps, proc->u.i.irep) == kh_end(&n->ireps)) {
+      naming_irep(pic, n, proc->u.i.irep, naming_str(pic, n, pic_obj_value(cell->uid)), false);
+    }
+  }
+}
+
+static void
+naming_close(pic_state *pic, struct naming *n)
+{
+  int i;
+
+  for (i = 0; i < n->slen; ++i) {
+    pic_free(pic, n->strs[i]);
+  }
+  pic_free(pic, n->strs);
+  pic_free(pic, n->natives);
+  kh_destroy(names, &n->ireps);
+}
+
+static void
+write_frame(pic_state *pic, struct naming *n, struct frame *f, pic_value port)
+{
+  int i, it;
+
+  if (f->func == NULL && f->irep == NULL) {
+    pic_fprintf(pic, port, "(truncated)");
+    return;
+  }
+  if (f->func) {
+    for (i = 0; i < n->nlen; ++i) {
+      if (n->natives[i].func == f->func) {
+        pic_fprintf(pic, port, "%s", n->natives[i].str);
+        return;
+      }
+    }
+    pic_fprintf(pic, port, "(native function)");
+    return;
+  }
+
+  it = kh_get(names, &n->ireps, f->irep);
+  if (it == kh_end(&n->ireps)) {
+    pic_fprintf(pic, port, "(anonymous lambda)");
+  } else if (kh_val(&n->ireps, it).inner) {
+    pic_fprintf(pic, port, "(lambda in %s)", kh_val(&n->ireps, it).str);
+  } else {
+    pic_fprintf(pic, port, "%s", kh_val(&n->ireps, it).str);
+  }
+}
+
+/* one line per stack, outermost frame first, in the collapsed format of flamegraph.pl */
+static void
+write_stacks(pic_state *pic, struct profile *p, struct naming *n, pic_value port)
+{
+  int *path, i, j, k;
+
+  path = pic_malloc(pic, sizeof(int) * (PIC_BACKTRACE_DEPTH + 1));
+
+  for (i = 1; i < p->len; ++i) {
+    if (p->frames[i].count == 0) {
+      continue;
+    }
+    k = 0;
+    for (j = i; j != 0; j = p->frames[j].parent) {
+      path[k++] = j;
+    }
+    while (k-- > 0) {
+      write_frame(pic, n, p->frames + path[k], port);
+      pic_fprintf(pic, port, k > 0 ? ";" : " %d\n", p->frames[i].count);
+    }
+  }
+
+  pic_free(pic, path);
+}
+
+static void
+profile_stop(pic_state *pic, struct profile *p)
+{
+  if (sampled == p) {
+    profile_timer(false);
+    pic_atsample(pic, 0, NULL);
+    sampled = NULL;
+  }
+}
+
+static void
+profile_dtor(pic_state *pic, void *data)
+{
+  struct profile *p = data;
+
+  profile_stop(pic, p);
+  profile_clear(pic, p);
+  pic_free(pic, p->frames);
+  pic_free(pic, p);
+}
+
+static const pic_data_type profile_type = { "profile", profile_dtor, NULL };
+
+#define get_profile(pic) ((struct profile *)pic_data(pic, pic_closure_ref(pic, 0)))
+
+static pic_value
+pic_profile_start(pic_state *pic)
+{
+  struct profile *p = get_profile(pic);
+  int period = 0;
+
+  pic_get_args(pic, "|i", &period);
+
+  if (period < 0) {
+    pic_error(pic, "profile-start: period must be positive", 1, pic_int_value(pic, period));
+  }
+  if (sampled != NULL && sampled != p) {
+    pic_error(pic, "profile-start: another state is being profiled", 0);
+  }
+
+  sampled = p;
+  if (period == 0 && profile_timer(true)) {
+    pic_atsample(pic, 0, profile_sample);
+  } else {
+    profile_timer(false);
+    pic_atsample(pic, period == 0 ? PROFILE_PERIOD : period, profile_sample);
+  }
+  return pic_undef_value(pic);
+}
+
+static pic_value
+pic_profile_stop(pic_state *pic)
+{
+  pic_get_args(pic, "");
+
+  profile_stop(pic, get_profile(pic));
+
+  return pic_undef_value(pic);
+}
+
+static pic_value
+pic_profile_reset(pic_state *pic)
+{
+  pic_get_args(pic, "");
+
+  profile_clear(pic, get_profile(pic));
+
+  return pic_undef_value(pic);
+}
+
+static pic_value
+pic_profile_samples(pic_state *pic)
+{
+  pic_get_args(pic, "");
+
+  return pic_int_value(pic, get_profile(pic)->samples);
+}
+
+static pic_value
+pic_profile_write(pic_state *pic)
+{
+  struct naming n;
+  pic_value port = pic_stdout(pic), e;
+
+  pic_get_args(pic, "|o", &port);
+
+  naming_open(pic, &n);
+  pic_try {
+    write_stacks(pic, get_profile(pic), &n, port);
+  }
+  pic_catch(e) {
+    naming_close(pic, &n);
+    pic_raise(pic, e);
+  }
+  naming_close(pic, &n);
+
+  return pic_undef_value(pic);
+}
+
+static void
+profile_defun(pic_state *pic, const char *name, pic_func_t f, pic_value profile)
+{
+  pic_define(pic, pic_current_library(pic), name, pic_lambda(pic, f, 1, profile));
+  pic_export(pic, pic_intern_cstr(pic, name));
+}
+
+void
+pic_init_profile(pic_state *pic)
+{
+  struct profile *p;
+  pic_value profile;
+
+  p = pic_malloc(pic, sizeof(struct profile));
+  p->pic = pic;
+  p->size = 64;
+  p->frames = pic_malloc(pic, sizeof(struct frame) * p->size);
+  p->len = 1;
+  p->samples = 0;
+  p->frames[0].irep = NULL;
+  p->frames[0].func = NULL;
+  p->frames[0].parent = p->frames[0].child = p->frames[0].sibling = -1;
+  p->frames[0].count = 0;
+  profile = pic_data_value(pic, p, &profile_type);
+
+  pic_deflibrary(pic, "picrin.profile");
+
+  profile_defun(pic, "profile-start", pic_profile_start, profile);
+  profile_defun(pic, "profile-stop", pic_profile_stop, profile);
+  profile_defun(pic, "profile-reset", pic_profile_reset, profile);
+  profile_defun(pic, "profile-samples", pic_profile_samples, profile);
+  profile_defun(pic, "profile-write", pic_profile_write, profile);
+}
@@ -0,0 +1,44 @@
+(import (scheme base)
+        (picrin base)
+        (picrin test)
+        (picrin profile))
+
+(define (fib n)
+  (if (< n 2)
+      n
+      (+ (fib (- n 1)) (fib (- n 2)))))
+
+(define (contains? str sub)
+  (let ((n (string-length sub)))
+    (let loop ((i 0))
+      (cond ((> (+ i n) (string-length str)) #f)
+            ((string=? (substring str i (+ i n)) sub) #t)
+            (else (loop (+ i 1)))))))
+
+(define (profile-string)
+  (let ((port (open-output-string)))
+    (profile-write port)
+    (get-output-string port)))
+
+(define (spin n)
+  (let loop ((i 0))
+    (if (< i n)
+        (loop (+ i 1)))))
+
+(profile-reset)
+(profile-start 1)
+(fib 15)
+(spin 1000)
+(profile-stop)
+
+(test #t (> (profile-samples) 1000))
+(test #t (contains? (profile-string) "/fib;"))
+(test #t (contains? (profile-string) "/spin) "))
+
+(let ((n (profile-samples)))
+  (fib 10)
+  (test n (profile-samples)))
+
+(profile-reset)
+(test 0 (profile-samples))
+(test "" (profile-string))
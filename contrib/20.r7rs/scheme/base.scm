@@ -85,7 +85,10 @@
 
   ;; 4.2.7. Exception handling
 
-  (define-syntax (guard-aux reraise . clauses)
+  ;; guard-aux selects a clause and returns a thunk running its body,
+  ;; or #f when the condition should be re-raised
+
+  (define-syntax (guard-aux . clauses)
     (letrec
         ((else?
           (lambda (clause)
@@ -94,48 +97,35 @@
           (lambda (clause)
             (and (list? clause) (= (length clause) 3) (equal? #'=> (list-ref clause 1))))))
       (if (null? clauses)
-          reraise
+          #f
           (let ((clause (car clauses))
                 (rest (cdr clauses)))
             (cond
              ((else? clause)
-              #`(begin #,@(cdr clause)))
+              #`(lambda () #,@(cdr clause)))
              ((=>? clause)
               #`(let ((tmp #,(list-ref clause 0)))
                   (if tmp
-                      (#,(list-ref clause 2) tmp)
-                      (guard-aux #,reraise #,@rest))))
+                      (lambda () (#,(list-ref clause 2) tmp))
+                      (guard-aux #,@rest))))
              ((= (length clause) 1)
-              #`(or #,(car clause) (guard-aux #,reraise #,@rest)))
+              #`(let ((tmp #,(car clause)))
+                  (if tmp
+                      (lambda () tmp)
+                      (guard-aux #,@rest))))
              (else
               #`(if #,(car clause)
-                    (begin #,@(cdr clause))
-                    (guard-aux #,reraise #,@rest))))))))
+                    (lambda () #,@(cdr clause))
+                    (guard-aux #,@rest))))))))
 
   (define-syntax (guard formal . body)
     (let ((var (car formal))
           (clauses (cdr formal)))
-      #`((call/cc
-          (lambda (guard-k)
-            (with-exception-handler
-             (lambda (condition)
-               ((call/cc
-                 (lambda (handler-k)
-                   (guard-k
-                    (lambda ()
-                      (let ((#,var condition))
-                        (guard-aux
-                         (handler-k
-                          (lambda ()
-                            (raise-continuable condition)))
-                         #,@clauses))))))))
-             (lambda ()
-               (call-with-values
-                   (lambda () #,@body)
-                 (lambda args
-                   (guard-k
-                    (lambda ()
-                      (apply values args))))))))))))
+      #`(with-guard
+         (lambda (#,var)
+           (guard-aux #,@clauses))
+         (lambda ()
+           #,@body))))
 
   (export guard)
 
@@ -789,12 +779,6 @@
   (define (open-input-string str)
     (open-input-bytevector (list->bytevector (map char->integer (string->list str)))))
 
-  (define (open-output-string)
-    (open-output-bytevector))
-
-  (define (get-output-string port)
-    (list->string (map integer->char (bytevector->list (get-output-bytevector port)))))
-
   (define (read-char . opt)
     (let ((b (apply read-u8 opt)))
       (if (eof-object? b)
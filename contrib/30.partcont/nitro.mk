@@ -1 +1,3 @@
+CONTRIB_INITS += partcont
+CONTRIB_SRCS += contrib/30.partcont/src/partcont.c
 CONTRIB_LIBS += $(wildcard contrib/30.partcont/piclib/*.scm)
@@ -0,0 +1,33 @@
+#include "picrin.h"
+#include "picrin/extra.h"
+#include "picrin/private/object.h"
+
+static pic_value
+pic_control_reset(pic_state *pic)
+{
+  pic_value thunk;
+
+  pic_get_args(pic, "l", &thunk);
+
+  return pic_reset(pic, thunk);
+}
+
+static pic_value
+pic_control_shift(pic_state *pic)
+{
+  pic_value proc;
+
+  pic_get_args(pic, "l", &proc);
+
+  return pic_shift(pic, proc);
+}
+
+void
+pic_init_partcont(pic_state *pic)
+{
+  pic_deflibrary(pic, "picrin.control");
+
+  /* wrapped by the reset and shift syntax of the library */
+  pic_define(pic, "picrin.control", "reset", pic_lambda(pic, pic_control_reset, 0));
+  pic_define(pic, "picrin.control", "shift", pic_lambda(pic, pic_control_shift, 0));
+}
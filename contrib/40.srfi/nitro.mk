@@ -1,6 +1,7 @@
 CONTRIB_INITS += \
 	srfi_0 \
-	srfi_106
+	srfi_106 \
+	srfi_125
 CONTRIB_LIBS += \
 	contrib/40.srfi/srfi/0.scm\
 	contrib/40.srfi/srfi/1.scm\
@@ -11,10 +12,13 @@ CONTRIB_LIBS += \
 	contrib/40.srfi/srfi/60.scm\
 	contrib/40.srfi/srfi/95.scm\
 	contrib/40.srfi/srfi/106.scm\
-	contrib/40.srfi/srfi/111.scm
+	contrib/40.srfi/srfi/111.scm\
+	contrib/40.srfi/srfi/125.scm\
+	contrib/40.srfi/srfi/69.scm
 CONTRIB_SRCS += \
 	contrib/40.srfi/src/0.c\
-	contrib/40.srfi/src/106.c
+	contrib/40.srfi/src/106.c\
+	contrib/40.srfi/src/125.c
 CONTRIB_TESTS += test-srfi
 
 test-srfi: bin/picrin
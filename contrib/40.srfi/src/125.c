@@ -0,0 +1,762 @@
+#include "picrin.h"
+#include "picrin/extra.h"
+#include "picrin/private/object.h"
+
+#include <ctype.h>
+#include <limits.h>
+#include <string.h>
+
+/*
+ * Hash tables keyed by eq?, eqv?, equal?, string=? or a user supplied
+ * equivalence. Entries are chained in a power-of-two bucket array and
+ * keep their hash, so growing never calls back into Scheme. Growing is
+ * incremental: a second array twice as large is allocated and every
+ * later operation moves a few buckets over until the old one is empty.
+ *
+ * Weak tables keep their object keys in an ephemeron map of the core,
+ * so that the collector drops an entry once its key is otherwise
+ * unreachable; immediate keys cannot die and live in the buckets.
+ */
+
+enum {
+  TABLE_EQ,
+  TABLE_EQV,
+  TABLE_EQUAL,
+  TABLE_STRING,
+  TABLE_CUSTOM
+};
+
+#define TABLE_MIN_SIZE 8
+#define REHASH_STEP 4           /* buckets moved per operation */
+#define EQUAL_HASH_BUDGET 32    /* nodes visited by equal-hash */
+
+struct entry {
+  struct entry *next;
+  unsigned hash;
+  pic_value key, val;
+};
+
+struct buckets {
+  struct entry **b;
+  unsigned size;                /* 0 or a power of two */
+};
+
+struct table {
+  int kind;
+  bool immutable;
+  pic_value equiv, hash;        /* as given to make-hash-table */
+  pic_value weak;               /* object keys of a weak table, or #f */
+  struct buckets ht[2];         /* ht[1] is in use while growing */
+  unsigned rehash;              /* next bucket of ht[0] to move */
+  int count;                    /* entries in the buckets */
+  unsigned long gen;            /* bumped whenever an entry moves */
+};
+
+#define growing(t) ((t)->ht[1].b != NULL)
+
+static void
+table_dtor(pic_state *pic, void *data)
+{
+  struct table *t = data;
+  struct entry *e, *next;
+  unsigned i;
+  int j;
+
+  for (j = 0; j < 2; ++j) {
+    for (i = 0; i < t->ht[j].size; ++i) {
+      for (e = t->ht[j].b[i]; e != NULL; e = next) {
+        next = e->next;
+        pic_free(pic, e);
+      }
+    }
+    pic_free(pic, t->ht[j].b);
+  }
+  pic_free(pic, t);
+}
+
+static void
+table_mark(pic_state *pic, void *data, void (*mark)(pic_state *, pic_value))
+{
+  struct table *t = data;
+  struct entry *e;
+  unsigned i;
+  int j;
+
+  mark(pic, t->equiv);
+  mark(pic, t->hash);
+  mark(pic, t->weak);
+  for (j = 0; j < 2; ++j) {
+    for (i = 0; i < t->ht[j].size; ++i) {
+      for (e = t->ht[j].b[i]; e != NULL; e = e->next) {
+        mark(pic, e->key);
+        mark(pic, e->val);
+      }
+    }
+  }
+}
+
+static const pic_data_type table_type = { "hash-table", table_dtor, table_mark };
+
+#define pic_table_p(pic, o) pic_data_p(pic, o, &table_type)
+
+/* hash functions */
+
+static unsigned
+mix(unsigned h)
+{
+  h ^= h >> 16;
+  h *= 0x45d9f3bU;
+  h ^= h >> 16;
+  return h;
+}
+
+static unsigned
+hash_bytes(const unsigned char *buf, int len)
+{
+  unsigned h = 0;
+  int i;
+
+  for (i = 0; i < len; ++i) {
+    h = (h << 5) - h + buf[i];
+  }
+  return h;
+}
+
+static unsigned
+hash_float(double f)
+{
+  unsigned char buf[sizeof(double)];
+
+  if (f == 0) {
+    f = 0;                      /* pic_eqv_p compares unboxed flonums with == */
+  }
+  memcpy(buf, &f, sizeof(double));
+  return hash_bytes(buf, sizeof(double));
+}
+
+static unsigned
+hash_eqv(pic_state *pic, pic_value v)
+{
+  int tt = pic_type(pic, v);
+
+  switch (tt) {
+  case PIC_TYPE_INT:
+    return mix((unsigned)pic_int(pic, v));
+  case PIC_TYPE_FLOAT:
+    return mix(hash_float(pic_float(pic, v)));
+  case PIC_TYPE_CHAR:
+    return mix((unsigned char)pic_char(pic, v) + 0x100U);
+  default:
+    if (pic_obj_p(pic, v)) {
+      return mix((unsigned)((unsigned long)pic_obj_ptr(v) >> 3));
+    }
+    return mix((unsigned)tt);
+  }
+}
+
+static unsigned
+hash_equal(pic_state *pic, pic_value v, int *budget)
+{
+  unsigned h;
+  int i, len;
+
+  if ((*budget)-- <= 0) {
+    return pic_type(pic, v);
+  }
+
+  switch (pic_type(pic, v)) {
+  case PIC_TYPE_STRING:
+    return (unsigned)pic_str_hash(pic, v);
+  case PIC_TYPE_BLOB: {
+    unsigned char *buf = pic_blob(pic, v, &len);
+    return mix(hash_bytes(buf, len));
+  }
+  case PIC_TYPE_PAIR:
+    h = hash_equal(pic, pic_car(pic, v), budget);
+    return h * 31 + hash_equal(pic, pic_cdr(pic, v), budget);
+  case PIC_TYPE_VECTOR:
+    h = len = pic_vec_len(pic, v);
+    for (i = 0; i < len && *budget > 0; ++i) {
+      h = h * 31 + hash_equal(pic, pic_vec_ref(pic, v, i), budget);
+    }
+    return h;
+  case PIC_TYPE_ID:
+    return PIC_TYPE_ID;         /* equal? compares their bindings */
+  case PIC_TYPE_DATA:
+    return mix((unsigned)((unsigned long)pic_data(pic, v) >> 3));
+  default:
+    return hash_eqv(pic, v);
+  }
+}
+
+static unsigned
+hash_string_ci(pic_state *pic, pic_value str)
+{
+  unsigned h = 0;
+  int i, len;
+
+  len = pic_str_len(pic, str);
+  for (i = 0; i < len; ++i) {
+    h = (h << 5) - h + tolower((unsigned char)pic_str_ref(pic, str, i));
+  }
+  return h;
+}
+
+static unsigned
+table_hash(pic_state *pic, struct table *t, pic_value key)
+{
+  int budget = EQUAL_HASH_BUDGET;
+  pic_value h;
+
+  switch (t->kind) {
+  case TABLE_EQ:
+  case TABLE_EQV:
+    return hash_eqv(pic, key);
+  case TABLE_EQUAL:
+    return hash_equal(pic, key, &budget);
+  case TABLE_STRING:
+    if (! pic_str_p(pic, key)) {
+      pic_error(pic, "string key required", 1, key);
+    }
+    return (unsigned)pic_str_hash(pic, key);
+  default:
+    h = pic_call(pic, t->hash, 1, key);
+    if (! pic_int_p(pic, h)) {
+      pic_error(pic, "hash function returned a non-integer", 2, key, h);
+    }
+    return (unsigned)pic_int(pic, h);
+  }
+}
+
+/* buckets */
+
+static struct entry **
+bucket(struct buckets *ht, unsigned hash)
+{
+  return &ht->b[hash & (ht->size - 1)];
+}
+
+static void
+buckets_init(pic_state *pic, struct buckets *ht, unsigned size)
+{
+  unsigned i;
+
+  ht->b = pic_malloc(pic, sizeof(struct entry *) * size);
+  ht->size = size;
+  for (i = 0; i < size; ++i) {
+    ht->b[i] = NULL;
+  }
+}
+
+/* moves a few buckets of ht[0] to ht[1], and retires ht[0] when it is empty */
+static void
+table_step(pic_state *pic, struct table *t)
+{
+  struct entry *e, *next, **link;
+  int n = REHASH_STEP;
+
+  while (n-- > 0 && t->rehash < t->ht[0].size) {
+    for (e = t->ht[0].b[t->rehash]; e != NULL; e = next) {
+      next = e->next;
+      link = bucket(&t->ht[1], e->hash);
+      e->next = *link;
+      *link = e;
+    }
+    t->ht[0].b[t->rehash++] = NULL;
+  }
+  if (t->rehash == t->ht[0].size) {
+    pic_free(pic, t->ht[0].b);
+    t->ht[0] = t->ht[1];
+    t->ht[1].b = NULL;
+    t->ht[1].size = 0;
+  }
+  t->gen++;
+}
+
+static void
+table_grow(pic_state *pic, struct table *t)
+{
+  if (t->ht[0].size == 0) {
+    buckets_init(pic, &t->ht[0], TABLE_MIN_SIZE);
+  }
+  else if (! growing(t) && (unsigned)t->count > t->ht[0].size) {
+    buckets_init(pic, &t->ht[1], t->ht[0].size * 2);
+    t->rehash = 0;
+  }
+}
+
+static bool
+table_equiv(pic_state *pic, struct table *t, pic_value x, pic_value y)
+{
+  switch (t->kind) {
+  case TABLE_EQ:
+    return pic_eq_p(pic, x, y);
+  case TABLE_EQV:
+    return pic_eqv_p(pic, x, y);
+  case TABLE_EQUAL:
+    return pic_equal_p(pic, x, y);
+  case TABLE_STRING:
+    return pic_str_cmp(pic, x, y) == 0;
+  default:
+    return pic_bool(pic, pic_call(pic, t->equiv, 2, x, y));
+  }
+}
+
+/* returns the link pointing to the entry of key, or NULL */
+static struct entry **
+table_find(pic_state *pic, struct table *t, pic_value key, unsigned hash)
+{
+  struct entry **link;
+  unsigned long gen;
+  bool found;
+  int j;
+
+  if (growing(t)) {
+    table_step(pic, t);
+  }
+  for (j = 0; j < 2 && t->ht[j].size != 0; ++j) {
+    for (link = bucket(&t->ht[j], hash); *link != NULL; link = &(*link)->next) {
+      if ((*link)->hash != hash) {
+        continue;
+      }
+      gen = t->gen;
+      found = table_equiv(pic, t, (*link)->key, key);
+      if (t->gen != gen) {      /* link may point into freed buckets */
+        pic_error(pic, "hash table modified by its equivalence function", 0);
+      }
+      if (found) {
+        return link;
+      }
+    }
+  }
+  return NULL;
+}
+
+#define weak_key_p(pic, t, key) (pic_weak_p(pic, (t)->weak) && pic_obj_p(pic, key))
+
+static bool
+table_ref(pic_state *pic, struct table *t, pic_value key, pic_value *val)
+{
+  struct entry **link;
+
+  if (weak_key_p(pic, t, key)) {
+    if (! pic_weak_has(pic, t->weak, key)) {
+      return false;
+    }
+    *val = pic_weak_ref(pic, t->weak, key);
+    return true;
+  }
+  if ((link = table_find(pic, t, key, table_hash(pic, t, key))) == NULL) {
+    return false;
+  }
+  *val = (*link)->val;
+  return true;
+}
+
+static void
+table_set(pic_state *pic, struct table *t, pic_value key, pic_value val)
+{
+  struct entry **link, *e;
+  unsigned hash;
+
+  if (weak_key_p(pic, t, key)) {
+    pic_weak_set(pic, t->weak, key, val);
+    return;
+  }
+  hash = table_hash(pic, t, key);
+  if ((link = table_find(pic, t, key, hash)) != NULL) {
+    (*link)->val = val;
+    return;
+  }
+  table_grow(pic, t);
+
+  e = pic_malloc(pic, sizeof(struct entry));
+  e->hash = hash;
+  e->key = key;
+  e->val = val;
+  link = bucket(&t->ht[growing(t) ? 1 : 0], hash);
+  e->next = *link;
+  *link = e;
+  t->count++;
+  t->gen++;
+}
+
+static bool
+table_del(pic_state *pic, struct table *t, pic_value key)
+{
+  struct entry **link, *e;
+
+  if (weak_key_p(pic, t, key)) {
+    if (! pic_weak_has(pic, t->weak, key)) {
+      return false;
+    }
+    pic_weak_del(pic, t->weak, key);
+    return true;
+  }
+  if ((link = table_find(pic, t, key, table_hash(pic, t, key))) == NULL) {
+    return false;
+  }
+  e = *link;
+  *link = e->next;
+  pic_free(pic, e);
+  t->count--;
+  t->gen++;
+  return true;
+}
+
+static int
+table_size(pic_state *pic, struct table *t)
+{
+  return t->count + (pic_weak_p(pic, t->weak) ? pic_weak_size(pic, t->weak) : 0);
+}
+
+static pic_value
+make_table(pic_state *pic, int kind, pic_value equiv, pic_value hash, bool weak)
+{
+  struct table *t;
+
+  t = pic_malloc(pic, sizeof(struct table));
+  t->kind = kind;
+  t->immutable = false;
+  t->equiv = equiv;
+  t->hash = hash;
+  t->weak = pic_false_value(pic);
+  t->ht[0].b = t->ht[1].b = NULL;
+  t->ht[0].size = t->ht[1].size = 0;
+  t->rehash = 0;
+  t->count = 0;
+  t->gen = 0;
+
+  if (weak) {
+    t->weak = pic_make_weak(pic);
+  }
+  return pic_data_value(pic, t, &table_type);
+}
+
+static void
+check_mutable(pic_state *pic, struct table *t)
+{
+  if (t->immutable) {
+    pic_error(pic, "attempted to modify an immutable hash table", 0);
+  }
+}
+
+/* procedures */
+
+static pic_value
+pic_table_make_hash_table(pic_state *pic)
+{
+  pic_value kind, equiv, hash, weak;
+  int k;
+
+  pic_get_args(pic, "mooo", &kind, &equiv, &hash, &weak);
+
+  if (pic_eq_p(pic, kind, pic_intern_lit(pic, "eq"))) {
+    k = TABLE_EQ;
+  } else if (pic_eq_p(pic, kind, pic_intern_lit(pic, "eqv"))) {
+    k = TABLE_EQV;
+  } else if (pic_eq_p(pic, kind, pic_intern_lit(pic, "equal"))) {
+    k = TABLE_EQUAL;
+  } else if (pic_eq_p(pic, kind, pic_intern_lit(pic, "string"))) {
+    k = TABLE_STRING;
+  } else {
+    k = TABLE_CUSTOM;
+    if (! pic_proc_p(pic, equiv) || ! pic_proc_p(pic, hash)) {
+      pic_error(pic, "make-hash-table: equivalence and hash procedures required", 2, equiv, hash);
+    }
+  }
+  if (pic_bool(pic, weak) && k != TABLE_EQ && k != TABLE_EQV) {
+    pic_error(pic, "make-hash-table: weak keys need an eq? or eqv? table", 1, equiv);
+  }
+  return make_table(pic, k, equiv, hash, pic_bool(pic, weak));
+}
+
+static pic_value
+pic_table_hash_table_p(pic_state *pic)
+{
+  pic_value obj;
+
+  pic_get_args(pic, "o", &obj);
+
+  return pic_bool_value(pic, pic_table_p(pic, obj));
+}
+
+static pic_value
+pic_table_hash_table_ref_default(pic_state *pic)
+{
+  struct table *t;
+  pic_value key, def, val;
+
+  pic_get_args(pic, "uoo", &t, &table_type, &key, &def);
+
+  return table_ref(pic, t, key, &val) ? val : def;
+}
+
+static pic_value
+pic_table_hash_table_contains_p(pic_state *pic)
+{
+  struct table *t;
+  pic_value key, val;
+
+  pic_get_args(pic, "uo", &t, &table_type, &key);
+
+  return pic_bool_value(pic, table_ref(pic, t, key, &val));
+}
+
+static pic_value
+pic_table_hash_table_set(pic_state *pic)
+{
+  pic_value *argv;
+  struct table *t;
+  int argc, i;
+
+  pic_get_args(pic, "u*", &t, &table_type, &argc, &argv);
+
+  check_mutable(pic, t);
+
+  if (argc % 2 != 0) {
+    pic_error(pic, "hash-table-set!: odd number of keys and values", 0);
+  }
+  for (i = 0; i < argc; i += 2) {
+    table_set(pic, t, argv[i], argv[i + 1]);
+  }
+  return pic_undef_value(pic);
+}
+
+static pic_value
+pic_table_hash_table_delete(pic_state *pic)
+{
+  pic_value *argv;
+  struct table *t;
+  int argc, i, n = 0;
+
+  pic_get_args(pic, "u*", &t, &table_type, &argc, &argv);
+
+  check_mutable(pic, t);
+
+  for (i = 0; i < argc; ++i) {
+    n += table_del(pic, t, argv[i]);
+  }
+  return pic_int_value(pic, n);
+}
+
+static pic_value
+pic_table_hash_table_size(pic_state *pic)
+{
+  struct table *t;
+
+  pic_get_args(pic, "u", &t, &table_type);
+
+  return pic_int_value(pic, table_size(pic, t));
+}
+
+static pic_value
+pic_table_hash_table_clear(pic_state *pic)
+{
+  struct table *t;
+  struct entry *e, *next;
+  unsigned i;
+  int j;
+
+  pic_get_args(pic, "u", &t, &table_type);
+
+  check_mutable(pic, t);
+
+  for (j = 0; j < 2; ++j) {
+    for (i = 0; i < t->ht[j].size; ++i) {
+      for (e = t->ht[j].b[i]; e != NULL; e = next) {
+        next = e->next;
+        pic_free(pic, e);
+      }
+    }
+    pic_free(pic, t->ht[j].b);
+    t->ht[j].b = NULL;
+    t->ht[j].size = 0;
+  }
+  t->rehash = 0;
+  t->count = 0;
+  t->gen++;
+
+  if (pic_weak_p(pic, t->weak)) {
+    t->weak = pic_make_weak(pic);
+  }
+  return pic_undef_value(pic);
+}
+
+static pic_value
+pic_table_hash_table_copy(pic_state *pic)
+{
+  pic_value copy, mutable_p = pic_false_value(pic), key, val;
+  struct table *t, *c;
+  struct entry *e, *f, **link;
+  unsigned i;
+  int j, it = 0;
+
+  pic_get_args(pic, "u|o", &t, &table_type, &mutable_p);
+
+  copy = make_table(pic, t->kind, t->equiv, t->hash, pic_weak_p(pic, t->weak));
+  c = pic_data(pic, copy);
+  c->immutable = ! pic_bool(pic, mutable_p);
+
+  if (t->count > 0) {
+    buckets_init(pic, &c->ht[0], growing(t) ? t->ht[1].size : t->ht[0].size);
+    for (j = 0; j < 2; ++j) {
+      for (i = 0; i < t->ht[j].size; ++i) {
+        for (e = t->ht[j].b[i]; e != NULL; e = e->next) {
+          f = pic_malloc(pic, sizeof(struct entry));
+          *f = *e;
+          link = bucket(&c->ht[0], e->hash);
+          f->next = *link;
+          *link = f;
+          c->count++;
+        }
+      }
+    }
+  }
+  if (pic_weak_p(pic, t->weak)) {
+    while (pic_weak_next(pic, t->weak, &it, &key, &val)) {
+      pic_weak_set(pic, c->weak, key, val);
+    }
+  }
+  return copy;
+}
+
+static pic_value
+pic_table_hash_table_to_alist(pic_state *pic)
+{
+  pic_value key, val, alist = pic_nil_value(pic);
+  struct table *t;
+  struct entry *e;
+  unsigned i;
+  int j, it = 0;
+
+  pic_get_args(pic, "u", &t, &table_type);
+
+  for (j = 0; j < 2; ++j) {
+    for (i = 0; i < t->ht[j].size; ++i) {
+      for (e = t->ht[j].b[i]; e != NULL; e = e->next) {
+        pic_push(pic, pic_cons(pic, e->key, e->val), alist);
+      }
+    }
+  }
+  if (pic_weak_p(pic, t->weak)) {
+    while (pic_weak_next(pic, t->weak, &it, &key, &val)) {
+      pic_push(pic, pic_cons(pic, key, val), alist);
+    }
+  }
+  return alist;
+}
+
+static pic_value
+pic_table_hash_table_equivalence_function(pic_state *pic)
+{
+  struct table *t;
+
+  pic_get_args(pic, "u", &t, &table_type);
+
+  return t->equiv;
+}
+
+static pic_value
+pic_table_hash_table_hash_function(pic_state *pic)
+{
+  struct table *t;
+
+  pic_get_args(pic, "u", &t, &table_type);
+
+  return t->hash;
+}
+
+static pic_value
+pic_table_hash_table_mutable_p(pic_state *pic)
+{
+  struct table *t;
+
+  pic_get_args(pic, "u", &t, &table_type);
+
+  return pic_bool_value(pic, ! t->immutable);
+}
+
+static pic_value
+hash_value(pic_state *pic, unsigned h, int argc, int bound)
+{
+  if (argc > 1) {
+    if (bound <= 0) {
+      pic_error(pic, "hash bound must be positive", 1, pic_int_value(pic, bound));
+    }
+    return pic_int_value(pic, (int)(h % (unsigned)bound));
+  }
+  return pic_int_value(pic, (int)(h & INT_MAX));
+}
+
+static pic_value
+pic_table_hash(pic_state *pic)
+{
+  pic_value obj;
+  int argc, bound = 0, budget = EQUAL_HASH_BUDGET;
+
+  argc = pic_get_args(pic, "o|i", &obj, &bound);
+
+  return hash_value(pic, hash_equal(pic, obj, &budget), argc, bound);
+}
+
+static pic_value
+pic_table_hash_by_identity(pic_state *pic)
+{
+  pic_value obj;
+  int argc, bound = 0;
+
+  argc = pic_get_args(pic, "o|i", &obj, &bound);
+
+  return hash_value(pic, hash_eqv(pic, obj), argc, bound);
+}
+
+static pic_value
+pic_table_string_hash(pic_state *pic)
+{
+  pic_value str;
+  int argc, bound = 0;
+
+  argc = pic_get_args(pic, "s|i", &str, &bound);
+
+  return hash_value(pic, (unsigned)pic_str_hash(pic, str), argc, bound);
+}
+
+static pic_value
+pic_table_string_ci_hash(pic_state *pic)
+{
+  pic_value str;
+  int argc, bound = 0;
+
+  argc = pic_get_args(pic, "s|i", &str, &bound);
+
+  return hash_value(pic, hash_string_ci(pic, str), argc, bound);
+}
+
+void
+pic_init_srfi_125(pic_state *pic)
+{
+  pic_deflibrary(pic, "srfi.125");
+
+#define pic_defun_(pic, name, f) pic_define(pic, "srfi.125", name, pic_lambda(pic, f, 0))
+
+  /* wrapped by make-hash-table of the library */
+  pic_defun_(pic, "%make-hash-table", pic_table_make_hash_table);
+
+  pic_defun_(pic, "hash-table?", pic_table_hash_table_p);
+  pic_defun_(pic, "hash-table-ref/default", pic_table_hash_table_ref_default);
+  pic_defun_(pic, "hash-table-contains?", pic_table_hash_table_contains_p);
+  pic_defun_(pic, "hash-table-set!", pic_table_hash_table_set);
+  pic_defun_(pic, "hash-table-delete!", pic_table_hash_table_delete);
+  pic_defun_(pic, "hash-table-size", pic_table_hash_table_size);
+  pic_defun_(pic, "hash-table-clear!", pic_table_hash_table_clear);
+  pic_defun_(pic, "hash-table-copy", pic_table_hash_table_copy);
+  pic_defun_(pic, "hash-table->alist", pic_table_hash_table_to_alist);
+  pic_defun_(pic, "hash-table-equivalence-function", pic_table_hash_table_equivalence_function);
+  pic_defun_(pic, "hash-table-hash-function", pic_table_hash_table_hash_function);
+  pic_defun_(pic, "hash-table-mutable?", pic_table_hash_table_mutable_p);
+  pic_defun_(pic, "hash", pic_table_hash);
+  pic_defun_(pic, "hash-by-identity", pic_table_hash_by_identity);
+  pic_defun_(pic, "string-hash", pic_table_string_hash);
+  pic_defun_(pic, "string-ci-hash", pic_table_string_ci_hash);
+}
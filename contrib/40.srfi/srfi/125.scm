@@ -0,0 +1,240 @@
+(define-library (srfi 125)
+  (import (scheme base)
+          (scheme case-lambda))
+
+  ;; the table itself is defined natively, see src/125.c
+
+  (define (make-hash-table . args)
+    (let* ((equiv (if (and (pair? args) (procedure? (car args))) (car args) equal?))
+           (args (if (and (pair? args) (procedure? (car args))) (cdr args) args))
+           (hasher (and (pair? args) (procedure? (car args)) (car args)))
+           (args (if hasher (cdr args) args))
+           (weak (or (memq 'weak-keys args) (memq 'ephemeral-keys args)))
+           (kind (cond
+                  ((and hasher (not (memq hasher (list hash hash-by-identity string-hash)))) 'custom)
+                  ((eq? equiv eq?) 'eq)
+                  ((eq? equiv eqv?) 'eqv)
+                  ((eq? equiv equal?) 'equal)
+                  ((eq? equiv string=?) 'string)
+                  (else 'custom))))
+      (%make-hash-table kind
+                        equiv
+                        (or hasher
+                            (case kind
+                              ((eq eqv) hash-by-identity)
+                              ((string) string-hash)
+                              (else hash)))
+                        (if weak #t #f))))
+
+  (define (hash-table equiv . args)
+    (let ((table (make-hash-table equiv)))
+      (apply hash-table-set! table args)
+      table))
+
+  (define (alist->hash-table alist . args)
+    (let ((table (apply make-hash-table args)))
+      (for-each
+       (lambda (x)
+         (unless (hash-table-contains? table (car x))
+           (hash-table-set! table (car x) (cdr x))))
+       alist)
+      table))
+
+  (define (hash-table-unfold stop? mapper successor seed . args)
+    (let ((table (apply make-hash-table args)))
+      (let loop ((seed seed))
+        (if (stop? seed)
+            table
+            (let-values (((key val) (mapper seed)))
+              (hash-table-set! table key val)
+              (loop (successor seed)))))))
+
+  (define missing (list 'missing))
+
+  (define hash-table-ref
+    (case-lambda
+     ((table key)
+      (hash-table-ref table key (lambda () (error "hash-table-ref: key not found" key))))
+     ((table key failure)
+      (hash-table-ref table key failure (lambda (x) x)))
+     ((table key failure success)
+      (let ((val (hash-table-ref/default table key missing)))
+        (if (eq? val missing)
+            (failure)
+            (success val))))))
+
+  (define (hash-table-exists? table key)
+    (hash-table-contains? table key))
+
+  (define (hash-table-empty? table)
+    (zero? (hash-table-size table)))
+
+  (define (hash-table-intern! table key failure)
+    (let ((val (hash-table-ref/default table key missing)))
+      (if (eq? val missing)
+          (let ((val (failure)))
+            (hash-table-set! table key val)
+            val)
+          val)))
+
+  (define hash-table-update!
+    (case-lambda
+     ((table key updater)
+      (hash-table-set! table key (updater (hash-table-ref table key))))
+     ((table key updater failure)
+      (hash-table-set! table key (updater (hash-table-ref table key failure))))
+     ((table key updater failure success)
+      (hash-table-set! table key (updater (hash-table-ref table key failure success))))))
+
+  (define (hash-table-update!/default table key updater default)
+    (hash-table-set! table key (updater (hash-table-ref/default table key default))))
+
+  (define (hash-table-pop! table)
+    (let ((alist (hash-table->alist table)))
+      (if (null? alist)
+          (error "hash-table-pop!: hash table is empty" table)
+          (let ((key (caar alist)) (val (cdar alist)))
+            (hash-table-delete! table key)
+            (values key val)))))
+
+  ;; iteration works on a snapshot, so procedures may modify the table
+
+  (define (hash-table-keys table)
+    (map car (hash-table->alist table)))
+
+  (define (hash-table-values table)
+    (map cdr (hash-table->alist table)))
+
+  (define (hash-table-entries table)
+    (let ((alist (hash-table->alist table)))
+      (values (map car alist) (map cdr alist))))
+
+  (define (hash-table-for-each proc table)
+    (if (hash-table? proc)                ; SRFI 69 argument order
+        (hash-table-for-each table proc)
+        (for-each (lambda (x) (proc (car x) (cdr x))) (hash-table->alist table))))
+
+  (define (hash-table-walk table proc)
+    (hash-table-for-each proc table))
+
+  (define (hash-table-map->list proc table)
+    (map (lambda (x) (proc (car x) (cdr x))) (hash-table->alist table)))
+
+  (define (hash-table-fold proc seed table)
+    (if (hash-table? proc)                ; SRFI 69 argument order
+        (hash-table-fold seed table proc)
+        (let loop ((alist (hash-table->alist table)) (acc seed))
+          (if (null? alist)
+              acc
+              (loop (cdr alist) (proc (caar alist) (cdar alist) acc))))))
+
+  (define (hash-table-map proc equiv table)
+    (let ((new (make-hash-table equiv)))
+      (hash-table-for-each (lambda (key val) (hash-table-set! new key (proc val))) table)
+      new))
+
+  (define (hash-table-map! proc table)
+    (hash-table-for-each (lambda (key val) (hash-table-set! table key (proc key val))) table))
+
+  (define (hash-table-prune! proc table)
+    (hash-table-for-each (lambda (key val) (when (proc key val) (hash-table-delete! table key))) table))
+
+  (define (hash-table-find proc table failure)
+    (let loop ((alist (hash-table->alist table)))
+      (if (null? alist)
+          (failure)
+          (or (proc (caar alist) (cdar alist))
+              (loop (cdr alist))))))
+
+  (define (hash-table-count pred table)
+    (hash-table-fold (lambda (key val n) (if (pred key val) (+ n 1) n)) 0 table))
+
+  (define (hash-table-empty-copy table)
+    (let ((copy (hash-table-copy table #t)))
+      (hash-table-clear! copy)
+      copy))
+
+  (define (hash-table=? value=? table1 table2)
+    (and (= (hash-table-size table1) (hash-table-size table2))
+         (hash-table-fold
+          (lambda (key val acc)
+            (and acc
+                 (let ((other (hash-table-ref/default table2 key missing)))
+                   (and (not (eq? other missing)) (value=? val other)))))
+          #t
+          table1)))
+
+  (define (hash-table-union! table1 table2)
+    (hash-table-for-each
+     (lambda (key val)
+       (unless (hash-table-contains? table1 key)
+         (hash-table-set! table1 key val)))
+     table2)
+    table1)
+
+  (define (hash-table-merge! table1 table2)
+    (hash-table-union! table1 table2))
+
+  (define (hash-table-intersection! table1 table2)
+    (hash-table-prune! (lambda (key val) (not (hash-table-contains? table2 key))) table1)
+    table1)
+
+  (define (hash-table-difference! table1 table2)
+    (hash-table-prune! (lambda (key val) (hash-table-contains? table2 key)) table1)
+    table1)
+
+  (define (hash-table-xor! table1 table2)
+    (hash-table-for-each
+     (lambda (key val)
+       (if (hash-table-contains? table1 key)
+           (hash-table-delete! table1 key)
+           (hash-table-set! table1 key val)))
+     table2)
+    table1)
+
+  (export make-hash-table
+          hash-table
+          hash-table-unfold
+          alist->hash-table
+          hash-table?
+          hash-table-contains?
+          hash-table-exists?
+          hash-table-empty?
+          hash-table=?
+          hash-table-mutable?
+          hash-table-ref
+          hash-table-ref/default
+          hash-table-set!
+          hash-table-delete!
+          hash-table-intern!
+          hash-table-update!
+          hash-table-update!/default
+          hash-table-pop!
+          hash-table-clear!
+          hash-table-size
+          hash-table-keys
+          hash-table-values
+          hash-table-entries
+          hash-table-find
+          hash-table-count
+          hash-table-map
+          hash-table-for-each
+          hash-table-walk
+          hash-table-map!
+          hash-table-map->list
+          hash-table-fold
+          hash-table-prune!
+          hash-table-copy
+          hash-table-empty-copy
+          hash-table->alist
+          hash-table-union!
+          hash-table-merge!
+          hash-table-intersection!
+          hash-table-difference!
+          hash-table-xor!
+          hash
+          string-hash
+          string-ci-hash
+          hash-by-identity
+          hash-table-equivalence-function
+          hash-table-hash-function))
@@ -0,0 +1,33 @@
+(define-library (srfi 69)
+  (import (scheme base)
+          (except (srfi 125) hash-table-copy)
+          (prefix (only (srfi 125) hash-table-copy) srfi-125:))
+
+  ;; SRFI 69 copies are mutable unless told otherwise
+  (define (hash-table-copy table . mutable?)
+    (srfi-125:hash-table-copy table (if (null? mutable?) #t (car mutable?))))
+
+  (export make-hash-table
+          hash-table?
+          alist->hash-table
+          hash-table-equivalence-function
+          hash-table-hash-function
+          hash-table-ref
+          hash-table-ref/default
+          hash-table-set!
+          hash-table-delete!
+          hash-table-exists?
+          hash-table-update!
+          hash-table-update!/default
+          hash-table-size
+          hash-table-keys
+          hash-table-values
+          hash-table-walk
+          hash-table-fold
+          hash-table->alist
+          hash-table-copy
+          hash-table-merge!
+          hash
+          string-hash
+          string-ci-hash
+          hash-by-identity))
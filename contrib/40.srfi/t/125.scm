@@ -0,0 +1,134 @@
+(import (scheme base)
+        (srfi 125)
+        (picrin test)
+        (picrin gc))
+
+(test-begin)
+
+(define (sorted-keys table)
+  (list-sort < (hash-table-keys table)))
+
+(define (list-sort < l)
+  (if (null? l)
+      l
+      (let ((x (car l)))
+        (append (list-sort < (filter (lambda (y) (< y x)) (cdr l)))
+                (list x)
+                (list-sort < (filter (lambda (y) (not (< y x))) (cdr l)))))))
+
+(define (filter p l)
+  (cond ((null? l) '())
+        ((p (car l)) (cons (car l) (filter p (cdr l))))
+        (else (filter p (cdr l)))))
+
+;; eqv? tables with growing and deletion
+(define t (make-hash-table eqv?))
+(let loop ((i 0))
+  (when (< i 1000)
+    (hash-table-set! t i (* i i))
+    (loop (+ i 1))))
+(test 1000 (hash-table-size t))
+(test 998001 (hash-table-ref t 999))
+(test 'none (hash-table-ref/default t 1000 'none))
+(let loop ((i 0))
+  (when (< i 1000)
+    (hash-table-delete! t i)
+    (loop (+ i 2))))
+(test 500 (hash-table-size t))
+(test #f (hash-table-contains? t 10))
+(test #t (hash-table-contains? t 11))
+(test 'gone (hash-table-ref t 10 (lambda () 'gone)))
+(test 122 (hash-table-ref t 11 (lambda () 'gone) (lambda (x) (+ x 1))))
+
+;; flonums and chars
+(define n (make-hash-table eqv?))
+(hash-table-set! n 1.5 'a 0.0 'b #\x 'c 1 'd)
+(test 'a (hash-table-ref/default n 1.5 #f))
+(test 'b (hash-table-ref/default n 0.0 #f))
+(test 'c (hash-table-ref/default n #\x #f))
+(test 'd (hash-table-ref/default n 1 #f))
+(test #f (hash-table-ref/default n 1.0 #f))
+
+;; equal? and string tables, including ropes
+(define e (make-hash-table equal?))
+(hash-table-set! e '(1 2 3) 'list (vector 1 "two") 'vector "abc" 'string)
+(test 'list (hash-table-ref/default e (list 1 2 3) #f))
+(test 'vector (hash-table-ref/default e (vector 1 (string #\t #\w #\o)) #f))
+(test 'string (hash-table-ref/default e (string-append "a" "bc") #f))
+
+(define s (make-hash-table string=?))
+(define long (make-string 100 #\z))
+(hash-table-set! s (string-append long long) 'long)
+(test 'long (hash-table-ref/default s (make-string 200 #\z) #f))
+(test #f (hash-table-ref/default s (make-string 199 #\z) #f))
+
+;; a user supplied hash and equivalence
+(define (mod10 x) (modulo x 10))
+(define m10 (make-hash-table (lambda (a b) (= (mod10 a) (mod10 b))) mod10))
+(hash-table-set! m10 13 'a 24 'b 33 'c)
+(test 'c (hash-table-ref/default m10 3 #f))
+(test 2 (hash-table-size m10))
+(test (string-ci-hash "Hello") (string-ci-hash "hELLO"))
+
+;; an equivalence that grows the table is an error, whatever it returns
+(define armed #f)
+(define g #f)
+(define next 100)
+(define (growing-eq a b)
+  (when armed
+    (set! armed #f)
+    (let loop ((i 0))
+      (when (< i 200)
+        (hash-table-set! g next next)
+        (set! next (+ next 1))
+        (loop (+ i 1)))))
+  (= a b))
+(set! g (make-hash-table growing-eq (lambda (x . _) (modulo x 7))))
+(hash-table-set! g 1 'one)
+(set! armed #t)
+(test #t (guard (e (#t (error-object? e))) (hash-table-set! g 1 'uno) #f))
+(set! armed #t)
+(test #t (guard (e (#t (error-object? e))) (hash-table-delete! g 1) #f))
+
+;; update, intern, fold
+(define c (make-hash-table eq?))
+(for-each (lambda (w) (hash-table-update!/default c w (lambda (n) (+ n 1)) 0))
+          '(a b a c a b))
+(test 3 (hash-table-ref c 'a))
+(test 6 (hash-table-fold (lambda (k v acc) (+ v acc)) 0 c))
+(test 6 (hash-table-fold c (lambda (k v acc) (+ v acc)) 0))
+(test 7 (hash-table-intern! c 'd (lambda () 7)))
+(test 7 (hash-table-intern! c 'd (lambda () 8)))
+(test 2 (hash-table-count (lambda (k v) (> v 2)) c))
+
+;; copies
+(define i (hash-table-copy c))
+(test #f (hash-table-mutable? i))
+(test #t (guard (x (#t #t)) (hash-table-set! i 'a 0) #f))
+(define m (hash-table-copy c #t))
+(hash-table-set! m 'a 0)
+(test 3 (hash-table-ref c 'a))
+(test 0 (hash-table-ref m 'a))
+(hash-table-clear! m)
+(test 0 (hash-table-size m))
+(test 4 (hash-table-size c))
+
+;; iteration may modify the table
+(define p (alist->hash-table '((1 . a) (2 . b) (3 . c) (4 . d)) eqv?))
+(hash-table-prune! (lambda (k v) (even? k)) p)
+(test '(1 3) (sorted-keys p))
+
+;; weak keys
+(define w (make-hash-table eq? 'weak-keys))
+(define k1 (list 'k1))
+(hash-table-set! w k1 'one (list 'k2) 'two 3 'three)
+(gc)
+(test 2 (hash-table-size w))
+(test 'one (hash-table-ref/default w k1 #f))
+(test 'three (hash-table-ref/default w 3 #f))
+
+(test #t (= (hash "abc") (hash (string-append "a" "bc"))))
+(test #t (= (string-hash "abc") (string-hash (string-append "ab" "c"))))
+(test #t (< (hash '(1 2 3) 10) 10))
+
+(test-end)
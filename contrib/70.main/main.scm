@@ -5,7 +5,10 @@
           (scheme process-context)
           (scheme load)
           (scheme eval)
+          (scheme file)
           (picrin base)
+          (picrin profile)
+          (picrin optimize)
           (picrin repl))
 
   (define (print-help)
@@ -16,10 +19,12 @@
     (display "Options:\n")
     (display "  -e [program]		run one liner script\n")
     (display "  -l [file]		load the file then enter repl\n")
+    (display "  -p [file]		run the file under the profiler, writing picrin.prof\n")
+    (display "  -O [passes]		enable only the listed optimizer passes, e.g. '(beta lift)'\n")
     (display "  -h or --help		show this help\n"))
 
   (define (getopt)
-    (let ((args (cdr (command-line))))
+    (let loop ((args (cdr (command-line))))
       (if (null? args)
           (values 'repl #f)
           (case (string->symbol (car args))
@@ -30,12 +35,25 @@
              (values 'line (cadr args)))
             ((-l)
              (values 'load (cadr args)))
+            ((-p)
+             (values 'profile (cadr args)))
+            ((-O)
+             (optimize-passes (read (open-input-string (cadr args))))
+             (loop (cddr args)))
             (else
              (values 'file (car args)))))))
 
   (define (exec-file filename)
     (load filename))
 
+  (define (exec-profile filename)
+    (dynamic-wind
+        profile-start
+        (lambda () (load filename))
+        (lambda ()
+          (profile-stop)
+          (call-with-output-file "picrin.prof" profile-write))))
+
   (define (exec-line str)
     (call-with-port (open-input-string str)
       (lambda (in)
@@ -51,6 +69,7 @@
           ((repl) (repl))
           ((load) (load dat) (repl))
           ((line) (exec-line dat))
-          ((file) (exec-file dat))))))
+          ((file) (exec-file dat))
+          ((profile) (exec-profile dat))))))
 
   (export main))
@@ -0,0 +1,99 @@
+/**
+ * See Copyright Notice in picrin.h
+ */
+
+/*
+ * Loads the piclib sources once with image recording on and writes the
+ * resulting bytecode images out as C arrays, to be included by
+ * load_piclib.c when it is compiled with PICLIB_IMAGE.
+ */
+
+#include <stdio.h>
+
+#include "picrin.h"
+#include "picrin/extra.h"
+
+int picrin_argc;
+char **picrin_argv;
+char **picrin_envp;
+
+extern char *picrin_native_stack_start; /* for call/cc */
+
+static void
+print_images(pic_state *pic, pic_value images)
+{
+  pic_value image, it;
+  unsigned char *buf;
+  int i, j, len;
+
+  puts("/**\n"
+       " *                                !!NOTICE!!\n"
+       " * This file was automatically generated by mkimage, and includes the\n"
+       " * bytecode images of the prelude files. PLEASE DO NOT EDIT THIS FILE,\n"
+       " * changes will be overwritten the next time the tool runs.\n"
+       " */\n");
+
+  i = 0;
+  pic_for_each (image, images, it) {
+    if (pic_blob_p(pic, image)) {
+      buf = pic_blob(pic, image, &len);
+      printf("static const unsigned char piclib_image_%d[] = {", i);
+      for (j = 0; j < len; ++j) {
+        printf(j % 16 == 0 ? "\n  %d," : " %d,", buf[j]);
+      }
+      puts("\n};\n");
+    }
+    i++;
+  }
+
+  puts("static const unsigned char *const piclib_images[] = {");
+  i = 0;
+  pic_for_each (image, images, it) {
+    if (pic_blob_p(pic, image)) {
+      printf("  piclib_image_%d,\n", i);
+    } else {
+      puts("  NULL,");
+    }
+    i++;
+  }
+  puts("};\n\n#define piclib_image(i) piclib_images[i]");
+}
+
+int
+main(int argc, char *argv[], char **envp)
+{
+  void pic_init_contrib(pic_state *);
+  void pic_load_piclib(pic_state *);
+  char t;
+  pic_state *pic;
+  pic_value e;
+  int status;
+
+  pic = pic_open(pic_default_allocf, NULL);
+
+  picrin_argc = argc;
+  picrin_argv = argv;
+  picrin_envp = envp;
+
+  picrin_native_stack_start = &t;
+
+  pic_try {
+    pic_dump_begin(pic);
+
+    pic_init_contrib(pic);
+    pic_load_piclib(pic);
+
+    print_images(pic, pic_dump_end(pic));
+    fflush(stdout);
+
+    status = 0;
+  }
+  pic_catch(e) {
+    pic_print_error(pic, pic_stderr(pic), e);
+    status = 1;
+  }
+
+  pic_close(pic);
+
+  return status;
+}
@@ -14,6 +14,12 @@ print <<EOL;
 #include "picrin.h"
 #include "picrin/extra.h"
 
+#if PICLIB_IMAGE
+# include "piclib_image.c"
+#else
+# define piclib_image(i) NULL
+#endif
+
 EOL
 
 foreach my $file (@ARGV) {
@@ -43,6 +49,7 @@ pic_load_piclib(pic_state *pic)
 
 EOL
 
+my $i = 0;
 foreach my $file (@ARGV) {
     print <<EOL;
   pic_try {
@@ -50,7 +57,8 @@ EOL
     my $var = &escape_v($file);
     my $basename = basename($file);
     my $dirname = basename(dirname($file));
-    print "    pic_load_cstr(pic, &${var}[0][0]);\n";
+    print "    pic_load_image(pic, piclib_image($i), &${var}[0][0]);\n";
+    $i++;
     print<<EOL
   }
   pic_catch(e) {
@@ -30,24 +30,18 @@ pic_blob(pic_state *PIC_UNUSED(pic), pic_value blob, int *len)
 }
 
 static pic_value
-pic_blob_bytevector_p(pic_state *pic)
+pic_blob_bytevector_p(pic_state *pic, int PIC_UNUSED(argc), pic_value *argv)
 {
-  pic_value v;
-
-  pic_get_args(pic, "o", &v);
-
-  return pic_bool_value(pic, pic_blob_p(pic, v));
+  return pic_bool_value(pic, pic_blob_p(pic, argv[0]));
 }
 
 static pic_value
-pic_blob_bytevector(pic_state *pic)
+pic_blob_bytevector(pic_state *pic, int argc, pic_value *argv)
 {
-  pic_value *argv, blob;
-  int argc, i;
+  pic_value blob;
+  int i;
   unsigned char *data;
 
-  pic_get_args(pic, "*", &argc, &argv);
-
   blob = pic_blob_value(pic, 0, argc);
 
   data = pic_blob(pic, blob, NULL);
@@ -66,12 +60,13 @@ pic_blob_bytevector(pic_state *pic)
 }
 
 static pic_value
-pic_blob_make_bytevector(pic_state *pic)
+pic_blob_make_bytevector(pic_state *pic, int argc, pic_value *argv)
 {
   pic_value blob;
-  int k, b = 0;
+  int k, b;
 
-  pic_get_args(pic, "i|i", &k, &b);
+  k = pic_int(pic, argv[0]);
+  b = argc > 1 ? pic_int(pic, argv[1]) : 0;
 
   if (b < 0 || b > 255)
     pic_error(pic, "byte out of range", 0);
@@ -88,22 +83,23 @@ pic_blob_make_bytevector(pic_state *pic)
 }
 
 static pic_value
-pic_blob_bytevector_length(pic_state *pic)
+pic_blob_bytevector_length(pic_state *pic, int PIC_UNUSED(argc), pic_value *argv)
 {
   int len;
 
-  pic_get_args(pic, "b", NULL, &len);
+  pic_blob(pic, argv[0], &len);
 
   return pic_int_value(pic, len);
 }
 
 static pic_value
-pic_blob_bytevector_u8_ref(pic_state *pic)
+pic_blob_bytevector_u8_ref(pic_state *pic, int PIC_UNUSED(argc), pic_value *argv)
 {
   unsigned char *buf;
   int len, k;
 
-  pic_get_args(pic, "bi", &buf, &len, &k);
+  buf = pic_blob(pic, argv[0], &len);
+  k = pic_int(pic, argv[1]);
 
   VALID_INDEX(pic, len, k);
 
@@ -111,12 +107,14 @@ pic_blob_bytevector_u8_ref(pic_state *pic)
 }
 
 static pic_value
-pic_blob_bytevector_u8_set(pic_state *pic)
+pic_blob_bytevector_u8_set(pic_state *pic, int PIC_UNUSED(argc), pic_value *argv)
 {
   unsigned char *buf;
   int len, k, v;
 
-  pic_get_args(pic, "bii", &buf, &len, &k, &v);
+  buf = pic_blob(pic, argv[0], &len);
+  k = pic_int(pic, argv[1]);
+  v = pic_int(pic, argv[2]);
 
   if (v < 0 || v > 255)
     pic_error(pic, "byte out of range", 0);
@@ -129,19 +127,16 @@ pic_blob_bytevector_u8_set(pic_state *pic)
 }
 
 static pic_value
-pic_blob_bytevector_copy_i(pic_state *pic)
+pic_blob_bytevector_copy_i(pic_state *pic, int argc, pic_value *argv)
 {
   unsigned char *to, *from;
-  int n, at, start, end, tolen, fromlen;
+  int at, start, end, tolen, fromlen;
 
-  n = pic_get_args(pic, "bib|ii", &to, &tolen, &at, &from, &fromlen, &start, &end);
-
-  switch (n) {
-  case 3:
-    start = 0;
-  case 4:
-    end = fromlen;
-  }
+  to = pic_blob(pic, argv[0], &tolen);
+  at = pic_int(pic, argv[1]);
+  from = pic_blob(pic, argv[2], &fromlen);
+  start = argc > 3 ? pic_int(pic, argv[3]) : 0;
+  end = argc > 4 ? pic_int(pic, argv[4]) : fromlen;
 
   VALID_ATRANGE(pic, tolen, at, fromlen, start, end);
 
@@ -151,19 +146,14 @@ pic_blob_bytevector_copy_i(pic_state *pic)
 }
 
 static pic_value
-pic_blob_bytevector_copy(pic_state *pic)
+pic_blob_bytevector_copy(pic_state *pic, int argc, pic_value *argv)
 {
   unsigned char *buf;
-  int n, start, end, len;
+  int start, end, len;
 
-  n = pic_get_args(pic, "b|ii", &buf, &len, &start, &end);
-
-  switch (n) {
-  case 1:
-    start = 0;
-  case 2:
-    end = len;
-  }
+  buf = pic_blob(pic, argv[0], &len);
+  start = argc > 1 ? pic_int(pic, argv[1]) : 0;
+  end = argc > 2 ? pic_int(pic, argv[2]) : len;
 
   VALID_RANGE(pic, len, start, end);
 
@@ -171,17 +161,14 @@ pic_blob_bytevector_copy(pic_state *pic)
 }
 
 static pic_value
-pic_blob_bytevector_append(pic_state *pic)
+pic_blob_bytevector_append(pic_state *pic, int argc, pic_value *argv)
 {
-  int argc, i, l, len;
+  int i, l, len;
   unsigned char *buf, *dst;
-  pic_value *argv, blob;
-
-  pic_get_args(pic, "*", &argc, &argv);
+  pic_value blob;
 
   len = 0;
   for (i = 0; i < argc; ++i) {
-    TYPE_CHECK(pic, argv[i], blob);
     pic_blob(pic, argv[i], &l);
     len += l;
   }
@@ -200,19 +187,17 @@ pic_blob_bytevector_append(pic_state *pic)
 }
 
 static pic_value
-pic_blob_list_to_bytevector(pic_state *pic)
+pic_blob_list_to_bytevector(pic_state *pic, int PIC_UNUSED(argc), pic_value *argv)
 {
   pic_value blob;
   unsigned char *data;
-  pic_value list, e, it;
+  pic_value e, it;
 
-  pic_get_args(pic, "o", &list);
-
-  blob = pic_blob_value(pic, 0, pic_length(pic, list));
+  blob = pic_blob_value(pic, 0, pic_length(pic, argv[0]));
 
   data = pic_blob(pic, blob, NULL);
 
-  pic_for_each (e, list, it) {
+  pic_for_each (e, argv[0], it) {
     TYPE_CHECK(pic, e, int);
 
     if (pic_int(pic, e) < 0 || pic_int(pic, e) > 255)
@@ -224,20 +209,15 @@ pic_blob_list_to_bytevector(pic_state *pic)
 }
 
 static pic_value
-pic_blob_bytevector_to_list(pic_state *pic)
+pic_blob_bytevector_to_list(pic_state *pic, int argc, pic_value *argv)
 {
   pic_value list;
   unsigned char *buf;
-  int n, len, start, end, i;
-
-  n = pic_get_args(pic, "b|ii", &buf, &len, &start, &end);
+  int len, start, end, i;
 
-  switch (n) {
-  case 1:
-    start = 0;
-  case 2:
-    end = len;
-  }
+  buf = pic_blob(pic, argv[0], &len);
+  start = argc > 1 ? pic_int(pic, argv[1]) : 0;
+  end = argc > 2 ? pic_int(pic, argv[2]) : len;
 
   VALID_RANGE(pic, len, start, end);
 
@@ -251,15 +231,15 @@ pic_blob_bytevector_to_list(pic_state *pic)
 void
 pic_init_blob(pic_state *pic)
 {
-  pic_defun(pic, "bytevector?", pic_blob_bytevector_p);
-  pic_defun(pic, "bytevector", pic_blob_bytevector);
-  pic_defun(pic, "make-bytevector", pic_blob_make_bytevector);
-  pic_defun(pic, "bytevector-length", pic_blob_bytevector_length);
-  pic_defun(pic, "bytevector-u8-ref", pic_blob_bytevector_u8_ref);
-  pic_defun(pic, "bytevector-u8-set!", pic_blob_bytevector_u8_set);
-  pic_defun(pic, "bytevector-copy!", pic_blob_bytevector_copy_i);
-  pic_defun(pic, "bytevector-copy", pic_blob_bytevector_copy);
-  pic_defun(pic, "bytevector-append", pic_blob_bytevector_append);
-  pic_defun(pic, "bytevector->list", pic_blob_bytevector_to_list);
-  pic_defun(pic, "list->bytevector", pic_blob_list_to_bytevector);
+  pic_defun_sig(pic, "bytevector?", "o", pic_blob_bytevector_p);
+  pic_defun_sig(pic, "bytevector", "*", pic_blob_bytevector);
+  pic_defun_sig(pic, "make-bytevector", "i|i", pic_blob_make_bytevector);
+  pic_defun_sig(pic, "bytevector-length", "b", pic_blob_bytevector_length);
+  pic_defun_sig(pic, "bytevector-u8-ref", "bi", pic_blob_bytevector_u8_ref);
+  pic_defun_sig(pic, "bytevector-u8-set!", "bii", pic_blob_bytevector_u8_set);
+  pic_defun_sig(pic, "bytevector-copy!", "bib|ii", pic_blob_bytevector_copy_i);
+  pic_defun_sig(pic, "bytevector-copy", "b|ii", pic_blob_bytevector_copy);
+  pic_defun_sig(pic, "bytevector-append", "*b", pic_blob_bytevector_append);
+  pic_defun_sig(pic, "bytevector->list", "b|ii", pic_blob_bytevector_to_list);
+  pic_defun_sig(pic, "list->bytevector", "o", pic_blob_list_to_bytevector);
 }
@@ -7,32 +7,25 @@
 #include "picrin/private/object.h"
 
 static pic_value
-pic_char_char_p(pic_state *pic)
+pic_char_char_p(pic_state *pic, int PIC_UNUSED(argc), pic_value *argv)
 {
-  pic_value v;
-
-  pic_get_args(pic, "o", &v);
-
-  return pic_char_p(pic, v) ? pic_true_value(pic) : pic_false_value(pic);
+  return pic_char_p(pic, argv[0]) ? pic_true_value(pic) : pic_false_value(pic);
 }
 
 static pic_value
-pic_char_char_to_integer(pic_state *pic)
+pic_char_char_to_integer(pic_state *pic, int PIC_UNUSED(argc), pic_value *argv)
 {
-  char c;
+  char c = pic_char(pic, argv[0]);
 
-  pic_get_args(pic, "c", &c);
   assert((c & 0x80) == 0);
 
   return pic_int_value(pic, c);
 }
 
 static pic_value
-pic_char_integer_to_char(pic_state *pic)
+pic_char_integer_to_char(pic_state *pic, int PIC_UNUSED(argc), pic_value *argv)
 {
-  int i;
-
-  pic_get_args(pic, "i", &i);
+  int i = pic_int(pic, argv[0]);
 
   if (i < 0 || i > 127) {
     pic_error(pic, "integer->char: integer out of char range", 1, pic_int_value(pic, i));
@@ -43,23 +36,12 @@ pic_char_integer_to_char(pic_state *pic)
 
 #define DEFINE_CHAR_CMP(op, name)			\
   static pic_value					\
-  pic_char_##name##_p(pic_state *pic)			\
+  pic_char_##name##_p(pic_state *pic, int argc, pic_value *argv) \
   {							\
-    int argc, i;                                        \
-    pic_value *argv;					\
-    char c, d;						\
-    							\
-    pic_get_args(pic, "cc*", &c, &d, &argc, &argv);	\
+    int i;                                              \
     							\
-    if (! (c op d))					\
-      return pic_false_value(pic);                      \
-                                                        \
-    for (i = 0; i < argc; ++i) {                        \
-      c = d;                                            \
-      TYPE_CHECK(pic, argv[i], char);                   \
-      d = pic_char(pic, argv[i]);                       \
-                                                        \
-      if (! (c op d))					\
+    for (i = 1; i < argc; ++i) {                        \
+      if (! (pic_char(pic, argv[i - 1]) op pic_char(pic, argv[i]))) \
 	return pic_false_value(pic);			\
     }							\
     							\
@@ -75,12 +57,12 @@ DEFINE_CHAR_CMP(>=, ge)
 void
 pic_init_char(pic_state *pic)
 {
-  pic_defun(pic, "char?", pic_char_char_p);
-  pic_defun(pic, "char->integer", pic_char_char_to_integer);
-  pic_defun(pic, "integer->char", pic_char_integer_to_char);
-  pic_defun(pic, "char=?", pic_char_eq_p);
-  pic_defun(pic, "char<?", pic_char_lt_p);
-  pic_defun(pic, "char>?", pic_char_gt_p);
-  pic_defun(pic, "char<=?", pic_char_le_p);
-  pic_defun(pic, "char>=?", pic_char_ge_p);
+  pic_defun_sig(pic, "char?", "o", pic_char_char_p);
+  pic_defun_sig(pic, "char->integer", "c", pic_char_char_to_integer);
+  pic_defun_sig(pic, "integer->char", "i", pic_char_integer_to_char);
+  pic_defun_sig(pic, "char=?", "cc*c", pic_char_eq_p);
+  pic_defun_sig(pic, "char<?", "cc*c", pic_char_lt_p);
+  pic_defun_sig(pic, "char>?", "cc*c", pic_char_gt_p);
+  pic_defun_sig(pic, "char<=?", "cc*c", pic_char_le_p);
+  pic_defun_sig(pic, "char>=?", "cc*c", pic_char_ge_p);
 }
@@ -6,21 +6,6 @@
 #include "picrin/private/object.h"
 #include "picrin/private/state.h"
 
-struct cont {
-  PIC_JMPBUF *jmp;
-
-  struct checkpoint *cp;
-  ptrdiff_t sp_offset;
-  ptrdiff_t ci_offset;
-  size_t arena_idx;
-  const struct code *ip;
-
-  int retc;
-  pic_value *retv;
-
-  struct cont *prev;
-};
-
 static const pic_data_type cont_type = { "cont", NULL, NULL };
 
 void
@@ -33,7 +18,9 @@ pic_save_point(pic_state *pic, struct cont *cont, PIC_JMPBUF *jmp)
   cont->sp_offset = pic->sp - pic->stbase;
   cont->ci_offset = pic->ci - pic->cibase;
   cont->arena_idx = pic->arena_idx;
-  cont->ip = pic->ip;
+  cont->handlers = pic->handlers;
+  cont->trap = pic_false_value(pic);
+  cont->prompts = pic->prompts;
   cont->prev = pic->cc;
   cont->retc = 0;
   cont->retv = NULL;
@@ -46,12 +33,17 @@ pic_load_point(pic_state *pic, struct cont *cont)
 {
   pic_wind(pic, pic->cp, cont->cp);
 
+  /* discarded frames must not leave contexts pointing into the stack */
+  pic_vm_tear_off(pic, pic->cibase + cont->ci_offset);
+
   /* load runtime context */
   pic->cp = cont->cp;
   pic->sp = pic->stbase + cont->sp_offset;
   pic->ci = pic->cibase + cont->ci_offset;
+  pic_vm_recover(pic);
   pic->arena_idx = cont->arena_idx;
-  pic->ip = cont->ip;
+  pic->handlers = cont->handlers;
+  pic->prompts = cont->prompts;
   pic->cc = cont->prev;
 }
 
@@ -166,6 +158,288 @@ pic_callcc(pic_state *pic, pic_value proc)
   }
 }
 
+/*
+ * Delimited continuations.
+ *
+ * Every reset pushes a prompt onto pic->prompts.  When only bytecode frames
+ * lie between a shift and the innermost prompt, shift copies that segment
+ * of the VM stacks and unwinds to the prompt; calling the continuation
+ * pushes a copy of the segment back and resumes it under a new prompt.  No
+ * native stack is copied on this path, so the cost is proportional to the
+ * depth of the segment.  When native frames are in between, shift falls
+ * back to Filinski's encoding over call/cc, and a reset made for such a
+ * continuation returns through its own full continuation.
+ */
+
+struct prompt {
+  struct cont cont;             /* escape point in the reset */
+  pic_value k;                  /* full continuation of the reset, or #f */
+  pic_value proc, kont;         /* shift body to run under the prompt, or #f */
+  pic_value val;                /* value delivered to the reset */
+};
+
+struct segment {
+  const pic_code *ip;           /* where the topmost frame continues */
+  int cic, stc;
+  struct callinfo *ci;          /* bottommost first */
+  pic_value *st;
+  pic_value *base;              /* where st was on the VM stack */
+};
+
+static void
+prompt_dtor(pic_state *pic, void *data)
+{
+  pic_free(pic, data);
+}
+
+static void
+prompt_mark(pic_state *pic, void *data, void (*mark)(pic_state *, pic_value))
+{
+  struct prompt *p = data;
+
+  mark(pic, p->k);
+  mark(pic, p->proc);
+  mark(pic, p->kont);
+  mark(pic, p->val);
+}
+
+static const pic_data_type prompt_type = { "prompt", prompt_dtor, prompt_mark };
+
+static void
+segment_dtor(pic_state *pic, void *data)
+{
+  struct segment *seg = data;
+
+  pic_free(pic, seg->ci);
+  pic_free(pic, seg->st);
+  pic_free(pic, seg);
+}
+
+static void
+segment_mark(pic_state *pic, void *data, void (*mark)(pic_state *, pic_value))
+{
+  struct segment *seg = data;
+  int i;
+
+  for (i = 0; i < seg->stc; ++i) {
+    mark(pic, seg->st[i]);
+  }
+  for (i = 0; i < seg->cic; ++i) {
+    if (seg->ci[i].cxt) {
+      mark(pic, pic_obj_value(seg->ci[i].cxt));
+    }
+    if (seg->ci[i].up) {
+      mark(pic, pic_obj_value(seg->ci[i].up));
+    }
+  }
+}
+
+static const pic_data_type segment_type = { "segment", segment_dtor, segment_mark };
+
+static struct prompt *
+push_prompt(pic_state *pic, pic_value k)
+{
+  struct prompt *p = pic_malloc(pic, sizeof(struct prompt));
+
+  p->k = k;
+  p->proc = p->kont = p->val = pic_false_value(pic);
+
+  pic->prompts = pic_cons(pic, pic_data_value(pic, p, &prompt_type), pic->prompts);
+  return p;
+}
+
+/* hands val to the innermost reset, which is not the caller's */
+PIC_NORETURN static void
+prompt_return(pic_state *pic, pic_value val)
+{
+  struct prompt *p;
+
+  if (pic_nil_p(pic, pic->prompts)) {
+    pic_error(pic, "reset: no prompt to return to", 0);
+  }
+  p = pic_data(pic, pic_car(pic, pic->prompts));
+  pic->prompts = pic_cdr(pic, pic->prompts);
+
+  if (! pic_false_p(pic, p->k)) {
+    pic_call(pic, p->k, 1, val);
+    PIC_UNREACHABLE();
+  }
+  p->val = val;
+  pic_load_point(pic, &p->cont);
+  PIC_LONGJMP(pic, *p->cont.jmp, 1);
+  PIC_UNREACHABLE();
+}
+
+static pic_value
+resume(pic_state *pic, struct segment *seg, pic_value v)
+{
+  struct callinfo *ci;
+  pic_value *base;
+  int i;
+
+  if (seg->cic == 0) {
+    return v;
+  }
+
+  pic_vm_reserve(pic, seg->stc + (int)seg->ci[seg->cic - 1].irep->ncode + 1, seg->cic);
+
+  base = pic->sp;
+  memcpy(base, seg->st, sizeof(pic_value) * seg->stc);
+  for (i = 0; i < seg->cic; ++i) {
+    ci = ++pic->ci;
+    *ci = seg->ci[i];
+    ci->fp = base + (ci->fp - seg->base);
+    ci->regs = base + (ci->regs - seg->base);
+  }
+  pic->ci[1 - seg->cic].ip = pic_vm_stop; /* the bottom returns to us */
+
+  /* the value of the shift */
+  pic->sp = base + seg->stc;
+  *pic->sp++ = v;
+
+  return pic_vm_resume(pic, seg->ip);
+}
+
+static pic_value
+reset(pic_state *pic, pic_value thunk, struct segment *seg, pic_value v)
+{
+  PIC_JMPBUF jmp;
+  struct prompt *p = push_prompt(pic, pic_false_value(pic));
+  pic_value val, proc;
+
+  if (PIC_SETJMP(pic, jmp)) {
+    if (pic_false_p(pic, p->proc)) {
+      pic->prompts = pic_cdr(pic, pic->prompts);
+      return p->val;
+    }
+  }
+  pic_save_point(pic, &p->cont, &jmp);
+
+  if (! pic_false_p(pic, p->proc)) {
+    /* a shift unwound to this prompt; its body runs under it */
+    proc = p->proc;
+    p->proc = pic_false_value(pic);
+    val = pic_call(pic, proc, 1, p->kont);
+  } else if (seg != NULL) {
+    val = resume(pic, seg, v);
+  } else {
+    val = pic_call(pic, thunk, 0);
+  }
+
+  pic_exit_point(pic);
+
+  if (pic_data(pic, pic_car(pic, pic->prompts)) != p) {
+    prompt_return(pic, val);    /* reinstated by a full continuation */
+  }
+  pic->prompts = pic_cdr(pic, pic->prompts);
+  return val;
+}
+
+pic_value
+pic_reset(pic_state *pic, pic_value thunk)
+{
+  return reset(pic, thunk, NULL, pic_undef_value(pic));
+}
+
+static pic_value
+kont_call(pic_state *pic)
+{
+  pic_value v;
+
+  pic_get_args(pic, "o", &v);
+
+  return reset(pic, pic_false_value(pic), pic_data(pic, pic_closure_ref(pic, 0)), v);
+}
+
+/* the frames above the prompt's reset, if they are all bytecode called from bytecode */
+static pic_value
+capture(pic_state *pic, struct prompt *p)
+{
+  struct callinfo *base = pic->cibase + p->cont.ci_offset, *ci;
+  struct segment *seg;
+  pic_value *bottom;
+
+  for (ci = pic->ci; ci > base + 1; --ci) {
+    struct irep *irep = ci[-1].irep;
+
+    if (irep == NULL || ci->ip < irep->code || ci->ip > irep->code + irep->ncode) {
+      return pic_false_value(pic);
+    }
+  }
+
+  pic_vm_tear_off(pic, base);
+
+  seg = pic_malloc(pic, sizeof(struct segment));
+  seg->ip = pic->ci->ip;
+  seg->cic = (int)(pic->ci - (base + 1));
+  bottom = seg->cic > 0 ? base[1].fp : pic->ci->fp;
+  seg->stc = (int)(pic->ci->fp - bottom);
+  seg->base = bottom;
+  seg->ci = pic_malloc(pic, sizeof(struct callinfo) * (seg->cic + 1));
+  memcpy(seg->ci, base + 1, sizeof(struct callinfo) * seg->cic);
+  seg->st = pic_malloc(pic, sizeof(pic_value) * (seg->stc + 1));
+  memcpy(seg->st, bottom, sizeof(pic_value) * seg->stc);
+
+  return pic_lambda(pic, kont_call, 1, pic_data_value(pic, seg, &segment_type));
+}
+
+static pic_value
+reset_full(pic_state *pic)
+{
+  pic_value k;
+
+  pic_get_args(pic, "o", &k);
+
+  push_prompt(pic, k);
+
+  prompt_return(pic, pic_call(pic, pic_closure_ref(pic, 0), 1, pic_closure_ref(pic, 1)));
+}
+
+static pic_value
+kont_full_call(pic_state *pic)
+{
+  pic_value v, callcc = pic_ref(pic, "picrin.base", "call/cc");
+
+  pic_get_args(pic, "o", &v);
+
+  return pic_call(pic, callcc, 1, pic_lambda(pic, reset_full, 2, pic_closure_ref(pic, 0), v));
+}
+
+static pic_value
+shift_full(pic_state *pic)
+{
+  pic_value k, kont;
+
+  pic_get_args(pic, "o", &k);
+
+  kont = pic_lambda(pic, kont_full_call, 1, k);
+
+  prompt_return(pic, pic_call(pic, pic_closure_ref(pic, 0), 1, kont));
+}
+
+pic_value
+pic_shift(pic_state *pic, pic_value proc)
+{
+  pic_value kont, callcc;
+  struct prompt *p;
+
+  if (pic_nil_p(pic, pic->prompts)) {
+    pic_error(pic, "shift: no enclosing reset", 0);
+  }
+  p = pic_data(pic, pic_car(pic, pic->prompts));
+
+  if (pic_false_p(pic, p->k) && ! pic_false_p(pic, kont = capture(pic, p))) {
+    p->proc = proc;
+    p->kont = kont;
+    pic_load_point(pic, &p->cont);
+    PIC_LONGJMP(pic, *p->cont.jmp, 1);
+  }
+
+  callcc = pic_ref(pic, "picrin.base", "call/cc");
+
+  return pic_call(pic, callcc, 1, pic_lambda(pic, shift_full, 1, proc));
+}
+
 pic_value
 pic_return(pic_state *pic, int n, ...)
 {
@@ -195,6 +469,8 @@ pic_valuesk(pic_state *pic, int argc, pic_value *argv)
 {
   int i;
 
+  pic_vm_reserve(pic, argc, 0);
+
   for (i = 0; i < argc; ++i) {
     pic->sp[i] = argv[i];
   }
@@ -25,5 +25,9 @@ pic_data_value(pic_state *pic, void *userdata, const pic_data_type *type)
   data->type = type;
   data->data = userdata;
 
+  if (type->mark) {
+    pic_gc_track_data(pic, (struct object *)data);
+  }
+
   return pic_obj_value(data);
 }
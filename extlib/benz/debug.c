@@ -6,33 +6,139 @@
 #include "picrin/extra.h"
 #include "picrin/private/object.h"
 #include "picrin/private/state.h"
+#include "picrin/private/vm.h"
 
-pic_value
-pic_get_backtrace(pic_state *pic)
+struct trace {
+  int len;
+  bool more;                    /* frames beyond the depth were dropped */
+  struct {
+    struct irep *irep;          /* NULL unless a compiled procedure */
+    int ip;                     /* offset of the pending call, -1 if unknown */
+    bool native;
+  } frames[1];
+};
+
+struct trace *
+pic_trace_capture(pic_state *pic)
 {
-  size_t ai = pic_enter(pic);
   struct callinfo *ci;
-  pic_value trace;
+  struct trace *trace;
+  int n, depth = pic->backtrace_depth;
+
+  if (depth == 0) {
+    return NULL;
+  }
+  n = (int)(pic->ci - pic->cibase);
+  if (n > depth) {
+    n = depth;
+  }
+
+  trace = pic_malloc(pic, offsetof(struct trace, frames) + sizeof(trace->frames[0]) * (n > 0 ? n : 1));
+  trace->len = 0;
+  trace->more = pic->ci - pic->cibase > depth;
+
+  for (ci = pic->ci; trace->len < n; --ci) {
+    struct irep *irep = NULL;
+    int ip = -1;
 
-  trace = pic_lit_value(pic, "");
+    if (pic_irep_p(pic, ci->fp[0])) {
+      irep = pic_proc_ptr(pic, ci->fp[0])->u.i.irep;
+      pic_irep_incref(pic, irep);
+      if (ci != pic->ci && ci[1].ip >= irep->code && ci[1].ip < irep->code + irep->ncode) {
+        ip = (int)(ci[1].ip - irep->code);
+      }
+    }
+    trace->frames[trace->len].irep = irep;
+    trace->frames[trace->len].ip = ip;
+    trace->frames[trace->len].native = pic_func_p(pic, ci->fp[0]);
+    trace->len++;
+  }
+  return trace;
+}
+
+void
+pic_trace_free(pic_state *pic, struct trace *trace)
+{
+  int i;
+
+  for (i = 0; i < trace->len; ++i) {
+    if (trace->frames[i].irep) {
+      pic_irep_decref(pic, trace->frames[i].irep);
+    }
+  }
+  pic_free(pic, trace);
+}
+
+static pic_value
+format_trace(pic_state *pic, struct trace *trace)
+{
+  size_t ai = pic_enter(pic);
+  pic_value str;
+  int i;
 
-  for (ci = pic->ci; ci != pic->cibase; --ci) {
-    pic_value proc = ci->fp[0];
+  str = pic_lit_value(pic, "");
 
-    trace = pic_str_cat(pic, trace, pic_lit_value(pic, "  at "));
-    trace = pic_str_cat(pic, trace, pic_lit_value(pic, "(anonymous lambda)"));
+  for (i = 0; trace != NULL && i < trace->len; ++i) {
+    str = pic_str_cat(pic, str, pic_lit_value(pic, "  at "));
+    str = pic_str_cat(pic, str, pic_lit_value(pic, "(anonymous lambda)"));
 
-    if (pic_func_p(pic, proc)) {
-      trace = pic_str_cat(pic, trace, pic_lit_value(pic, " (native function)\n"));
+    if (trace->frames[i].native) {
+      str = pic_str_cat(pic, str, pic_lit_value(pic, " (native function)\n"));
     } else {
-      trace = pic_str_cat(pic, trace, pic_lit_value(pic, " (unknown location)\n")); /* TODO */
+      str = pic_str_cat(pic, str, pic_lit_value(pic, " (unknown location)\n")); /* TODO */
     }
   }
+  if (trace != NULL && trace->more) {
+    str = pic_str_cat(pic, str, pic_lit_value(pic, "  ...\n"));
+  }
 
   pic_leave(pic, ai);
-  pic_protect(pic, trace);
+  pic_protect(pic, str);
 
-  return trace;
+  return str;
+}
+
+pic_value
+pic_get_backtrace(pic_state *pic)
+{
+  struct trace *trace = pic_trace_capture(pic);
+  pic_value str;
+
+  str = format_trace(pic, trace);
+  if (trace) {
+    pic_trace_free(pic, trace);
+  }
+  return str;
+}
+
+pic_value
+pic_error_backtrace(pic_state *pic, pic_value err)
+{
+  struct error *e;
+
+  TYPE_CHECK(pic, err, error);
+
+  e = pic_error_ptr(pic, err);
+  if (e->stack == NULL) {
+    e->stack = pic_str_ptr(pic, format_trace(pic, e->trace));
+    pic_gc_write_barrier(pic, (struct object *)e, pic_obj_value(e->stack));
+    if (e->trace) {
+      pic_trace_free(pic, e->trace);
+      e->trace = NULL;
+    }
+  }
+  return pic_obj_value(e->stack);
+}
+
+int
+pic_backtrace_depth(pic_state *pic, int depth)
+{
+  int old = pic->backtrace_depth;
+
+  if (depth >= 0) {
+    pic->backtrace_depth = depth;
+  }
+  return old;
 }
 
 #if PIC_USE_WRITE
@@ -55,7 +161,7 @@ pic_print_error(pic_state *pic, pic_value port, pic_value err)
     pic_for_each (elem, e->irrs, it) { /* print error irritants */
       pic_fprintf(pic, port, " ~s", elem);
     }
-    pic_fprintf(pic, port, "\n%s", pic_str(pic, pic_obj_value(e->stack)));
+    pic_fprintf(pic, port, "\n%s", pic_str(pic, pic_error_backtrace(pic, err)));
   }
 }
 
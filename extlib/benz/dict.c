@@ -40,6 +40,8 @@ pic_dict_set(pic_state *pic, pic_value dict, pic_value key, pic_value val)
 
   it = kh_put(dict, h, pic_sym_ptr(pic, key), &ret);
   kh_val(h, it) = val;
+  pic_gc_write_barrier(pic, pic_obj_ptr(dict), key);
+  pic_gc_write_barrier(pic, pic_obj_ptr(dict), val);
 }
 
 int
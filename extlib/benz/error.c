@@ -36,84 +36,34 @@ pic_warnf(pic_state *pic, const char *fmt, ...)
   pic_fprintf(pic, pic_stderr(pic), "warn: %s\n", pic_str(pic, err));
 }
 
-static pic_value
-native_exception_handler(pic_state *pic)
-{
-  pic_value err;
-
-  pic_get_args(pic, "o", &err);
-
-  pic->err = err;
+/* A try block or guard pushes an entry onto the handler stack whose car is
+   #f (catch everything) or a guard's clause selector; the escape point that
+   owns the entry remembers it in cont->trap. */
 
-  pic_call(pic, pic_closure_ref(pic, 0), 1, pic_false_value(pic));
-
-  PIC_UNREACHABLE();
+static void
+push_trap(pic_state *pic, struct cont *cont, PIC_JMPBUF *jmp, pic_value selector)
+{
+  pic_save_point(pic, cont, jmp);
+  cont->trap = pic->handlers = pic_cons(pic, selector, pic->handlers);
 }
 
-static pic_value
-dynamic_set(pic_state *pic)
+static void
+pop_trap(pic_state *pic)
 {
-  pic_value var, val;
-
-  pic_get_args(pic, "");
-
-  var = pic_closure_ref(pic, 0);
-  val = pic_closure_ref(pic, 1);
-
-  pic_proc_ptr(pic, var)->locals[0] = val;
-
-  return pic_undef_value(pic);
+  pic->handlers = pic->cc->handlers;
+  pic_exit_point(pic);
 }
 
-pic_value
+void
 pic_start_try(pic_state *pic, PIC_JMPBUF *jmp)
 {
-  struct cont *cont;
-  pic_value handler;
-  pic_value var, old_val, new_val;
-  pic_value in, out;
-  struct checkpoint *here;
-
-  /* call/cc */
-
-  cont = pic_alloca_cont(pic);
-  pic_save_point(pic, cont, jmp);
-  handler = pic_lambda(pic, native_exception_handler, 1, pic_make_cont(pic, cont));
-
-  /* with-exception-handler */
-
-  var = pic_ref(pic, "picrin.base", "current-exception-handlers");
-  old_val = pic_call(pic, var, 0);
-  new_val = pic_cons(pic, handler, old_val);
-
-  in = pic_lambda(pic, dynamic_set, 2, var, new_val);
-  out = pic_lambda(pic, dynamic_set, 2, var, old_val);
-
-  /* dynamic-wind */
-
-  pic_call(pic, in, 0);       /* enter */
-
-  here = pic->cp;
-  pic->cp = (struct checkpoint *)pic_obj_alloc(pic, sizeof(struct checkpoint), PIC_TYPE_CP);
-  pic->cp->prev = here;
-  pic->cp->depth = here->depth + 1;
-  pic->cp->in = pic_proc_ptr(pic, in);
-  pic->cp->out = pic_proc_ptr(pic, out);
-
-  return pic_cons(pic, pic_obj_value(here), out);
+  push_trap(pic, pic_alloca_cont(pic), jmp, pic_false_value(pic));
 }
 
 void
-pic_end_try(pic_state *pic, pic_value cookie)
+pic_end_try(pic_state *pic)
 {
-  struct checkpoint *here = (struct checkpoint *)pic_obj_ptr(pic_car(pic, cookie));
-  pic_value out = pic_cdr(pic, cookie);
-
-  pic->cp = here;
-
-  pic_call(pic, out, 0); /* exit */
-
-  pic_exit_point(pic);
+  pop_trap(pic);
 }
 
 pic_value
@@ -126,15 +76,20 @@ pic_value
 pic_make_error(pic_state *pic, const char *type, const char *msg, pic_value irrs)
 {
   struct error *e;
-  pic_value stack, ty = pic_intern_cstr(pic, type);
+  struct trace *trace;
+  pic_value str, ty = pic_intern_cstr(pic, type);
+
+  str = pic_cstr_value(pic, msg);
 
-  stack = pic_get_backtrace(pic);
+  /* the frames are formatted only when someone asks for the backtrace */
+  trace = pic_trace_capture(pic);
 
   e = (struct error *)pic_obj_alloc(pic, sizeof(struct error), PIC_TYPE_ERROR);
   e->type = pic_sym_ptr(pic, ty);
-  e->msg = pic_str_ptr(pic, pic_cstr_value(pic, msg));
+  e->msg = pic_str_ptr(pic, str);
   e->irrs = irrs;
-  e->stack = pic_str_ptr(pic, stack);
+  e->stack = NULL;
+  e->trace = trace;
 
   return pic_obj_value(e);
 }
@@ -154,65 +109,124 @@ pic_error(pic_state *pic, const char *msg, int n, ...)
   pic_raise(pic, pic_make_error(pic, "", msg, irrs));
 }
 
+static pic_value call_handler(pic_state *, pic_value);
+
 static pic_value
-raise_action(pic_state *pic)
+call_trap(pic_state *pic, struct cont *trap, pic_value err)
 {
-  pic_get_args(pic, "");
-
-  pic_call(pic, pic_closure_ref(pic, 0), 1, pic_closure_ref(pic, 1));
+  pic_value stack = pic->handlers, selector = pic_car(pic, stack), k, val;
+  struct checkpoint *here = pic->cp;
+
+  if (! pic_false_p(pic, selector)) {
+    pic_protect(pic, pic_obj_value(here));
+
+    /* clauses are selected in the dynamic environment of the guard */
+    pic->handlers = pic_cdr(pic, stack);
+    pic_wind(pic, here, trap->cp);
+    pic->cp = trap->cp;
+
+    k = pic_call(pic, selector, 1, err);
+
+    if (pic_false_p(pic, k)) {
+      /* no clause matched; re-raise where the condition was raised */
+      pic_wind(pic, trap->cp, here);
+      pic->cp = here;
+      val = call_handler(pic, err);
+      pic->handlers = stack;
+      return val;
+    }
+    err = k;
+  }
 
-  pic_error(pic, "handler returned", 2, pic_closure_ref(pic, 0), pic_closure_ref(pic, 1));
+  pic->err = err;
+  pic_load_point(pic, trap);
+  PIC_LONGJMP(pic, *trap->jmp, 1);
+  PIC_UNREACHABLE();
 }
 
-void
-pic_raise(pic_state *pic, pic_value err)
+static pic_value
+call_handler(pic_state *pic, pic_value err)
 {
-  pic_value stack, exc = pic_ref(pic, "picrin.base", "current-exception-handlers");
-
-  stack = pic_call(pic, exc, 0);
+  pic_value stack = pic->handlers, val;
+  struct cont *cc;
 
   if (pic_nil_p(pic, stack)) {
     pic_panic(pic, "no exception handler");
   }
 
-  pic_dynamic_bind(pic, exc, pic_cdr(pic, stack), pic_lambda(pic, raise_action, 2, pic_car(pic, stack), err));
+  for (cc = pic->cc; cc != NULL; cc = cc->prev) {
+    if (pic_eq_p(pic, cc->trap, stack)) {
+      return call_trap(pic, cc, err);
+    }
+  }
 
-  PIC_UNREACHABLE();
+  pic_protect(pic, stack);
+
+  /* the handler runs with the outer handlers installed */
+  pic->handlers = pic_cdr(pic, stack);
+  val = pic_call(pic, pic_car(pic, stack), 1, err);
+  pic->handlers = stack;
+
+  return val;
 }
 
-static pic_value
-raise_continuable(pic_state *pic)
+void
+pic_raise(pic_state *pic, pic_value err)
 {
-  pic_get_args(pic, "");
+  pic_value stack = pic->handlers;
+
+  call_handler(pic, err);
+
+  pic->handlers = pic_cdr(pic, stack);
 
-  return pic_call(pic, pic_closure_ref(pic, 0), 1, pic_closure_ref(pic, 1));
+  pic_error(pic, "handler returned", 2, pic_car(pic, stack), err);
 }
 
 pic_value
 pic_raise_continuable(pic_state *pic, pic_value err)
 {
-  pic_value stack, exc = pic_ref(pic, "picrin.base", "current-exception-handlers");
+  return call_handler(pic, err);
+}
 
-  stack = pic_call(pic, exc, 0);
+static pic_value
+pic_error_with_exception_handler(pic_state *pic)
+{
+  pic_value handler, thunk, stack = pic->handlers, val;
 
-  if (pic_nil_p(pic, stack)) {
-    pic_panic(pic, "no exception handler");
-  }
+  pic_get_args(pic, "ll", &handler, &thunk);
 
-  return pic_dynamic_bind(pic, exc, pic_cdr(pic, stack), pic_lambda(pic, raise_continuable, 2, pic_car(pic, stack), err));
+  pic->handlers = pic_cons(pic, handler, stack);
+  val = pic_call(pic, thunk, 0);
+  pic->handlers = stack;
+
+  return val;
 }
 
 static pic_value
-pic_error_with_exception_handler(pic_state *pic)
+pic_error_with_guard(pic_state *pic)
 {
-  pic_value handler, thunk;
-  pic_value stack, exc = pic_ref(pic, "picrin.base", "current-exception-handlers");
+  pic_value selector, thunk, *retv;
+  PIC_JMPBUF jmp;
+  int retc;
 
-  pic_get_args(pic, "ll", &handler, &thunk);
+  pic_get_args(pic, "ll", &selector, &thunk);
+
+  if (PIC_SETJMP(pic, jmp)) {
+    /* a clause was selected; run its body in the guard's continuation */
+    return pic_applyk(pic, pic->err, 0, NULL);
+  }
+
+  push_trap(pic, pic_alloca_cont(pic), &jmp, selector);
+
+  pic_call(pic, thunk, 0);
 
-  stack = pic_call(pic, exc, 0);
+  retc = pic_receive(pic, 0, NULL);
+  retv = pic_alloca(pic, sizeof(pic_value) * retc);
+  pic_receive(pic, retc, retv);
 
-  return pic_dynamic_bind(pic, exc, pic_cons(pic, handler, stack), thunk);
+  pop_trap(pic);
+
+  return pic_valuesk(pic, retc, retv);
 }
 
 static pic_value
@@ -293,11 +307,31 @@ pic_error_error_object_type(pic_state *pic)
   return pic_obj_value(pic_error_ptr(pic, e)->type);
 }
 
+static pic_value
+pic_error_error_object_backtrace(pic_state *pic)
+{
+  pic_value e;
+
+  pic_get_args(pic, "o", &e);
+
+  return pic_error_backtrace(pic, e);
+}
+
+static pic_value
+pic_error_backtrace_depth(pic_state *pic)
+{
+  int depth = -1;
+
+  pic_get_args(pic, "|i", &depth);
+
+  return pic_int_value(pic, pic_backtrace_depth(pic, depth));
+}
+
 void
 pic_init_error(pic_state *pic)
 {
-  pic_defvar(pic, "current-exception-handlers", pic_nil_value(pic), pic_false_value(pic));
   pic_defun(pic, "with-exception-handler", pic_error_with_exception_handler);
+  pic_defun(pic, "with-guard", pic_error_with_guard);
   pic_defun(pic, "raise", pic_error_raise);
   pic_defun(pic, "raise-continuable", pic_error_raise_continuable);
   pic_defun(pic, "error", pic_error_error);
@@ -305,4 +339,6 @@ pic_init_error(pic_state *pic)
   pic_defun(pic, "error-object-message", pic_error_error_object_message);
   pic_defun(pic, "error-object-irritants", pic_error_error_object_irritants);
   pic_defun(pic, "error-object-type", pic_error_error_object_type);
+  pic_defun(pic, "error-object-backtrace", pic_error_error_object_backtrace);
+  pic_defun(pic, "backtrace-depth", pic_error_backtrace_depth);
 }
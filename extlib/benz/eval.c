@@ -10,7 +10,7 @@
 
 static pic_value pic_compile(pic_state *, pic_value);
 
-#define EQ(sym, lit) (strcmp(pic_sym(pic, sym), lit) == 0)
+#define EQ(sym, lit) (pic_sym_interned_p(pic, sym) && strcmp(pic_sym(pic, sym), lit) == 0)
 #define S(lit) (pic_intern_lit(pic, lit))
 
 static void
@@ -20,6 +20,7 @@ define_macro(pic_state *pic, pic_value uid, pic_value mac)
     pic_warnf(pic, "redefining syntax variable: %s", pic_sym(pic, uid));
   }
   pic_weak_set(pic, pic->macros, uid, mac);
+  pic_image_effect(pic, PIC_IMAGE_MACRO, uid, mac, pic_undef_value(pic));
 }
 
 static bool
@@ -38,6 +39,7 @@ shadow_macro(pic_state *pic, pic_value uid)
   if (pic_weak_has(pic, pic->macros, uid)) {
     pic_weak_del(pic, pic->macros, uid);
   }
+  pic_image_effect(pic, PIC_IMAGE_SHADOW, uid, pic_undef_value(pic), pic_undef_value(pic));
 }
 
 static pic_value expand(pic_state *, pic_value expr, pic_value env, pic_value deferred);
@@ -238,6 +240,78 @@ pic_expand(pic_state *pic, pic_value expr, pic_value env)
   return v;
 }
 
+/*
+ * Built-in procedures the codegen turns into instructions. The uids are
+ * those of picrin.base, where these bindings may not be assigned, and an
+ * instruction is only used while the binding holds a native procedure.
+ */
+static const struct {
+  const char *name;
+  int insn;
+  int argc;
+} pic_vm_proc[] = {
+  { "picrin.base/cons", OP_CONS, 2 },
+  { "picrin.base/car", OP_CAR, 1 },
+  { "picrin.base/cdr", OP_CDR, 1 },
+  { "picrin.base/null?", OP_NILP, 1 },
+  { "picrin.base/symbol?", OP_SYMBOLP, 1 },
+  { "picrin.base/pair?", OP_PAIRP, 1 },
+  { "picrin.base/not", OP_NOT, 1 },
+  { "picrin.base/=", OP_EQ, 2 },
+  { "picrin.base/<", OP_LT, 2 },
+  { "picrin.base/<=", OP_LE, 2 },
+  { "picrin.base/>", OP_GT, 2 },
+  { "picrin.base/>=", OP_GE, 2 },
+  { "picrin.base/+", OP_ADD, 2 },
+  { "picrin.base/-", OP_SUB, 2 },
+  { "picrin.base/*", OP_MUL, 2 },
+  { "picrin.base//", OP_DIV, 2 },
+  { "picrin.base/eq?", OP_EQP, 2 },
+  { "picrin.base/eqv?", OP_EQVP, 2 },
+  { "picrin.base/set-car!", OP_SETCAR, 2 },
+  { "picrin.base/set-cdr!", OP_SETCDR, 2 },
+  { "picrin.base/vector?", OP_VECTORP, 1 },
+  { "picrin.base/vector-ref", OP_VREF, 2 },
+  { "picrin.base/vector-set!", OP_VSET, 3 },
+  { "picrin.base/vector-length", OP_VLEN, 1 },
+  { "picrin.base/string?", OP_STRINGP, 1 },
+  { "picrin.base/string-ref", OP_SREF, 2 },
+  { "picrin.base/string-length", OP_SLEN, 1 },
+  { "picrin.base/char?", OP_CHARP, 1 },
+  { "picrin.base/char=?", OP_CHAREQ, 2 },
+  { "picrin.base/char<?", OP_CHARLT, 2 },
+  { "picrin.base/char->integer", OP_CHAR2INT, 1 },
+  { "picrin.base/record?", OP_RECORDP, 1 },
+  { "picrin.base/record-type", OP_RECTYPE, 1 },
+  { "picrin.base/record-datum", OP_RECDATUM, 1 }
+};
+
+/* index into pic_vm_proc of the primitive a call of name with argc arguments can use, or -1 */
+static int
+vm_proc_index(pic_state *pic, pic_value name, int argc)
+{
+  struct cell *cell;
+  size_t i;
+
+  if (! pic_weak_has(pic, pic->globals, name)) {
+    return -1;
+  }
+  cell = pic_global_cell(pic, name);
+  if (cell->vm_proc == -2) {    /* the name never changes, so look it up once */
+    cell->vm_proc = -1;
+    for (i = 0; i < sizeof pic_vm_proc / sizeof pic_vm_proc[0]; ++i) {
+      if (EQ(name, pic_vm_proc[i].name)) {
+        cell->vm_proc = (int)i;
+        break;
+      }
+    }
+  }
+  if (cell->vm_proc < 0 || pic_vm_proc[cell->vm_proc].argc != argc || ! pic_func_p(pic, cell->value)) {
+    return -1;
+  }
+  return cell->vm_proc;
+}
+
 static pic_value
 optimize_beta(pic_state *pic, pic_value expr)
 {
@@ -288,96 +362,1021 @@ optimize_beta(pic_state *pic, pic_value expr)
     }
   }
  exit:
-
+
+  pic_leave(pic, ai);
+  pic_protect(pic, expr);
+  return expr;
+}
+
+/*
+ * The passes after beta conversion are driven by what a scan of the program
+ * finds out about its local variables, those bound by a lambda or defined in
+ * one. Since every binding has a uid of its own, one table serves all scopes.
+ *
+ * A call to a procedure known by name, small enough and binding nothing of
+ * its own, becomes an application of a copy of its lambda with fresh
+ * parameters, which the beta pass turns into defines. Locals defined to such
+ * a lambda and never set! are inlined within their scope. Globals are inlined
+ * with the template recorded when they were defined (cell->templ), unless
+ * they have been set! or redefined since. That drops the template for good,
+ * and as code compiled before may still run, the copy is guarded by a check
+ * that the global has its template (inlinable?), calling it otherwise.
+ */
+
+#define OPT_INLINE_SIZE 16
+#define OPT_ROUNDS 2
+
+typedef struct opt_state {
+  pic_value locals;             /* local variables */
+  pic_value sets;               /* local variable -> number of defines and set!s */
+  pic_value refs;               /* local variable -> number of references */
+  pic_value vals;               /* local variable -> expression it is defined to */
+  pic_value assigned;           /* set! variables, local or global */
+} opt_state;
+
+static bool
+opt_local_p(pic_state *pic, opt_state *st, pic_value var)
+{
+  return pic_sym_p(pic, var) && pic_dict_has(pic, st->locals, var);
+}
+
+static int
+opt_count(pic_state *pic, pic_value dict, pic_value var)
+{
+  return pic_dict_has(pic, dict, var) ? pic_int(pic, pic_dict_ref(pic, dict, var)) : 0;
+}
+
+static void
+opt_incr(pic_state *pic, pic_value dict, pic_value var)
+{
+  pic_dict_set(pic, dict, var, pic_int_value(pic, opt_count(pic, dict, var) + 1));
+}
+
+static bool
+opt_form_p(pic_state *pic, pic_value obj, const char *name)
+{
+  return pic_pair_p(pic, obj) && pic_sym_p(pic, pic_car(pic, obj)) && EQ(pic_car(pic, obj), name);
+}
+
+/* constants are quoted data and self-evaluating atoms */
+static bool
+opt_const_p(pic_state *pic, pic_value obj, pic_value *val)
+{
+  if (opt_form_p(pic, obj, "quote")) {
+    *val = pic_list_ref(pic, obj, 1);
+    return true;
+  }
+  if (pic_sym_p(pic, obj) || pic_pair_p(pic, obj)) {
+    return false;
+  }
+  *val = obj;
+  return true;
+}
+
+/*
+ * Only immediates are propagated and folded on. Quoted pairs, vectors and
+ * strings may be mutated at run time, after which (car '(1 2)) must not
+ * still be 1.
+ */
+static bool
+opt_foldable_p(pic_state *pic, pic_value v)
+{
+  return pic_int_p(pic, v) || pic_float_p(pic, v) || pic_char_p(pic, v)
+    || pic_true_p(pic, v) || pic_false_p(pic, v) || pic_nil_p(pic, v);
+}
+
+/* evaluating obj has no effect and cannot fail */
+static bool
+opt_pure_p(pic_state *pic, opt_state *st, pic_value obj)
+{
+  pic_value val;
+
+  return opt_const_p(pic, obj, &val) || opt_form_p(pic, obj, "lambda") || opt_local_p(pic, st, obj);
+}
+
+static void
+opt_scan(pic_state *pic, opt_state *st, pic_value obj, bool in)
+{
+  size_t ai = pic_enter(pic);
+  pic_value proc, var, e, it;
+
+  if (pic_sym_p(pic, obj)) {
+    opt_incr(pic, st->refs, obj);
+  }
+  else if (pic_pair_p(pic, obj) && pic_list_p(pic, obj)) {
+    proc = pic_car(pic, obj);
+    if (pic_sym_p(pic, proc) && EQ(proc, "quote")) {
+      /* nothing to see */
+    }
+    else if (pic_sym_p(pic, proc) && EQ(proc, "lambda")) {
+      for (e = pic_list_ref(pic, obj, 1); pic_pair_p(pic, e); e = pic_cdr(pic, e)) {
+        pic_dict_set(pic, st->locals, pic_car(pic, e), pic_true_value(pic));
+        opt_incr(pic, st->sets, pic_car(pic, e));
+      }
+      if (pic_sym_p(pic, e)) {
+        pic_dict_set(pic, st->locals, e, pic_true_value(pic));
+        opt_incr(pic, st->sets, e);
+      }
+      opt_scan(pic, st, pic_list_ref(pic, obj, 2), true);
+    }
+    else if (pic_sym_p(pic, proc) && (EQ(proc, "define") || EQ(proc, "set!"))) {
+      var = pic_list_ref(pic, obj, 1);
+      if (EQ(proc, "set!")) {
+        pic_dict_set(pic, st->assigned, var, pic_true_value(pic));
+      } else if (in) {
+        pic_dict_set(pic, st->locals, var, pic_true_value(pic));
+      }
+      opt_incr(pic, st->sets, var);
+      if (opt_count(pic, st->sets, var) == 1 && EQ(proc, "define")) {
+        pic_dict_set(pic, st->vals, var, pic_list_ref(pic, obj, 2));
+      } else if (pic_dict_has(pic, st->vals, var)) {
+        pic_dict_del(pic, st->vals, var);
+      }
+      opt_scan(pic, st, pic_list_ref(pic, obj, 2), in);
+    }
+    else {
+      if (pic_sym_p(pic, proc) && (EQ(proc, "if") || EQ(proc, "begin"))) {
+        obj = pic_cdr(pic, obj);
+      }
+      pic_for_each (e, obj, it) {
+        opt_scan(pic, st, e, in);
+      }
+    }
+  }
+  pic_leave(pic, ai);
+}
+
+static void
+opt_begin(pic_state *pic, opt_state *st, pic_value obj)
+{
+  st->locals = pic_make_dict(pic);
+  st->sets = pic_make_dict(pic);
+  st->refs = pic_make_dict(pic);
+  st->vals = pic_make_dict(pic);
+  st->assigned = pic_make_dict(pic);
+
+  opt_scan(pic, st, obj, false);
+}
+
+/* whether var's value is always the constant it is defined to */
+static bool
+opt_known_const_p(pic_state *pic, opt_state *st, pic_value var, pic_value *val)
+{
+  return opt_local_p(pic, st, var)
+    && opt_count(pic, st->sets, var) == 1
+    && pic_dict_has(pic, st->vals, var)
+    && opt_const_p(pic, pic_dict_ref(pic, st->vals, var), val)
+    && opt_foldable_p(pic, *val);
+}
+
+/* counts the nodes of obj, failing at references to var and at binders */
+static bool
+opt_copyable_p(pic_state *pic, pic_value var, pic_value obj, int *size)
+{
+  pic_value proc, e, it;
+
+  if (++*size > OPT_INLINE_SIZE) {
+    return false;
+  }
+  if (pic_sym_p(pic, obj)) {
+    return ! pic_eq_p(pic, obj, var);
+  }
+  if (! pic_pair_p(pic, obj)) {
+    return true;
+  }
+  if (! pic_list_p(pic, obj)) {
+    return false;
+  }
+  proc = pic_car(pic, obj);
+  if (pic_sym_p(pic, proc)) {
+    if (EQ(proc, "quote")) {
+      return true;
+    }
+    if (EQ(proc, "lambda") || EQ(proc, "define") || EQ(proc, "set!")) {
+      return false;
+    }
+    if (EQ(proc, "if") || EQ(proc, "begin")) {
+      obj = pic_cdr(pic, obj);
+    }
+  }
+  pic_for_each (e, obj, it) {
+    if (! opt_copyable_p(pic, var, e, size)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/* whether calls to var may be replaced by the body of obj */
+static bool
+opt_template_p(pic_state *pic, pic_value var, pic_value obj)
+{
+  int size = 0;
+
+  return opt_form_p(pic, obj, "lambda")
+    && pic_list_p(pic, pic_list_ref(pic, obj, 1))
+    && opt_copyable_p(pic, var, pic_list_ref(pic, obj, 2), &size);
+}
+
+static pic_value
+opt_rename(pic_state *pic, pic_value obj, pic_value map)
+{
+  pic_value e, it, r;
+
+  if (pic_sym_p(pic, obj)) {
+    return pic_dict_has(pic, map, obj) ? pic_dict_ref(pic, map, obj) : obj;
+  }
+  if (! pic_pair_p(pic, obj) || opt_form_p(pic, obj, "quote")) {
+    return obj;
+  }
+  r = pic_nil_value(pic);
+  pic_for_each (e, obj, it) {
+    pic_push(pic, opt_rename(pic, e, map), r);
+  }
+  return pic_reverse(pic, r);
+}
+
+static pic_value
+opt_template(pic_state *pic, opt_state *st, pic_value var)
+{
+  struct cell *cell;
+  pic_value val;
+
+  if (opt_local_p(pic, st, var)) {
+    if (opt_count(pic, st->sets, var) == 1 && pic_dict_has(pic, st->vals, var)) {
+      val = pic_dict_ref(pic, st->vals, var);
+      if (opt_template_p(pic, var, val)) {
+        return val;
+      }
+    }
+    return pic_false_value(pic);
+  }
+  if (! pic_weak_has(pic, pic->globals, var) || pic_dict_has(pic, st->assigned, var)) {
+    return pic_false_value(pic);
+  }
+  cell = pic_cell_ptr(pic, pic_weak_ref(pic, pic->globals, var));
+  if (! pic_pair_p(pic, cell->templ) || ! pic_proc_p(pic, cell->value)) {
+    return pic_false_value(pic);   /* the definition has not run yet */
+  }
+  return cell->templ;
+}
+
+static pic_value
+optimize_inline(pic_state *pic, opt_state *st, pic_value obj, bool in)
+{
+  size_t ai = pic_enter(pic);
+  pic_value proc, templ, formals, map, fresh, body, e, it, r;
+
+  if (! pic_pair_p(pic, obj) || ! pic_list_p(pic, obj)) {
+    return obj;
+  }
+
+  proc = pic_car(pic, obj);
+  if (pic_sym_p(pic, proc) && EQ(proc, "quote")) {
+    return obj;
+  }
+  if (pic_sym_p(pic, proc) && EQ(proc, "lambda")) {
+    obj = pic_list(pic, 3, S("lambda"), pic_list_ref(pic, obj, 1), optimize_inline(pic, st, pic_list_ref(pic, obj, 2), true));
+  }
+  else if (pic_sym_p(pic, proc) && (EQ(proc, "define") || EQ(proc, "set!"))) {
+    obj = pic_list(pic, 3, proc, pic_list_ref(pic, obj, 1), optimize_inline(pic, st, pic_list_ref(pic, obj, 2), in));
+  }
+  else {
+    r = pic_nil_value(pic);
+    pic_for_each (e, obj, it) {
+      pic_push(pic, optimize_inline(pic, st, e, in), r);
+    }
+    obj = pic_reverse(pic, r);
+
+    /* inlined bodies would become globals at toplevel */
+    if (in && pic_sym_p(pic, proc) && ! EQ(proc, "if") && ! EQ(proc, "begin")) {
+      templ = opt_template(pic, st, proc);
+      if (! pic_false_p(pic, templ) && pic_length(pic, pic_list_ref(pic, templ, 1)) == pic_length(pic, obj) - 1) {
+        map = pic_make_dict(pic);
+        formals = pic_nil_value(pic);
+        pic_for_each (e, pic_list_ref(pic, templ, 1), it) {
+          fresh = pic_make_uid(pic, pic_sym_interned_p(pic, e) ? pic_sym_name(pic, e) : pic_obj_value(pic_sym_ptr(pic, e)->base));
+          pic_dict_set(pic, map, e, fresh);
+          pic_push(pic, fresh, formals);
+        }
+        formals = pic_reverse(pic, formals);
+        body = opt_rename(pic, pic_list_ref(pic, templ, 2), map);
+        if (! opt_local_p(pic, st, proc)) {
+          body = pic_list(pic, 4, S("if"), pic_list(pic, 2, S("inlinable?"), proc), body, pic_cons(pic, proc, formals));
+        }
+        templ = pic_list(pic, 3, S("lambda"), formals, body);
+        obj = pic_cons(pic, templ, pic_cdr(pic, obj));
+      }
+    }
+  }
+
+  pic_leave(pic, ai);
+  pic_protect(pic, obj);
+  return obj;
+}
+
+/* whether the primitive insn can be applied to the immediates argv without raising */
+static bool
+opt_fold_args_p(pic_state *pic, int insn, int argc, pic_value *argv)
+{
+  int i;
+
+  switch (insn) {
+  case OP_NILP: case OP_SYMBOLP: case OP_PAIRP: case OP_NOT: case OP_EQP: case OP_EQVP:
+  case OP_VECTORP: case OP_STRINGP: case OP_CHARP: case OP_RECORDP:
+    return true;
+  case OP_EQ: case OP_LT: case OP_LE: case OP_GT: case OP_GE:
+  case OP_ADD: case OP_SUB: case OP_MUL: case OP_DIV:
+    for (i = 0; i < argc; ++i) {
+      if (! pic_int_p(pic, argv[i]) && ! pic_float_p(pic, argv[i])) {
+        return false;
+      }
+    }
+    return true;
+  case OP_CHAREQ: case OP_CHARLT: case OP_CHAR2INT:
+    for (i = 0; i < argc; ++i) {
+      if (! pic_char_p(pic, argv[i])) {
+        return false;
+      }
+    }
+    return true;
+  default:                      /* mutators, and accessors of heap objects */
+    return false;
+  }
+}
+
+/* applies a built-in procedure without side effects to constant arguments */
+static bool
+opt_fold(pic_state *pic, pic_value obj, pic_value *result)
+{
+  pic_value proc = pic_car(pic, obj), argv[3], e, it;
+  int i, argc = 0;
+
+  if (! pic_sym_p(pic, proc)) {
+    return false;
+  }
+  i = vm_proc_index(pic, proc, pic_length(pic, obj) - 1);
+  if (i < 0) {
+    return false;
+  }
+  pic_for_each (e, pic_cdr(pic, obj), it) {
+    if (! opt_const_p(pic, e, &argv[argc]) || ! opt_foldable_p(pic, argv[argc])) {
+      return false;
+    }
+    argc++;
+  }
+  if (! opt_fold_args_p(pic, pic_vm_proc[i].insn, argc, argv)) {
+    return false;               /* left for the run time to complain */
+  }
+  *result = pic_apply(pic, pic_global_cell(pic, proc)->value, argc, argv);
+  return opt_foldable_p(pic, *result);
+}
+
+static pic_value
+optimize_simplify(pic_state *pic, opt_state *st, pic_value obj, int passes)
+{
+  size_t ai = pic_enter(pic);
+  pic_value proc, val, e, it, r;
+
+  if (pic_sym_p(pic, obj)) {
+    if ((passes & PIC_OPT_PROPAGATE) && opt_known_const_p(pic, st, obj, &val)) {
+      /* keeps the count current for dce later in the round */
+      pic_dict_set(pic, st->refs, obj, pic_int_value(pic, opt_count(pic, st->refs, obj) - 1));
+      obj = pic_list(pic, 2, S("quote"), val);
+    }
+    goto exit;
+  }
+  if (! pic_pair_p(pic, obj) || ! pic_list_p(pic, obj)) {
+    return obj;
+  }
+
+  proc = pic_car(pic, obj);
+  if (pic_sym_p(pic, proc) && EQ(proc, "quote")) {
+    return obj;
+  }
+  if (pic_sym_p(pic, proc) && EQ(proc, "lambda")) {
+    obj = pic_list(pic, 3, S("lambda"), pic_list_ref(pic, obj, 1), optimize_simplify(pic, st, pic_list_ref(pic, obj, 2), passes));
+  }
+  else if (pic_sym_p(pic, proc) && (EQ(proc, "define") || EQ(proc, "set!"))) {
+    pic_value var = pic_list_ref(pic, obj, 1);
+
+    val = optimize_simplify(pic, st, pic_list_ref(pic, obj, 2), passes);
+    if (pic_dict_has(pic, st->vals, var)) {
+      pic_dict_set(pic, st->vals, var, val); /* later references see it simplified */
+    }
+    obj = pic_list(pic, 3, proc, var, val);
+  }
+  else if (pic_sym_p(pic, proc) && EQ(proc, "if") && pic_length(pic, obj) == 4) {
+    e = optimize_simplify(pic, st, pic_list_ref(pic, obj, 1), passes);
+    if ((passes & PIC_OPT_DCE) && opt_const_p(pic, e, &val)) {
+      obj = optimize_simplify(pic, st, pic_list_ref(pic, obj, pic_false_p(pic, val) ? 3 : 2), passes);
+    } else {
+      obj = pic_list(pic, 4, proc, e, optimize_simplify(pic, st, pic_list_ref(pic, obj, 2), passes), optimize_simplify(pic, st, pic_list_ref(pic, obj, 3), passes));
+    }
+  }
+  else {
+    r = pic_list(pic, 1, pic_sym_p(pic, proc) ? proc : optimize_simplify(pic, st, proc, passes));
+    pic_for_each (e, pic_cdr(pic, obj), it) {
+      pic_push(pic, optimize_simplify(pic, st, e, passes), r);
+    }
+    obj = pic_reverse(pic, r);
+    if ((passes & PIC_OPT_FOLD) && opt_fold(pic, obj, &val)) {
+      obj = pic_list(pic, 2, S("quote"), val);
+    }
+  }
+
+ exit:
+  pic_leave(pic, ai);
+  pic_protect(pic, obj);
+  return obj;
+}
+
+/* drops unused locals defined to pure expressions, and pure expressions whose values are unused */
+static pic_value
+optimize_dce(pic_state *pic, opt_state *st, pic_value obj, bool in)
+{
+  size_t ai = pic_enter(pic);
+  pic_value proc, var, e, it, r;
+
+  if (! pic_pair_p(pic, obj) || ! pic_list_p(pic, obj)) {
+    return obj;
+  }
+
+  proc = pic_car(pic, obj);
+  if (pic_sym_p(pic, proc) && EQ(proc, "quote")) {
+    return obj;
+  }
+  if (pic_sym_p(pic, proc) && EQ(proc, "lambda")) {
+    obj = pic_list(pic, 3, S("lambda"), pic_list_ref(pic, obj, 1), optimize_dce(pic, st, pic_list_ref(pic, obj, 2), true));
+  }
+  else if (pic_sym_p(pic, proc) && (EQ(proc, "define") || EQ(proc, "set!"))) {
+    var = pic_list_ref(pic, obj, 1);
+    e = pic_list_ref(pic, obj, 2);
+    if (in && EQ(proc, "define") && opt_local_p(pic, st, var)
+        && opt_count(pic, st->refs, var) == 0 && opt_count(pic, st->sets, var) == 1
+        && opt_pure_p(pic, st, e)) {
+      obj = pic_list(pic, 2, S("quote"), pic_undef_value(pic));
+    } else {
+      obj = pic_list(pic, 3, proc, var, optimize_dce(pic, st, e, in));
+    }
+  }
+  else if (pic_sym_p(pic, proc) && EQ(proc, "begin") && ! pic_nil_p(pic, pic_cdr(pic, obj))) {
+    r = pic_nil_value(pic);
+    pic_for_each (e, pic_cdr(pic, obj), it) {
+      e = optimize_dce(pic, st, e, in);
+      if (! (pic_pair_p(pic, pic_cdr(pic, it)) && opt_pure_p(pic, st, e))) {
+        pic_push(pic, e, r);
+      }
+    }
+    obj = pic_nil_p(pic, pic_cdr(pic, r)) ? pic_car(pic, r) : pic_cons(pic, proc, pic_reverse(pic, r));
+  }
+  else {
+    r = pic_nil_value(pic);
+    pic_for_each (e, obj, it) {
+      pic_push(pic, optimize_dce(pic, st, e, in), r);
+    }
+    obj = pic_reverse(pic, r);
+  }
+
+  pic_leave(pic, ai);
+  pic_protect(pic, obj);
+  return obj;
+}
+
+static void
+opt_mark_assigned(pic_state *pic, opt_state *st)
+{
+  pic_value var;
+  int it = 0;
+
+  while (pic_dict_next(pic, st->assigned, &it, &var, NULL)) {
+    struct cell *cell;
+
+    if (opt_local_p(pic, st, var)) {
+      continue;
+    }
+    cell = pic_global_cell(pic, var);
+    if (pic_false_p(pic, cell->templ)) {
+      continue;
+    }
+    cell->templ = pic_false_value(pic);
+    pic_image_effect(pic, PIC_IMAGE_INLINE, var, pic_false_value(pic), pic_undef_value(pic));
+  }
+}
+
+static pic_value
+pic_optimize(pic_state *pic, pic_value expr)
+{
+  size_t ai = pic_enter(pic);
+  opt_state s, *st = &s;
+  int passes = pic->opt_passes, round;
+
+  if (passes & PIC_OPT_BETA) {
+    expr = optimize_beta(pic, expr);
+  }
+
+  /* globals set! lose their templates even with inlining off */
+  opt_begin(pic, st, expr);
+  opt_mark_assigned(pic, st);
+
+  if (passes & PIC_OPT_INLINE) {
+    expr = optimize_inline(pic, st, expr, false);
+    if (passes & PIC_OPT_BETA) {
+      expr = optimize_beta(pic, expr);
+    }
+  }
+  /*
+   * What one round leaves behind, e.g. (+ (begin (define x 2) x) 1), the
+   * next one may fold. Each round scans once; counts going stale within it
+   * only ever overstate references, which keeps dce conservative.
+   */
+  for (round = 0; round < OPT_ROUNDS; ++round) {
+    if (round > 0 || (passes & PIC_OPT_INLINE)) {
+      opt_begin(pic, st, expr);
+    }
+    if (passes & (PIC_OPT_PROPAGATE | PIC_OPT_FOLD | PIC_OPT_DCE)) {
+      expr = optimize_simplify(pic, st, expr, passes);
+    }
+    if (passes & PIC_OPT_DCE) {
+      expr = optimize_dce(pic, st, expr, false);
+    }
+  }
+
+  pic_leave(pic, ai);
+  pic_protect(pic, expr);
+  return expr;
+}
+
+int
+pic_optimize_passes(pic_state *pic, int passes)
+{
+  int old = pic->opt_passes;
+
+  if (passes >= 0) {
+    pic->opt_passes = passes & PIC_OPT_ALL;
+  }
+  return old;
+}
+
+static pic_value normalize(pic_state *pic, pic_value expr, pic_value locals, bool in);
+
+static pic_value
+normalize_body(pic_state *pic, pic_value expr, bool in)
+{
+  pic_value v, locals;
+
+  locals = pic_list(pic, 1, pic_nil_value(pic));
+
+  v = normalize(pic, expr, locals, in);
+
+  if (! in) {
+    return v;
+  }
+  return pic_list(pic, 3, S("let"), pic_car(pic, locals), v);
+}
+
+static pic_value
+normalize(pic_state *pic, pic_value expr, pic_value locals, bool in)
+{
+  pic_value proc, e, it, r;
+
+  if (! pic_list_p(pic, expr))
+    return expr;
+
+  if (! pic_pair_p(pic, expr))
+    return expr;
+
+  proc = pic_list_ref(pic, expr, 0);
+  if (pic_sym_p(pic, proc)) {
+    pic_value sym = proc;
+
+    if (EQ(sym, "define")) {
+      pic_value var, val;
+
+      var = pic_list_ref(pic, expr, 1);
+
+      if (! in) {               /* global */
+        struct cell *cell = pic_global_cell(pic, var);
+
+        if (cell->defined) {
+          pic_warnf(pic, "redefining variable: %s", pic_sym(pic, var));
+          cell->templ = pic_false_value(pic);
+        }
+        cell->defined = true;
+        cell->value = pic_invalid_value(pic);
+        pic_image_effect(pic, PIC_IMAGE_DEFINE, var, pic_undef_value(pic), pic_undef_value(pic));
+
+        val = pic_list_ref(pic, expr, 2);
+        if (! pic_false_p(pic, cell->templ) && opt_template_p(pic, var, val)) {
+          cell->templ = val;
+          pic_gc_write_barrier(pic, (struct object *)cell, val);
+          pic_image_effect(pic, PIC_IMAGE_INLINE, var, val, pic_undef_value(pic));
+        }
+      } else {                  /* local */
+        bool found = false;
+
+        pic_for_each (e, pic_car(pic, locals), it) {
+          if (pic_eq_p(pic, e, var)) {
+            pic_warnf(pic, "redefining variable: %s", pic_sym(pic, var));
+            found = true;
+            break;
+          }
+        }
+        if (! found) {
+          pic_set_car(pic, locals, pic_cons(pic, var, pic_car(pic, locals)));
+        }
+      }
+      val = normalize(pic, pic_list_ref(pic, expr, 2), locals, in);
+      return pic_list(pic, 3, S("set!"), var, val);
+    }
+    else if (EQ(sym, "lambda")) {
+      return pic_list(pic, 3, S("lambda"), pic_list_ref(pic, expr, 1), normalize_body(pic, pic_list_ref(pic, expr, 2), true));
+    }
+    else if (EQ(sym, "quote")) {
+      return expr;
+    }
+  }
+
+  r = pic_nil_value(pic);
+  pic_for_each (e, expr, it) {
+    pic_push(pic, normalize(pic, e, locals, in), r);
+  }
+  return pic_reverse(pic, r);
+}
+
+static pic_value
+pic_normalize(pic_state *pic, pic_value expr)
+{
+  return normalize_body(pic, expr, false);
+}
+
+/*
+ * Lambda lifting.
+ *
+ * A procedure bound by an internal define that is only ever called, never
+ * passed around or assigned again, need not close over its free variables:
+ * they become extra leading parameters and every call passes them along.
+ * This is done only when none of those variables is set! after it is bound,
+ * so that the copies cannot go stale. The lifted procedure then captures
+ * nothing, and the frame defining it needs no heap context on its account.
+ *
+ * Any lambda a local variable is defined to and never assigned again also
+ * gets the variable's name, as (lambda formals body name), which lets the
+ * codegen turn tail calls to itself into jumps.
+ *
+ * Lambdas handed to map, for-each or dynamic-wind are left alone: through
+ * call/cc they can be called again after the frame that made them returned.
+ */
+
+#define LIFT_MAX_PARAMS 8
+
+typedef struct lift_scope {
+  int depth;
+  pic_value free;               /* local variables bound outside */
+  struct lift_scope *up;
+} lift_scope;
+
+typedef struct lift_state {
+  pic_value depth;              /* local variable -> depth of its binder */
+  pic_value args;               /* local variables bound as arguments */
+  pic_value sets;               /* local variable -> number of set!s */
+  pic_value escapes;            /* local variables used other than called */
+  pic_value free;               /* local variable -> free variables of the
+                                   lambda it is defined to */
+  pic_value params;             /* lifted variable -> list of new params */
+} lift_state;
+
+static bool
+lift_local_p(pic_state *pic, lift_state *st, pic_value var)
+{
+  return pic_sym_p(pic, var) && pic_dict_has(pic, st->depth, var);
+}
+
+static int
+lift_depth(pic_state *pic, lift_state *st, pic_value var)
+{
+  return pic_int(pic, pic_dict_ref(pic, st->depth, var));
+}
+
+static int
+lift_sets(pic_state *pic, lift_state *st, pic_value var)
+{
+  return pic_dict_has(pic, st->sets, var) ? pic_int(pic, pic_dict_ref(pic, st->sets, var)) : 0;
+}
+
+static bool
+lift_immutable_p(pic_state *pic, lift_state *st, pic_value var)
+{
+  /* a defined variable is set! once by its own definition */
+  return lift_sets(pic, st, var) == (pic_dict_has(pic, st->args, var) ? 0 : 1);
+}
+
+/* whether var always holds the lambda it is defined to */
+static bool
+lift_known_p(pic_state *pic, lift_state *st, pic_value var)
+{
+  return pic_dict_has(pic, st->free, var) && ! pic_dict_has(pic, st->args, var) && lift_sets(pic, st, var) == 1;
+}
+
+static bool
+lift_lambda_p(pic_state *pic, pic_value obj)
+{
+  return pic_pair_p(pic, obj) && pic_sym_p(pic, pic_car(pic, obj)) && EQ(pic_car(pic, obj), "lambda");
+}
+
+static void
+lift_bind(pic_state *pic, lift_state *st, pic_value var, int depth, bool arg)
+{
+  pic_dict_set(pic, st->depth, var, pic_int_value(pic, depth));
+  if (arg) {
+    pic_dict_set(pic, st->args, var, pic_true_value(pic));
+  }
+}
+
+static void
+lift_ref(pic_state *pic, lift_state *st, lift_scope *scope, pic_value var, bool called)
+{
+  int depth;
+
+  if (! lift_local_p(pic, st, var)) {
+    return;                     /* global */
+  }
+  depth = lift_depth(pic, st, var);
+  for (; scope->depth > depth; scope = scope->up) {
+    pic_dict_set(pic, scope->free, var, pic_true_value(pic));
+  }
+  if (! called) {
+    pic_dict_set(pic, st->escapes, var, pic_true_value(pic));
+  }
+}
+
+static void lift_scan(pic_state *, lift_state *, lift_scope *, pic_value);
+
+static pic_value
+lift_scan_lambda(pic_state *pic, lift_state *st, lift_scope *up, pic_value form)
+{
+  lift_scope s, *scope = &s;
+  pic_value a, body, var, it;
+
+  scope->depth = up->depth + 1;
+  scope->free = pic_make_dict(pic);
+  scope->up = up;
+
+  for (a = pic_list_ref(pic, form, 1); pic_pair_p(pic, a); a = pic_cdr(pic, a)) {
+    lift_bind(pic, st, pic_car(pic, a), scope->depth, true);
+  }
+  if (pic_sym_p(pic, a)) {
+    lift_bind(pic, st, a, scope->depth, true);
+  }
+  body = pic_list_ref(pic, form, 2); /* (let locals body) */
+  pic_for_each (var, pic_list_ref(pic, body, 1), it) {
+    lift_bind(pic, st, var, scope->depth, false);
+  }
+  lift_scan(pic, st, scope, pic_list_ref(pic, body, 2));
+
+  return scope->free;
+}
+
+static void
+lift_scan(pic_state *pic, lift_state *st, lift_scope *scope, pic_value obj)
+{
+  size_t ai = pic_enter(pic);
+  pic_value proc, var, val, e, it;
+  int n;
+
+  if (pic_sym_p(pic, obj)) {
+    lift_ref(pic, st, scope, obj, false);
+  }
+  else if (pic_pair_p(pic, obj) && pic_list_p(pic, obj)) {
+    proc = pic_car(pic, obj);
+    if (pic_sym_p(pic, proc) && EQ(proc, "quote")) {
+      /* nothing to see */
+    }
+    else if (pic_sym_p(pic, proc) && EQ(proc, "lambda")) {
+      lift_scan_lambda(pic, st, scope, obj);
+    }
+    else if (pic_sym_p(pic, proc) && EQ(proc, "set!")) {
+      var = pic_list_ref(pic, obj, 1);
+      val = pic_list_ref(pic, obj, 2);
+      if (lift_local_p(pic, st, var)) {
+        n = lift_sets(pic, st, var) + 1;
+        pic_dict_set(pic, st->sets, var, pic_int_value(pic, n));
+        if (n == 1 && lift_lambda_p(pic, val)) {
+          pic_dict_set(pic, st->free, var, lift_scan_lambda(pic, st, scope, val));
+          goto exit;
+        }
+      }
+      lift_scan(pic, st, scope, val);
+    }
+    else if (pic_sym_p(pic, proc) && (EQ(proc, "begin") || EQ(proc, "if"))) {
+      pic_for_each (e, pic_cdr(pic, obj), it) {
+        lift_scan(pic, st, scope, e);
+      }
+    }
+    else {
+      if (pic_sym_p(pic, proc)) {
+        lift_ref(pic, st, scope, proc, true);
+      } else {
+        lift_scan(pic, st, scope, proc);
+      }
+      pic_for_each (e, pic_cdr(pic, obj), it) {
+        lift_scan(pic, st, scope, e);
+      }
+    }
+  }
+ exit:
   pic_leave(pic, ai);
-  pic_protect(pic, expr);
-  return expr;
 }
 
 static pic_value
-pic_optimize(pic_state *pic, pic_value expr)
+lift_copy(pic_state *pic, pic_value dict)
 {
-  return optimize_beta(pic, expr);
+  pic_value copy = pic_make_dict(pic), key;
+  int it = 0;
+
+  while (pic_dict_next(pic, dict, &it, &key, NULL)) {
+    pic_dict_set(pic, copy, key, pic_true_value(pic));
+  }
+  return copy;
 }
 
-static pic_value normalize(pic_state *pic, pic_value expr, pic_value locals, bool in);
+/* a lifted procedure also takes what the lifted procedures it calls take */
+static void
+lift_close(pic_state *pic, lift_state *st)
+{
+  pic_value f, fparams, h, v, more, it;
+  int i, j, depth;
+  bool changed;
+
+  do {
+    changed = false;
+    i = 0;
+    while (pic_dict_next(pic, st->params, &i, &f, &fparams)) {
+      depth = lift_depth(pic, st, f) + 1; /* of its lambda */
+      more = pic_nil_value(pic);
+      j = 0;
+      while (pic_dict_next(pic, fparams, &j, &h, NULL)) {
+        int k = 0;
+
+        if (pic_eq_p(pic, h, f) || ! pic_dict_has(pic, st->params, h)) {
+          continue;
+        }
+        while (pic_dict_next(pic, pic_dict_ref(pic, st->params, h), &k, &v, NULL)) {
+          if (lift_depth(pic, st, v) < depth && ! pic_dict_has(pic, fparams, v)) {
+            pic_push(pic, v, more);
+          }
+        }
+      }
+      pic_for_each (v, more, it) {
+        pic_dict_set(pic, fparams, v, pic_true_value(pic));
+        changed = true;
+      }
+    }
+  } while (changed);
+}
 
-static pic_value
-normalize_body(pic_state *pic, pic_value expr, bool in)
+static void
+lift_plan(pic_state *pic, lift_state *st)
 {
-  pic_value v, locals;
+  pic_value cands = pic_nil_value(pic), bad, f, params, v, it;
+  int i;
 
-  locals = pic_list(pic, 1, pic_nil_value(pic));
+  i = 0;
+  while (pic_dict_next(pic, st->free, &i, &f, NULL)) {
+    if (lift_known_p(pic, st, f) && ! pic_dict_has(pic, st->escapes, f)) {
+      pic_push(pic, f, cands);
+    }
+  }
 
-  v = normalize(pic, expr, locals, in);
+  while (true) {
+    st->params = pic_make_dict(pic);
+    pic_for_each (f, cands, it) {
+      pic_dict_set(pic, st->params, f, lift_copy(pic, pic_dict_ref(pic, st->free, f)));
+    }
+    lift_close(pic, st);
 
-  if (! in) {
-    return v;
+    /* drop those that would copy a mutable variable */
+    bad = pic_nil_value(pic);
+    i = 0;
+    while (pic_dict_next(pic, st->params, &i, &f, &params)) {
+      int j = 0;
+
+      if (pic_dict_size(pic, params) > LIFT_MAX_PARAMS) {
+        pic_push(pic, f, bad);
+        continue;
+      }
+      while (pic_dict_next(pic, params, &j, &v, NULL)) {
+        if (! lift_immutable_p(pic, st, v)) {
+          pic_push(pic, f, bad);
+          break;
+        }
+      }
+    }
+    if (pic_nil_p(pic, bad)) {
+      break;
+    }
+    pic_for_each (f, bad, it) {
+      pic_dict_del(pic, st->params, f);
+    }
+    cands = pic_nil_value(pic);
+    i = 0;
+    while (pic_dict_next(pic, st->params, &i, &f, NULL)) {
+      pic_push(pic, f, cands);
+    }
   }
-  return pic_list(pic, 3, S("let"), pic_car(pic, locals), v);
+
+  /* turn the sets into parameter lists, leaving out the already closed */
+  params = pic_make_dict(pic);
+  i = 0;
+  while (pic_dict_next(pic, st->params, &i, &f, &v)) {
+    pic_value list = pic_nil_value(pic), p;
+    int j = 0;
+
+    while (pic_dict_next(pic, v, &j, &p, NULL)) {
+      pic_push(pic, p, list);
+    }
+    if (! pic_nil_p(pic, list)) {
+      pic_dict_set(pic, params, f, list);
+    }
+  }
+  st->params = params;
 }
 
 static pic_value
-normalize(pic_state *pic, pic_value expr, pic_value locals, bool in)
+lift_rewrite(pic_state *pic, lift_state *st, pic_value obj)
 {
-  pic_value proc, e, it, r;
-
-  if (! pic_list_p(pic, expr))
-    return expr;
-
-  if (! pic_pair_p(pic, expr))
-    return expr;
-
-  proc = pic_list_ref(pic, expr, 0);
-  if (pic_sym_p(pic, proc)) {
-    pic_value sym = proc;
-
-    if (EQ(sym, "define")) {
-      pic_value var, val;
+  size_t ai = pic_enter(pic);
+  pic_value proc, var, val, formals, params, e, it, r;
 
-      var = pic_list_ref(pic, expr, 1);
+  if (! pic_pair_p(pic, obj) || ! pic_list_p(pic, obj)) {
+    return obj;
+  }
 
-      if (! in) {               /* global */
-        if (pic_weak_has(pic, pic->globals, var)) {
-          pic_warnf(pic, "redefining variable: %s", pic_sym(pic, var));
-        }
-        pic_weak_set(pic, pic->globals, var, pic_invalid_value(pic));
-      } else {                  /* local */
-        bool found = false;
+  proc = pic_car(pic, obj);
+  if (pic_sym_p(pic, proc) && EQ(proc, "quote")) {
+    return obj;
+  }
+  else if (pic_sym_p(pic, proc) && EQ(proc, "lambda")) {
+    pic_value body = pic_list_ref(pic, obj, 2);
 
-        pic_for_each (e, pic_car(pic, locals), it) {
-          if (pic_eq_p(pic, e, var)) {
-            pic_warnf(pic, "redefining variable: %s", pic_sym(pic, var));
-            found = true;
-            break;
-          }
-        }
-        if (! found) {
-          pic_set_car(pic, locals, pic_cons(pic, var, pic_car(pic, locals)));
+    body = pic_list(pic, 3, S("let"), pic_list_ref(pic, body, 1), lift_rewrite(pic, st, pic_list_ref(pic, body, 2)));
+    obj = pic_list(pic, 3, S("lambda"), pic_list_ref(pic, obj, 1), body);
+  }
+  else if (pic_sym_p(pic, proc) && EQ(proc, "set!")) {
+    var = pic_list_ref(pic, obj, 1);
+    val = lift_rewrite(pic, st, pic_list_ref(pic, obj, 2));
+    if (lift_lambda_p(pic, val) && lift_known_p(pic, st, var)) {
+      formals = pic_list_ref(pic, val, 1);
+      if (pic_dict_has(pic, st->params, var)) {
+        params = pic_dict_ref(pic, st->params, var);
+        pic_for_each (e, pic_reverse(pic, params), it) {
+          formals = pic_cons(pic, e, formals);
         }
       }
-      val = normalize(pic, pic_list_ref(pic, expr, 2), locals, in);
-      return pic_list(pic, 3, S("set!"), var, val);
+      val = pic_list(pic, 4, S("lambda"), formals, pic_list_ref(pic, val, 2), var);
     }
-    else if (EQ(sym, "lambda")) {
-      return pic_list(pic, 3, S("lambda"), pic_list_ref(pic, expr, 1), normalize_body(pic, pic_list_ref(pic, expr, 2), true));
+    obj = pic_list(pic, 3, S("set!"), var, val);
+  }
+  else {
+    r = pic_nil_value(pic);
+    pic_for_each (e, obj, it) {
+      pic_push(pic, lift_rewrite(pic, st, e), r);
     }
-    else if (EQ(sym, "quote")) {
-      return expr;
+    r = pic_reverse(pic, r);
+    if (pic_sym_p(pic, proc) && pic_dict_has(pic, st->params, proc)) {
+      r = pic_cons(pic, proc, pic_append(pic, pic_dict_ref(pic, st->params, proc), pic_cdr(pic, r)));
     }
+    obj = r;
   }
 
-  r = pic_nil_value(pic);
-  pic_for_each (e, expr, it) {
-    pic_push(pic, normalize(pic, e, locals, in), r);
-  }
-  return pic_reverse(pic, r);
+  pic_leave(pic, ai);
+  pic_protect(pic, obj);
+  return obj;
 }
 
 static pic_value
-pic_normalize(pic_state *pic, pic_value expr)
+pic_lift(pic_state *pic, pic_value obj)
 {
-  return normalize_body(pic, expr, false);
+  lift_state s, *st = &s;
+  lift_scope top;
+
+  st->depth = pic_make_dict(pic);
+  st->args = pic_make_dict(pic);
+  st->sets = pic_make_dict(pic);
+  st->escapes = pic_make_dict(pic);
+  st->free = pic_make_dict(pic);
+
+  top.depth = 0;
+  top.free = pic_make_dict(pic);
+  top.up = NULL;
+
+  lift_scan(pic, st, &top, obj);
+  lift_plan(pic, st);
+
+  if (pic_dict_size(pic, st->free) == 0) {
+    return obj;                 /* nothing to lift or name */
+  }
+  return lift_rewrite(pic, st, obj);
 }
 
 typedef struct analyze_scope {
@@ -460,18 +1459,19 @@ static pic_value
 analyze_lambda(pic_state *pic, analyze_scope *up, pic_value form)
 {
   analyze_scope s, *scope = &s;
-  pic_value body, args, locals;
+  pic_value body, args, locals, name;
 
   args = pic_list_ref(pic, form, 1);
   locals = pic_list_ref(pic, pic_list_ref(pic, form, 2), 1);
   body = pic_list_ref(pic, pic_list_ref(pic, form, 2), 2);
+  name = pic_length(pic, form) > 3 ? pic_list_ref(pic, form, 3) : pic_false_value(pic);
 
   analyzer_scope_init(pic, scope, args, locals, up);
 
   /* analyze body */
   body = analyze(pic, scope, body);
 
-  return pic_list(pic, 5, S("lambda"), args, locals, scope->captures, body);
+  return pic_list(pic, 6, S("lambda"), args, locals, scope->captures, body, name);
 }
 
 static pic_value
@@ -513,7 +1513,7 @@ analyze_node(pic_state *pic, analyze_scope *scope, pic_value obj)
       if (EQ(sym, "lambda")) {
         return analyze_lambda(pic, scope, obj);
       }
-      else if (EQ(sym, "quote")) {
+      else if (EQ(sym, "quote") || EQ(sym, "inlinable?")) {
         return obj;
       }
       else if (EQ(sym, "begin") || EQ(sym, "set!") || EQ(sym, "if")) {
@@ -558,19 +1558,24 @@ typedef struct codegen_context {
   pic_value rest;
   pic_value args, locals, captures;
   /* actual bit code sequence */
-  struct code *code;
+  pic_code *code;
   size_t clen, ccapa;
+  size_t last;                  /* start of the last instruction */
+  size_t label;                 /* latest jump target */
   /* child ireps */
   struct irep **irep;
   size_t ilen, icapa;
   /* constant object pool */
-  int *ints;
-  size_t klen, kcapa;
   double *nums;
   size_t flen, fcapa;
   struct object **pool;
   size_t plen, pcapa;
 
+  /* refers to no variable of an outer frame */
+  bool closed;
+  /* variable always holding this procedure, or #f */
+  pic_value self;
+
   struct codegen_context *up;
 } codegen_context;
 
@@ -611,10 +1616,13 @@ codegen_context_init(pic_state *pic, codegen_context *cxt, codegen_context *up,
   }
 
   cxt->up = up;
+  cxt->closed = true;
+  cxt->self = pic_false_value(pic);
 
-  cxt->code = pic_calloc(pic, PIC_ISEQ_SIZE, sizeof(struct code));
+  cxt->code = pic_calloc(pic, PIC_ISEQ_SIZE, sizeof(pic_code));
   cxt->clen = 0;
   cxt->ccapa = PIC_ISEQ_SIZE;
+  cxt->last = cxt->label = 0;
 
   cxt->irep = pic_calloc(pic, PIC_IREP_SIZE, sizeof(struct irep *));
   cxt->ilen = 0;
@@ -624,10 +1632,6 @@ codegen_context_init(pic_state *pic, codegen_context *cxt, codegen_context *up,
   cxt->plen = 0;
   cxt->pcapa = PIC_POOL_SIZE;
 
-  cxt->ints = pic_calloc(pic, PIC_POOL_SIZE, sizeof(int));
-  cxt->klen = 0;
-  cxt->kcapa = PIC_POOL_SIZE;
-
   cxt->nums = pic_calloc(pic, PIC_POOL_SIZE, sizeof(double));
   cxt->flen = 0;
   cxt->fcapa = PIC_POOL_SIZE;
@@ -648,14 +1652,12 @@ codegen_context_destroy(pic_state *pic, codegen_context *cxt)
   irep->argc = pic_vec_len(pic, cxt->args) + 1;
   irep->localc = pic_vec_len(pic, cxt->locals);
   irep->capturec = pic_vec_len(pic, cxt->captures);
-  irep->code = pic_realloc(pic, cxt->code, sizeof(struct code) * cxt->clen);
+  irep->code = pic_realloc(pic, cxt->code, sizeof(pic_code) * cxt->clen);
   irep->irep = pic_realloc(pic, cxt->irep, sizeof(struct irep *) * cxt->ilen);
-  irep->ints = pic_realloc(pic, cxt->ints, sizeof(int) * cxt->klen);
   irep->nums = pic_realloc(pic, cxt->nums, sizeof(double) * cxt->flen);
   irep->pool = pic_realloc(pic, cxt->pool, sizeof(struct object *) * cxt->plen);
   irep->ncode = cxt->clen;
   irep->nirep = cxt->ilen;
-  irep->nints = cxt->klen;
   irep->nnums = cxt->flen;
   irep->npool = cxt->plen;
 
@@ -676,58 +1678,139 @@ codegen_context_destroy(pic_state *pic, codegen_context *cxt)
     }                                                                   \
   } while (0)
 
-#define check_code_size(pic, cxt) check_size(pic, cxt, c, code, struct code)
+#define check_code_size(pic, cxt) check_size(pic, cxt, c, code, pic_code)
 #define check_irep_size(pic, cxt) check_size(pic, cxt, i, irep, struct irep *)
 #define check_pool_size(pic, cxt) check_size(pic, cxt, p, pool, struct object *)
-#define check_ints_size(pic, cxt) check_size(pic, cxt, k, ints, int)
 #define check_nums_size(pic, cxt) check_size(pic, cxt, f, nums, double)
 
-#define emit_n(pic, cxt, ins) do {              \
-    check_code_size(pic, cxt);                  \
-    cxt->code[cxt->clen].insn = ins;            \
-    cxt->clen++;                                \
-  } while (0)                                   \
-
-#define emit_i(pic, cxt, ins, I) do {           \
-    check_code_size(pic, cxt);                  \
-    cxt->code[cxt->clen].insn = ins;            \
-    cxt->code[cxt->clen].a = I;                 \
-    cxt->clen++;                                \
-  } while (0)                                   \
-
-#define emit_r(pic, cxt, ins, D, I) do {        \
-    check_code_size(pic, cxt);                  \
-    cxt->code[cxt->clen].insn = ins;            \
-    cxt->code[cxt->clen].a = D;                 \
-    cxt->code[cxt->clen].b = I;                 \
-    cxt->clen++;                                \
-  } while (0)                                   \
+static void
+emit_byte(pic_state *pic, codegen_context *cxt, int b)
+{
+  check_code_size(pic, cxt);
+  cxt->code[cxt->clen++] = (pic_code)b;
+}
 
-#define emit_ret(pic, cxt, tailpos) if (tailpos) emit_n(pic, cxt, OP_RET)
+static void
+emit_int32(pic_state *pic, codegen_context *cxt, int i)
+{
+  pic_code buf[4];
+  int j;
 
-struct {
-  const char *name;
-  int insn;
-  int argc;
-} pic_vm_proc[] = {
-  { "picrin.base/cons", OP_CONS, 2 },
-  { "picrin.base/car", OP_CAR, 1 },
-  { "picrin.base/cdr", OP_CDR, 1 },
-  { "picrin.base/null?", OP_NILP, 1 },
-  { "picrin.base/symbol?", OP_SYMBOLP, 1 },
-  { "picrin.base/pair?", OP_PAIRP, 1 },
-  { "picrin.base/not", OP_NOT, 1 },
-  { "picrin.base/=", OP_EQ, 2 },
-  { "picrin.base/<", OP_LT, 2 },
-  { "picrin.base/<=", OP_LE, 2 },
-  { "picrin.base/>", OP_GT, 2 },
-  { "picrin.base/>=", OP_GE, 2 },
-  { "picrin.base/+", OP_ADD, 2 },
-  { "picrin.base/-", OP_SUB, 2 },
-  { "picrin.base/*", OP_MUL, 2 },
-  { "picrin.base//", OP_DIV, 2 }
+  pic_code_put_int32(buf, i);
+  for (j = 0; j < 4; ++j) {
+    emit_byte(pic, cxt, buf[j]);
+  }
+}
+
+static void
+emit_operand(pic_state *pic, codegen_context *cxt, int i)
+{
+  if (0 <= i && i < PIC_CODE_WIDE) {
+    emit_byte(pic, cxt, i);
+  } else {
+    emit_byte(pic, cxt, PIC_CODE_WIDE);
+    emit_int32(pic, cxt, i);
+  }
+}
+
+static void
+emit_insn(pic_state *pic, codegen_context *cxt, int insn)
+{
+  cxt->last = cxt->clen;
+  emit_byte(pic, cxt, insn);
+}
+
+/* turn the last instruction, if it is a prev, into a superinstruction */
+static bool
+emit_fused(codegen_context *cxt, int prev, int insn)
+{
+  if (cxt->label == cxt->clen || cxt->code[cxt->last] != prev) {
+    return false;               /* a jump lands between the two */
+  }
+  cxt->code[cxt->last] = (pic_code)insn;
+  return true;
+}
+
+static const int superinsns[][3] = {
+  { OP_LREF, OP_CAR, OP_LCAR },
+  { OP_LREF, OP_CDR, OP_LCDR },
+  { OP_LSET, OP_POP, OP_LPOP },
+  { OP_LREF, OP_RET, OP_LRET },
+  { OP_PUSHINT, OP_ADD, OP_ADDI },
+  { OP_PUSHINT, OP_SUB, OP_SUBI },
+  { OP_NOT, OP_JMPIF, OP_JMPNOT },
+  { OP_NILP, OP_JMPIF, OP_JMPNILP },
+  { OP_PAIRP, OP_JMPIF, OP_JMPPAIRP },
+  { OP_EQ, OP_JMPIF, OP_JMPEQ },
+  { OP_LT, OP_JMPIF, OP_JMPLT },
+  { OP_LE, OP_JMPIF, OP_JMPLE },
+  { OP_GT, OP_JMPIF, OP_JMPGT },
+  { OP_GE, OP_JMPIF, OP_JMPGE },
+  { OP_EQP, OP_JMPIF, OP_JMPEQP },
+  { OP_PUSHCONST, OP_CALL, OP_CCALL },
+  { OP_LREF, OP_TAILCALL, OP_LTAILCALL }
 };
 
+static void
+emit_n(pic_state *pic, codegen_context *cxt, int insn)
+{
+  size_t i;
+
+  for (i = 0; i < sizeof superinsns / sizeof superinsns[0]; ++i) {
+    if (superinsns[i][1] == insn && emit_fused(cxt, superinsns[i][0], superinsns[i][2])) {
+      return;
+    }
+  }
+  emit_insn(pic, cxt, insn);
+}
+
+static void
+emit_i(pic_state *pic, codegen_context *cxt, int insn, int i)
+{
+  emit_n(pic, cxt, insn);
+  emit_operand(pic, cxt, i);
+}
+
+static void
+emit_r(pic_state *pic, codegen_context *cxt, int insn, int d, int i)
+{
+  emit_insn(pic, cxt, insn);
+  emit_operand(pic, cxt, d);
+  emit_operand(pic, cxt, i);
+}
+
+/* returns where to patch the offset once the target is known */
+static size_t
+emit_jmp(pic_state *pic, codegen_context *cxt, int insn)
+{
+  size_t pos;
+
+  emit_n(pic, cxt, insn);
+  pos = cxt->clen;
+  emit_int32(pic, cxt, 0);
+  return pos;
+}
+
+/* jump back to the instruction at target */
+static void
+emit_loop(pic_state *pic, codegen_context *cxt, size_t target)
+{
+  size_t pos;
+
+  pos = emit_jmp(pic, cxt, OP_JMP);
+  pic_code_put_int32(cxt->code + pos, (int)target - (int)(pos + 4));
+}
+
+/* make the jump at pos land on the next instruction emitted */
+static void
+emit_label(codegen_context *cxt, size_t pos)
+{
+  pic_code_put_int32(cxt->code + pos, (int)(cxt->clen - (pos + 4)));
+  cxt->label = cxt->clen;
+}
+
+#define emit_ret(pic, cxt, tailpos) if (tailpos) emit_n(pic, cxt, OP_RET)
+
 static int
 index_capture(pic_state *pic, codegen_context *cxt, pic_value sym, int depth)
 {
@@ -769,7 +1852,7 @@ index_global(pic_state *pic, codegen_context *cxt, pic_value name)
 
   check_pool_size(pic, cxt);
   pidx = (int)cxt->plen++;
-  cxt->pool[pidx] = (struct object *)pic_sym_ptr(pic, name);
+  cxt->pool[pidx] = (struct object *)pic_global_cell(pic, name);
 
   return pidx;
 }
@@ -795,6 +1878,16 @@ create_activation(pic_state *pic, codegen_context *cxt)
 
 static void codegen(pic_state *, codegen_context *, pic_value, bool);
 
+/* frames reaching depth frames up need their contexts */
+static void
+codegen_open(codegen_context *cxt, int depth)
+{
+  while (depth-- > 0) {
+    cxt->closed = false;
+    cxt = cxt->up;
+  }
+}
+
 static void
 codegen_ref(pic_state *pic, codegen_context *cxt, pic_value obj, bool tailpos)
 {
@@ -814,6 +1907,7 @@ codegen_ref(pic_state *pic, codegen_context *cxt, pic_value obj, bool tailpos)
 
     depth = pic_int(pic, pic_list_ref(pic, obj, 1));
     name  = pic_list_ref(pic, obj, 2);
+    codegen_open(cxt, depth);
     emit_r(pic, cxt, OP_CREF, depth, index_capture(pic, cxt, name, depth));
     emit_ret(pic, cxt, tailpos);
   }
@@ -832,6 +1926,14 @@ codegen_ref(pic_state *pic, codegen_context *cxt, pic_value obj, bool tailpos)
   }
 }
 
+/* whether the global still has the template its calls were inlined with */
+static void
+codegen_inlinable(pic_state *pic, codegen_context *cxt, pic_value obj, bool tailpos)
+{
+  emit_i(pic, cxt, OP_GTEMPL, index_global(pic, cxt, pic_list_ref(pic, obj, 1)));
+  emit_ret(pic, cxt, tailpos);
+}
+
 static void
 codegen_set(pic_state *pic, codegen_context *cxt, pic_value obj, bool tailpos)
 {
@@ -863,6 +1965,7 @@ codegen_set(pic_state *pic, codegen_context *cxt, pic_value obj, bool tailpos)
 
     depth = pic_int(pic, pic_list_ref(pic, var, 1));
     name  = pic_list_ref(pic, var, 2);
+    codegen_open(cxt, depth);
     emit_r(pic, cxt, OP_CSET, depth, index_capture(pic, cxt, name, depth));
     emit_ret(pic, cxt, tailpos);
   }
@@ -897,37 +2000,39 @@ codegen_lambda(pic_state *pic, codegen_context *cxt, pic_value obj, bool tailpos
 
   /* emit irep */
   codegen_context_init(pic, inner_cxt, cxt, args, locals, captures);
+  inner_cxt->self = pic_list_ref(pic, obj, 5);
   codegen(pic, inner_cxt, body, true);
   cxt->irep[cxt->ilen] = codegen_context_destroy(pic, inner_cxt);
 
-  /* emit OP_LAMBDA */
-  emit_i(pic, cxt, OP_LAMBDA, cxt->ilen++);
+  /* emit OP_LAMBDA, or OP_PROC if there is nothing to close over */
+  emit_i(pic, cxt, inner_cxt->closed ? OP_PROC : OP_LAMBDA, cxt->ilen++);
   emit_ret(pic, cxt, tailpos);
 }
 
 static void
 codegen_if(pic_state *pic, codegen_context *cxt, pic_value obj, bool tailpos)
 {
-  int s, t;
+  size_t s, t = 0;
 
   codegen(pic, cxt, pic_list_ref(pic, obj, 1), false);
 
-  s = (int)cxt->clen;
-
-  emit_n(pic, cxt, OP_JMPIF);
+  s = emit_jmp(pic, cxt, OP_JMPIF);
 
   /* if false branch */
   codegen(pic, cxt, pic_list_ref(pic, obj, 3), tailpos);
 
-  t = (int)cxt->clen;
-
-  emit_n(pic, cxt, OP_JMP);
+  if (! tailpos) {              /* otherwise the branch has returned */
+    t = emit_jmp(pic, cxt, OP_JMP);
+  }
 
-  cxt->code[s].a = (int)cxt->clen - s;
+  emit_label(cxt, s);
 
   /* if true branch */
   codegen(pic, cxt, pic_list_ref(pic, obj, 2), tailpos);
-  cxt->code[t].a = (int)cxt->clen - t;
+
+  if (! tailpos) {
+    emit_label(cxt, t);
+  }
 }
 
 static void
@@ -955,10 +2060,7 @@ codegen_quote(pic_state *pic, codegen_context *cxt, pic_value obj, bool tailpos)
     emit_n(pic, cxt, OP_PUSHFALSE);
     break;
   case PIC_TYPE_INT:
-    check_ints_size(pic, cxt);
-    pidx = (int)cxt->klen++;
-    cxt->ints[pidx] = pic_int(pic, obj);
-    emit_i(pic, cxt, OP_PUSHINT, pidx);
+    emit_i(pic, cxt, OP_PUSHINT, pic_int(pic, obj));
     break;
   case PIC_TYPE_FLOAT:
     check_nums_size(pic, cxt);
@@ -973,10 +2075,7 @@ codegen_quote(pic_state *pic, codegen_context *cxt, pic_value obj, bool tailpos)
     emit_n(pic, cxt, OP_PUSHEOF);
     break;
   case PIC_TYPE_CHAR:
-    check_ints_size(pic, cxt);
-    pidx = (int)cxt->klen++;
-    cxt->ints[pidx] = pic_char(pic, obj);
-    emit_i(pic, cxt, OP_PUSHCHAR, pidx);
+    emit_i(pic, cxt, OP_PUSHCHAR, (unsigned char)pic_char(pic, obj));
     break;
   default:
     assert(pic_obj_p(pic,obj));
@@ -989,28 +2088,121 @@ codegen_quote(pic_state *pic, codegen_context *cxt, pic_value obj, bool tailpos)
   emit_ret(pic, cxt, tailpos);
 }
 
+/*
+ * A tail call of a procedure to itself reuses its frame: the arguments are
+ * stored over the old ones and control jumps back to the start. Arguments
+ * passed on unchanged are left where they are. A frame whose variables are
+ * captured cannot be reused, as every call must have fresh bindings.
+ */
+static bool
+codegen_loop(pic_state *pic, codegen_context *cxt, pic_value obj)
+{
+  pic_value functor, elt, it, args;
+  int i, argc;
+
+  functor = pic_list_ref(pic, obj, 1);
+  if (! (EQ(pic_car(pic, functor), "lref") || EQ(pic_car(pic, functor), "cref"))) {
+    return false;
+  }
+  if (! pic_eq_p(pic, pic_list_ref(pic, functor, pic_length(pic, functor) - 1), cxt->self)) {
+    return false;
+  }
+  argc = pic_vec_len(pic, cxt->args);
+  if (pic_vec_len(pic, cxt->captures) != 0 || pic_sym_p(pic, cxt->rest) || pic_length(pic, obj) != argc + 2) {
+    return false;
+  }
+
+  args = pic_nil_value(pic);
+  i = 0;
+  pic_for_each (elt, pic_cddr(pic, obj), it) {
+    pic_value var = pic_vec_ref(pic, cxt->args, i++);
+
+    if (EQ(pic_car(pic, elt), "lref") && pic_eq_p(pic, pic_list_ref(pic, elt, 1), var)) {
+      continue;
+    }
+    codegen(pic, cxt, elt, false);
+    pic_push(pic, var, args);
+  }
+  pic_for_each (elt, args, it) {
+    emit_i(pic, cxt, OP_LSET, index_local(pic, cxt, elt));
+    emit_n(pic, cxt, OP_POP);
+  }
+  emit_loop(pic, cxt, 0);
+  return true;
+}
+
+static bool
+codegen_simple_p(pic_state *pic, pic_value obj)
+{
+  return EQ(pic_car(pic, obj), "lref") || EQ(pic_car(pic, obj), "cref") || EQ(pic_car(pic, obj), "quote");
+}
+
+/*
+ * (+ a b c) is compiled as (+ (+ a b) c), and likewise for *. Comparisons
+ * become (if (< a b) (< b c) #f) when every argument but the first can be
+ * evaluated twice, or skipped, without anyone noticing.
+ */
+static bool
+codegen_nary(pic_state *pic, codegen_context *cxt, pic_value obj, bool tailpos)
+{
+  pic_value functor = pic_list_ref(pic, obj, 1), args = pic_cddr(pic, obj), call, elt, it;
+  int i = vm_proc_index(pic, pic_list_ref(pic, functor, 1), 2);
+
+  if (i < 0) {
+    return false;
+  }
+  switch (pic_vm_proc[i].insn) {
+  case OP_ADD: case OP_MUL:
+    call = pic_car(pic, args);
+    pic_for_each (elt, pic_cdr(pic, args), it) {
+      call = pic_list(pic, 4, S("call"), functor, call, elt);
+    }
+    break;
+  case OP_EQ: case OP_LT: case OP_LE: case OP_GT: case OP_GE:
+    pic_for_each (elt, pic_cdr(pic, args), it) {
+      if (! codegen_simple_p(pic, elt)) {
+        return false;
+      }
+    }
+    args = pic_reverse(pic, args);
+    call = pic_list(pic, 4, S("call"), functor, pic_cadr(pic, args), pic_car(pic, args));
+    for (args = pic_cdr(pic, args); pic_pair_p(pic, pic_cdr(pic, args)); args = pic_cdr(pic, args)) {
+      pic_value test = pic_list(pic, 4, S("call"), functor, pic_cadr(pic, args), pic_car(pic, args));
+
+      call = pic_list(pic, 4, S("if"), test, call, pic_list(pic, 2, S("quote"), pic_false_value(pic)));
+    }
+    break;
+  default:
+    return false;
+  }
+  codegen(pic, cxt, call, tailpos);
+  return true;
+}
+
 static void
 codegen_call(pic_state *pic, codegen_context *cxt, pic_value obj, bool tailpos)
 {
   int len = pic_length(pic, obj);
   pic_value elt, it, functor;
 
+  if (tailpos && pic_sym_p(pic, cxt->self) && codegen_loop(pic, cxt, obj)) {
+    return;
+  }
+
   functor = pic_list_ref(pic, obj, 1);
   if (EQ(pic_list_ref(pic, functor, 0), "gref")) {
-    pic_value sym;
-    size_t i;
-
-    sym = pic_list_ref(pic, functor, 1);
+    int i = vm_proc_index(pic, pic_list_ref(pic, functor, 1), len - 2);
 
-    for (i = 0; i < sizeof pic_vm_proc / sizeof pic_vm_proc[0]; ++i) {
-      if (EQ(sym, pic_vm_proc[i].name) && len == pic_vm_proc[i].argc + 2) {
-        pic_for_each (elt, pic_cddr(pic, obj), it) {
-          codegen(pic, cxt, elt, false);
-        }
-        emit_n(pic, cxt, pic_vm_proc[i].insn);
-        emit_ret(pic, cxt, tailpos);
-        return;
+    if (i >= 0) {
+      pic_for_each (elt, pic_cddr(pic, obj), it) {
+        codegen(pic, cxt, elt, false);
       }
+      emit_n(pic, cxt, pic_vm_proc[i].insn);
+      emit_ret(pic, cxt, tailpos);
+      return;
+    }
+    if (len > 4 && codegen_nary(pic, cxt, obj, tailpos)) {
+      return;
     }
   }
 
@@ -1047,6 +2239,9 @@ codegen(pic_state *pic, codegen_context *cxt, pic_value obj, bool tailpos)
   else if (EQ(sym, "call")) {
     codegen_call(pic, cxt, obj, tailpos);
   }
+  else if (EQ(sym, "inlinable?")) {
+    codegen_inlinable(pic, cxt, obj, tailpos);
+  }
   else {
     pic_error(pic, "codegen: unknown AST type", 1, obj);
   }
@@ -1093,6 +2288,16 @@ pic_compile(pic_state *pic, pic_value obj)
 
   SAVE(pic, ai, obj);
 
+  /* lambda lifting */
+  if (pic->opt_passes & PIC_OPT_LIFT) {
+    obj = pic_lift(pic, obj);
+  }
+#if 0
+  pic_printf(pic, "## lambda lifting completed\n~s\n", obj);
+#endif
+
+  SAVE(pic, ai, obj);
+
   /* analyze */
   obj = pic_analyze(pic, obj);
 #if 0
@@ -1115,18 +2320,25 @@ pic_value
 pic_eval(pic_state *pic, pic_value program, const char *lib)
 {
   const char *prev_lib = pic_current_library(pic);
-  pic_value env, r, e;
+  pic_value env, proc, r, e;
 
   env = pic_library_environment(pic, lib);
 
   pic_in_library(pic, lib);
   pic_try {
-    r = pic_call(pic, pic_compile(pic, pic_expand(pic, program, env)), 0);
+    proc = pic_image_enter(pic, program, lib); /* precompiled by a bytecode image? */
+    if (pic_false_p(pic, proc)) {
+      proc = pic_compile(pic, pic_expand(pic, program, env));
+      pic_image_prepared(pic, proc);
+    }
+    r = pic_call(pic, proc, 0);
   }
   pic_catch(e) {
+    pic_image_leave(pic);
     pic_in_library(pic, prev_lib);
     pic_raise(pic, e);
   }
+  pic_image_leave(pic);
   pic_in_library(pic, prev_lib);
 
   return r;
@@ -19,6 +19,7 @@ struct object {
   union {
     struct basic basic;
     struct identifier id;
+    struct symbol sym;
     struct string str;
     struct blob blob;
     struct pair pair;
@@ -33,17 +34,83 @@ struct object {
     struct port port;
     struct error err;
     struct checkpoint cp;
+    struct cell cell;
   } u;
 };
 
-#if !PIC_BITMAP_GC
+struct objstack {
+  struct object **objs;
+  size_t len, size;
+};
 
-struct heap {
-  union header base, *freep;
-  struct heap_page *pages;
-  struct weak *weaks;           /* weak map chain */
+/*
+ * Weak map entries are ephemerons: the value is kept alive only by the
+ * key. When a weak map is scanned, the value of each entry whose key is
+ * already marked gets marked too; every other entry is queued on its key
+ * and woken when the key is scanned. Entries still queued when marking
+ * ends have dead keys, and exactly those are removed from their maps.
+ */
+
+#define NO_EPHEMERON ((size_t)-1)
+
+struct ephemeron {
+  struct object *key;           /* NULL once woken */
+  struct weak *weak;
+  pic_value val;
+  size_t next;                  /* next entry queued on the same key */
 };
 
+KHASH_DECLARE(waiting, struct object *, size_t)
+KHASH_DEFINE(waiting, struct object *, size_t, kh_ptr_hash_func, kh_ptr_hash_equal)
+
+#if PIC_GENERATIONAL_GC
+
+/*
+ * The generational collector does not move objects, since C code holds
+ * raw object pointers everywhere. Instead every object that survives a
+ * collection is promoted in place: it keeps its mark (the sticky mark
+ * bit), so a minor collection stops tracing as soon as it reaches an old
+ * object and only sweeps what was allocated since the last collection.
+ * Old objects that are made to point to young ones are recorded in the
+ * remembered set by the write barrier and rescanned by the next minor
+ * collection.
+ */
+
+#endif
+
+#if PIC_INCREMENTAL_GC
+
+/*
+ * In incremental mode a collection cycle is spread over allocations.
+ * Marked objects are black once their fields are traced and gray while
+ * they wait in the gray stack; each allocation traces at most `budget'
+ * gray objects. The write barrier shades whatever is stored into a
+ * marked object, and the final (atomic) step rescans the roots, which
+ * have no barrier. Objects allocated during marking start white and
+ * survive only if that rescan reaches them. Pages are then swept one per
+ * allocation.
+ */
+
+enum {
+  GC_IDLE,
+  GC_MARK,
+  GC_SWEEP
+};
+
+#endif
+
+#if !PIC_BITMAP_GC
+
+/*
+ * Free blocks of up to SMALL_UNITS units are kept in exact-size lists, so
+ * allocating a pair or a small closure is a single pop. Larger blocks go
+ * to a first-fit list, and allocation carves new small blocks off their
+ * tail. A block is in use iff its ptr field points to itself; the sweep
+ * walks each page linearly and rebuilds all the lists.
+ */
+
+#define SMALL_UNITS 16
+
 struct heap_page {
   struct heap_page *next;
   union header basep[1];
@@ -51,11 +118,6 @@ struct heap_page {
 
 #else
 
-struct heap {
-  struct heap_page *pages;
-  struct weak *weaks;           /* weak map chain */
-};
-
 #define UNIT_SIZE (sizeof(uint32_t) * CHAR_BIT)
 #define BITMAP_SIZE (PIC_HEAP_PAGE_SIZE / sizeof(union header) / UNIT_SIZE)
 
@@ -64,11 +126,66 @@ struct heap_page {
   size_t freep;
   uint32_t bitmap[BITMAP_SIZE];
   uint32_t shadow[BITMAP_SIZE];
+#if PIC_GENERATIONAL_GC
+  uint32_t old[BITMAP_SIZE];    /* objects that survived the last collection */
+#endif
   union header basep[1];
 };
 
 #endif
 
+struct heap {
+#if !PIC_BITMAP_GC
+  union header *freep[SMALL_UNITS + 1]; /* free blocks by size in units */
+  union header *large;          /* free blocks larger than SMALL_UNITS */
+#endif
+  struct heap_page *pages;
+  struct weak *weaks;           /* weak map chain */
+  struct {
+    struct ephemeron *entries;
+    size_t len, size;
+  } ephemerons;                 /* weak map entries with unmarked keys */
+  khash_t(waiting) waiting;     /* first queued entry of each key */
+  struct objstack gray;         /* marked objects whose fields are not traced yet */
+  int budget;                   /* objects traced per allocation step */
+  struct pic_gc_stats stats;
+  pic_gcf hook;                 /* called after each collection */
+  double pause;                 /* clock at the start of the current pause */
+  bool collected;               /* a collection ended during the current pause */
+#if PIC_GENERATIONAL_GC || PIC_INCREMENTAL_GC
+  struct objstack datas;        /* data objects with a mark function */
+#endif
+#if PIC_GENERATIONAL_GC
+  struct objstack remembered;   /* old objects pointing to young ones */
+  size_t old_limit;             /* old generation size forcing a major GC */
+  bool major;                   /* is the next collection a major one? */
+#endif
+#if PIC_INCREMENTAL_GC
+  int phase;
+  struct heap_page *sweep;      /* next page to sweep */
+  size_t inuse, total;          /* units seen by the sweep so far */
+  size_t debt;                  /* units allocated since the last cycle */
+  size_t threshold;             /* debt that starts the next cycle */
+#endif
+};
+
+static void
+objstack_init(struct objstack *stack)
+{
+  stack->objs = NULL;
+  stack->len = stack->size = 0;
+}
+
+static void
+objstack_push(pic_state *pic, struct objstack *stack, struct object *obj)
+{
+  if (stack->len >= stack->size) {
+    stack->size = stack->size * 2 + 1;
+    stack->objs = pic_realloc(pic, stack->objs, sizeof(struct object *) * stack->size);
+  }
+  stack->objs[stack->len++] = obj;
+}
+
 struct heap *
 pic_heap_open(pic_state *pic)
 {
@@ -77,13 +194,41 @@ pic_heap_open(pic_state *pic)
   heap = pic_malloc(pic, sizeof(struct heap));
 
 #if !PIC_BITMAP_GC
-  heap->base.s.ptr = &heap->base;
-  heap->base.s.size = 0; /* not 1, since it must never be used for allocation */
-  heap->freep = &heap->base;
+  {
+    int i;
+
+    for (i = 0; i <= SMALL_UNITS; ++i) {
+      heap->freep[i] = NULL;
+    }
+    heap->large = NULL;
+  }
 #endif
 
   heap->pages = NULL;
   heap->weaks = NULL;
+  heap->ephemerons.entries = NULL;
+  heap->ephemerons.len = heap->ephemerons.size = 0;
+  kh_init(waiting, &heap->waiting);
+  objstack_init(&heap->gray);
+  heap->budget = PIC_GC_BUDGET;
+  memset(&heap->stats, 0, sizeof(heap->stats));
+  heap->hook = NULL;
+  heap->collected = false;
+
+#if PIC_GENERATIONAL_GC || PIC_INCREMENTAL_GC
+  objstack_init(&heap->datas);
+#endif
+#if PIC_GENERATIONAL_GC
+  objstack_init(&heap->remembered);
+  heap->old_limit = 0;
+  heap->major = false;
+#endif
+#if PIC_INCREMENTAL_GC
+  heap->phase = GC_IDLE;
+  heap->sweep = NULL;
+  heap->inuse = heap->total = 0;
+  heap->debt = heap->threshold = 0;
+#endif
 
   return heap;
 }
@@ -98,6 +243,15 @@ pic_heap_close(pic_state *pic, struct heap *heap)
     heap->pages = heap->pages->next;
     pic_free(pic, page);
   }
+  pic_free(pic, heap->ephemerons.entries);
+  kh_destroy(waiting, &heap->waiting);
+  pic_free(pic, heap->gray.objs);
+#if PIC_GENERATIONAL_GC || PIC_INCREMENTAL_GC
+  pic_free(pic, heap->datas.objs);
+#endif
+#if PIC_GENERATIONAL_GC
+  pic_free(pic, heap->remembered.objs);
+#endif
   pic_free(pic, heap);
 }
 
@@ -212,6 +366,22 @@ mark(pic_state *PIC_UNUSED(pic), struct object *obj)
   obj->u.basic.gc_mark = 1;
 }
 
+#if PIC_GENERATIONAL_GC
+
+static void
+unmark(pic_state *PIC_UNUSED(pic), struct object *obj)
+{
+  obj->u.basic.gc_mark = 0;
+}
+
+static bool
+is_old(pic_state *PIC_UNUSED(pic), struct object *obj)
+{
+  return obj->u.basic.gc_mark == 1; /* marks are kept between collections */
+}
+
+#endif
+
 #else
 
 static union header *
@@ -237,7 +407,7 @@ popcount32(uint32_t bits)
 }
 
 static void
-mark_at(struct heap_page *page, size_t index, size_t size)
+mark_at(uint32_t *bitmap, size_t index, size_t size)
 {
   size_t mark_size;
 
@@ -246,7 +416,7 @@ mark_at(struct heap_page *page, size_t index, size_t size)
       mark_size = size;
     else
       mark_size = UNIT_SIZE - (index % UNIT_SIZE);
-    page->bitmap[index / UNIT_SIZE] |= ~(-1 << mark_size) << (index % UNIT_SIZE);
+    bitmap[index / UNIT_SIZE] |= ~(-1 << mark_size) << (index % UNIT_SIZE);
     size  -= mark_size;
     index += mark_size;
   }
@@ -295,12 +465,52 @@ mark(pic_state *pic, struct object *obj)
   page = obj2page(pic, h);
   index = h - page->basep;
 
-  mark_at(page, index, h->s.size);
+  mark_at(page->bitmap, index, h->s.size);
+}
+
+#if PIC_GENERATIONAL_GC
+
+static void
+unmark(pic_state *pic, struct object *obj)
+{
+  union header *h = ((union header *)obj) - 1;
+  struct heap_page *page;
+  size_t index, end;
+
+  page = obj2page(pic, h);
+  index = h - page->basep;
+
+  for (end = index + h->s.size; index < end; ++index) {
+    page->bitmap[index / UNIT_SIZE] &= ~((uint32_t)1 << (index % UNIT_SIZE));
+  }
+}
+
+static bool
+is_old(pic_state *pic, struct object *obj)
+{
+  union header *h = ((union header *)obj) - 1;
+  struct heap_page *page;
+  size_t index;
+
+  page = obj2page(pic, h);
+  index = h - page->basep;
+
+  return (page->old[index / UNIT_SIZE] >> (index % UNIT_SIZE)) & 1;
 }
 
 #endif
 
-static void gc_mark_object(pic_state *, struct object *);
+#endif
+
+static void
+gc_mark_object(pic_state *pic, struct object *obj)
+{
+  if (is_marked(pic, obj))
+    return;
+
+  mark(pic, obj);
+  objstack_push(pic, &pic->heap->gray, obj);
+}
 
 static void
 gc_mark(pic_state *pic, pic_value v)
@@ -311,24 +521,137 @@ gc_mark(pic_state *pic, pic_value v)
   gc_mark_object(pic, pic_obj_ptr(v));
 }
 
-static void
-gc_mark_object(pic_state *pic, struct object *obj)
+#if PIC_GENERATIONAL_GC
+
+void
+pic_gc_remember(pic_state *pic, struct object *obj)
 {
- loop:
+  if (obj->u.basic.gc_remembered || ! is_old(pic, obj))
+    return;
 
-  if (is_marked(pic, obj))
+  obj->u.basic.gc_remembered = 1;
+  objstack_push(pic, &pic->heap->remembered, obj);
+}
+
+void
+pic_gc_write_barrier(pic_state *pic, struct object *obj, pic_value v)
+{
+  if (! pic_obj_p(pic, v) || obj->u.basic.gc_remembered)
     return;
 
-  mark(pic, obj);
+  if (is_old(pic, obj) && ! is_old(pic, pic_obj_ptr(v))) {
+    obj->u.basic.gc_remembered = 1;
+    objstack_push(pic, &pic->heap->remembered, obj);
+  }
+}
+
+#endif
+
+#if PIC_INCREMENTAL_GC
+
+void
+pic_gc_remember(pic_state *pic, struct object *obj)
+{
+  if (pic->heap->phase == GC_MARK && is_marked(pic, obj)) {
+    objstack_push(pic, &pic->heap->gray, obj); /* trace it again */
+  }
+}
+
+void
+pic_gc_write_barrier(pic_state *pic, struct object *obj, pic_value v)
+{
+  if (pic->heap->phase == GC_MARK && is_marked(pic, obj)) {
+    gc_mark(pic, v);
+  }
+}
+
+#endif
+
+#if PIC_GENERATIONAL_GC || PIC_INCREMENTAL_GC
 
-#define LOOP(o) obj = (struct object *)(o); goto loop
+/* data objects are opaque to the barrier, so they are traced again before sweeping */
+void
+pic_gc_track_data(pic_state *pic, struct object *obj)
+{
+  objstack_push(pic, &pic->heap->datas, obj);
+}
+
+#endif
+
+static void
+gc_wait(pic_state *pic, struct object *key, struct weak *weak, pic_value val)
+{
+  struct heap *heap = pic->heap;
+  struct ephemeron *e;
+  int ret, it;
+
+  if (heap->ephemerons.len >= heap->ephemerons.size) {
+    heap->ephemerons.size = heap->ephemerons.size * 2 + 1;
+    heap->ephemerons.entries = pic_realloc(pic, heap->ephemerons.entries, sizeof(struct ephemeron) * heap->ephemerons.size);
+  }
+  e = heap->ephemerons.entries + heap->ephemerons.len;
+  e->key = key;
+  e->weak = weak;
+  e->val = val;
+
+  it = kh_put(waiting, &heap->waiting, key, &ret);
+  e->next = ret ? NO_EPHEMERON : kh_val(&heap->waiting, it);
+  kh_val(&heap->waiting, it) = heap->ephemerons.len++;
+
+  key->u.basic.gc_waiting = 1;
+}
+
+static void
+gc_wake(pic_state *pic, struct object *key)
+{
+  struct heap *heap = pic->heap;
+  struct ephemeron *e;
+  size_t i;
+  int it;
+
+  it = kh_get(waiting, &heap->waiting, key);
+  i = kh_val(&heap->waiting, it);
+  kh_del(waiting, &heap->waiting, it);
+
+  key->u.basic.gc_waiting = 0;
+
+  for (; i != NO_EPHEMERON; i = e->next) {
+    e = heap->ephemerons.entries + i;
+    e->key = NULL;
+    gc_mark(pic, e->val);
+  }
+}
+
+static void
+gc_scan_weak(pic_state *pic, struct weak *weak)
+{
+  khash_t(weak) *h = &weak->hash;
+  struct object *key;
+  int it;
+
+  for (it = kh_begin(h); it != kh_end(h); ++it) {
+    if (! kh_exist(h, it))
+      continue;
+    key = kh_key(h, it);
+    if (is_marked(pic, key)) {
+      gc_mark(pic, kh_val(h, it));
+    } else {
+      gc_wait(pic, key, weak, kh_val(h, it));
+    }
+  }
+}
+
+static void
+gc_scan_object(pic_state *pic, struct object *obj)
+{
+  if (obj->u.basic.gc_waiting) {
+    gc_wake(pic, obj);
+  }
 
   switch (obj->u.basic.tt) {
   case PIC_TYPE_PAIR: {
     gc_mark(pic, obj->u.pair.car);
-    if (pic_obj_p(pic, obj->u.pair.cdr)) {
-      LOOP(pic_obj_ptr(obj->u.pair.cdr));
-    }
+    gc_mark(pic, obj->u.pair.cdr);
     break;
   }
   case PIC_TYPE_CXT: {
@@ -338,7 +661,7 @@ gc_mark_object(pic_state *pic, struct object *obj)
       gc_mark(pic, obj->u.cxt.regs[i]);
     }
     if (obj->u.cxt.up) {
-      LOOP(obj->u.cxt.up);
+      gc_mark_object(pic, (struct object *)obj->u.cxt.up);
     }
     break;
   }
@@ -351,7 +674,7 @@ gc_mark_object(pic_state *pic, struct object *obj)
   }
   case PIC_TYPE_IREP: {
     if (obj->u.proc.u.i.cxt) {
-      LOOP(obj->u.proc.u.i.cxt);
+      gc_mark_object(pic, (struct object *)obj->u.proc.u.i.cxt);
     }
     break;
   }
@@ -362,7 +685,9 @@ gc_mark_object(pic_state *pic, struct object *obj)
     gc_mark_object(pic, (struct object *)obj->u.err.type);
     gc_mark_object(pic, (struct object *)obj->u.err.msg);
     gc_mark(pic, obj->u.err.irrs);
-    LOOP(obj->u.err.stack);
+    if (obj->u.err.stack) {
+      gc_mark_object(pic, (struct object *)obj->u.err.stack);
+    }
     break;
   }
   case PIC_TYPE_STRING: {
@@ -380,7 +705,7 @@ gc_mark_object(pic_state *pic, struct object *obj)
   }
   case PIC_TYPE_ID: {
     gc_mark_object(pic, (struct object *)obj->u.id.u.id);
-    LOOP(obj->u.id.env);
+    gc_mark_object(pic, (struct object *)obj->u.id.env);
     break;
   }
   case PIC_TYPE_ENV: {
@@ -394,7 +719,7 @@ gc_mark_object(pic_state *pic, struct object *obj)
       }
     }
     if (obj->u.env.up) {
-      LOOP(obj->u.env.up);
+      gc_mark_object(pic, (struct object *)obj->u.env.up);
     }
     break;
   }
@@ -416,13 +741,16 @@ gc_mark_object(pic_state *pic, struct object *obj)
   }
   case PIC_TYPE_RECORD: {
     gc_mark(pic, obj->u.rec.type);
-    if (pic_obj_p(pic, obj->u.rec.datum)) {
-      LOOP(pic_obj_ptr(obj->u.rec.datum));
-    }
+    gc_mark(pic, obj->u.rec.datum);
     break;
   }
   case PIC_TYPE_SYMBOL: {
-    LOOP(obj->u.id.u.str);
+    if (obj->u.sym.str) {
+      gc_mark_object(pic, (struct object *)obj->u.sym.str);
+    }
+    if (obj->u.sym.base) {
+      gc_mark_object(pic, (struct object *)obj->u.sym.base);
+    }
     break;
   }
   case PIC_TYPE_WEAK: {
@@ -430,6 +758,7 @@ gc_mark_object(pic_state *pic, struct object *obj)
 
     weak->prev = pic->heap->weaks;
     pic->heap->weaks = weak;
+    gc_scan_weak(pic, weak);
     break;
   }
   case PIC_TYPE_CP: {
@@ -440,26 +769,60 @@ gc_mark_object(pic_state *pic, struct object *obj)
       gc_mark_object(pic, (struct object *)obj->u.cp.in);
     }
     if (obj->u.cp.out) {
-      LOOP((struct object *)obj->u.cp.out);
+      gc_mark_object(pic, (struct object *)obj->u.cp.out);
     }
     break;
   }
+  case PIC_TYPE_CELL: {
+    gc_mark(pic, obj->u.cell.value);
+    gc_mark(pic, obj->u.cell.templ);
+    gc_mark_object(pic, (struct object *)obj->u.cell.uid);
+    break;
+  }
   default:
     PIC_UNREACHABLE();
   }
 }
 
+/* traces at most n gray objects; returns true when none are left */
+static bool
+gc_drain(pic_state *pic, size_t n)
+{
+  struct objstack *gray = &pic->heap->gray;
+
+  while (gray->len > 0) {
+    if (n-- == 0) {
+      return false;
+    }
+    gc_scan_object(pic, gray->objs[--gray->len]);
+  }
+  return true;
+}
+
+#define DRAIN_ALL ((size_t)-1)
+
+#if PIC_GENERATIONAL_GC
+
+/* scans an old object again; its children may have become young since */
 static void
-gc_mark_phase(pic_state *pic)
+gc_remark_object(pic_state *pic, struct object *obj)
+{
+  unmark(pic, obj);
+  gc_mark_object(pic, obj);
+}
+
+#endif
+
+static void
+gc_mark_roots(pic_state *pic)
 {
   pic_value *stack;
   struct callinfo *ci;
+  struct cont *cc;
   struct list_head *list;
   int it;
   size_t j;
 
-  assert(pic->heap->weaks == NULL);
-
   /* checkpoint */
   if (pic->cp) {
     gc_mark_object(pic, (struct object *)pic->cp);
@@ -499,6 +862,19 @@ gc_mark_phase(pic_state *pic)
   /* error object */
   gc_mark(pic, pic->err);
 
+  /* exception handlers and prompts, including those saved by live escape
+     points */
+  gc_mark(pic, pic->handlers);
+  gc_mark(pic, pic->prompts);
+  for (cc = pic->cc; cc != NULL; cc = cc->prev) {
+    gc_mark(pic, cc->handlers);
+    gc_mark(pic, cc->trap);
+    gc_mark(pic, cc->prompts);
+  }
+
+  /* bytecode image */
+  gc_mark(pic, pic->image);
+
   /* features */
   gc_mark(pic, pic->features);
 
@@ -511,35 +887,39 @@ gc_mark_phase(pic_state *pic)
     gc_mark_object(pic, (struct object *)kh_val(&pic->ltable, it).env);
     gc_mark_object(pic, (struct object *)kh_val(&pic->ltable, it).exports);
   }
+}
 
-  /* weak maps */
-  do {
-    struct object *key;
-    pic_value val;
-    int it;
-    khash_t(weak) *h;
-    struct weak *weak;
-
-    j = 0;
-    weak = pic->heap->weaks;
-
-    while (weak != NULL) {
-      h = &weak->hash;
-      for (it = kh_begin(h); it != kh_end(h); ++it) {
-        if (! kh_exist(h, it))
-          continue;
-        key = kh_key(h, it);
-        val = kh_val(h, it);
-        if (is_marked(pic, key)) {
-          if (pic_obj_p(pic, val) && ! is_marked(pic, pic_obj_ptr(val))) {
-            gc_mark(pic, val);
-            ++j;
-          }
-        }
+static void
+gc_mark_phase(pic_state *pic, bool PIC_UNUSED(minor))
+{
+  assert(pic->heap->weaks == NULL);
+
+  gc_mark_roots(pic);
+
+#if PIC_GENERATIONAL_GC
+  if (minor) {
+    struct objstack *set;
+    size_t j;
+
+    /* remembered set */
+    set = &pic->heap->remembered;
+    for (j = 0; j < set->len; ++j) {
+      set->objs[j]->u.basic.gc_remembered = 0;
+      gc_remark_object(pic, set->objs[j]);
+    }
+    set->len = 0;
+
+    /* data objects, unless they are young and not reached yet */
+    set = &pic->heap->datas;
+    for (j = 0; j < set->len; ++j) {
+      if (is_marked(pic, set->objs[j])) {
+        gc_remark_object(pic, set->objs[j]);
       }
-      weak = weak->prev;
     }
-  } while (j > 0);
+  }
+#endif
+
+  gc_drain(pic, DRAIN_ALL);
 }
 
 /* SWEEP */
@@ -590,14 +970,20 @@ gc_finalize_object(pic_state *pic, struct object *obj)
     pic_fclose(pic, pic_obj_value(obj)); /* FIXME */
     break;
   }
+  case PIC_TYPE_ERROR: {
+    if (obj->u.err.trace) {
+      pic_trace_free(pic, obj->u.err.trace);
+    }
+    break;
+  }
 
   case PIC_TYPE_PAIR:
   case PIC_TYPE_CXT:
-  case PIC_TYPE_ERROR:
   case PIC_TYPE_ID:
   case PIC_TYPE_RECORD:
   case PIC_TYPE_CP:
   case PIC_TYPE_FUNC:
+  case PIC_TYPE_CELL:
     break;
 
   default:
@@ -607,85 +993,71 @@ gc_finalize_object(pic_state *pic, struct object *obj)
 
 #if !PIC_BITMAP_GC
 
+#define in_use(p) ((p)->s.ptr == (p))
+
+static void
+heap_free(pic_state *pic, union header *p)
+{
+  union header **list;
+
+  list = p->s.size <= SMALL_UNITS ? &pic->heap->freep[p->s.size] : &pic->heap->large;
+  p->s.ptr = *list;
+  *list = p;
+}
+
 static void *
 heap_alloc(pic_state *pic, size_t size)
 {
-  union header *p, *prevp;
+  union header *p, **prevp;
   size_t nunits;
 
   assert(size > 0);
 
   nunits = (size + sizeof(union header) - 1) / sizeof(union header) + 1;
 
-  prevp = pic->heap->freep;
-  for (p = prevp->s.ptr; ; prevp = p, p = p->s.ptr) {
+  if (nunits <= SMALL_UNITS && (p = pic->heap->freep[nunits]) != NULL) {
+    pic->heap->freep[nunits] = p->s.ptr;
+    p->s.ptr = p;
+    return (void *)(p + 1);
+  }
+
+  for (prevp = &pic->heap->large; (p = *prevp) != NULL; prevp = &p->s.ptr) {
     if (p->s.size >= nunits)
       break;
-    if (p == pic->heap->freep) {
-      return NULL;
-    }
+  }
+  if (p == NULL) {
+    return NULL;
   }
 
   if (p->s.size == nunits) {
-    prevp->s.ptr = p->s.ptr;
+    *prevp = p->s.ptr;
   }
   else {
     p->s.size -= nunits;
+    if (p->s.size <= SMALL_UNITS) {
+      *prevp = p->s.ptr;
+      heap_free(pic, p);
+    }
     p += p->s.size;
     p->s.size = nunits;
   }
-  pic->heap->freep = prevp;
+  p->s.ptr = p;
 
   return (void *)(p + 1);
 }
 
-static void
-heap_free(pic_state *pic, void *ap)
-{
-  union header *bp, *p;
-
-  assert(ap != NULL);
-
-  bp = (union header *)ap - 1;
-
-  for (p = pic->heap->freep; ! (bp > p && bp < p->s.ptr); p = p->s.ptr) {
-    if (p >= p->s.ptr && (bp > p || bp < p->s.ptr)) {
-      break;
-    }
-  }
-  if (bp + bp->s.size == p->s.ptr && p->s.ptr->s.size > 0) { /* don't melt base header */
-    bp->s.size += p->s.ptr->s.size;
-    bp->s.ptr = p->s.ptr->s.ptr;
-  } else {
-    bp->s.ptr = p->s.ptr;
-  }
-  if (p + p->s.size == bp && bp->s.size > 0) { /* don't melt base header */
-    p->s.size += bp->s.size;
-    p->s.ptr = bp->s.ptr;
-  } else {
-    p->s.ptr = bp;
-  }
-  pic->heap->freep = p;
-}
-
 static void
 heap_morecore(pic_state *pic)
 {
-  union header *bp, *np;
   struct heap_page *page;
 
-  assert(PAGE_UNITS >= 2);
+  assert(PAGE_UNITS > SMALL_UNITS);
 
   page = pic_malloc(pic, PIC_HEAP_PAGE_SIZE);
   page->next = pic->heap->pages;
 
-  bp = page->basep;
-  bp->s.size = 0;      /* bp is never used for allocation */
-  heap_free(pic, bp + 1);
-
-  np = page->basep + 1;
-  np->s.size = PAGE_UNITS - 1;
-  heap_free(pic, np + 1);
+  page->basep->s.size = PAGE_UNITS;
+  heap_free(pic, page->basep);
 
   pic->heap->pages = page;
 }
@@ -693,45 +1065,57 @@ heap_morecore(pic_state *pic)
 static size_t
 gc_sweep_page(pic_state *pic, struct heap_page *page)
 {
-  union header *bp, *p, *head = NULL, *tail = NULL;
+  union header *p, *end = page->basep + PAGE_UNITS, *run = NULL;
   struct object *obj;
   size_t alive = 0;
 
-  for (bp = page->basep; ; bp = bp->s.ptr) {
-    p = bp + (bp->s.size ? bp->s.size : 1); /* first bp's size is 0, so force advnce */
-    for (; p != bp->s.ptr; p += p->s.size) {
-      if (p < page->basep || page->basep + PAGE_UNITS <= p) {
-        goto escape;
-      }
+  for (p = page->basep; p != end; p += p->s.size) {
+    if (in_use(p)) {
       obj = (struct object *)(p + 1);
       if (obj->u.basic.gc_mark == 1) {
+#if !PIC_GENERATIONAL_GC
         obj->u.basic.gc_mark = 0;
+#endif
         alive += p->s.size;
-      } else {
-        if (head == NULL) {
-          head = p;
+        if (run != NULL) {
+          heap_free(pic, run);
+          run = NULL;
         }
-        if (tail != NULL) {
-          tail->s.ptr = p;
-        }
-        tail = p;
-        tail->s.ptr = NULL; /* We can safely reuse ptr field of dead object */
+        continue;
       }
+      gc_finalize_object(pic, obj);
     }
-  }
- escape:
 
-  /* free! */
-  while (head != NULL) {
-    p = head;
-    head = head->s.ptr;
-    gc_finalize_object(pic, (struct object *)(p + 1));
-    heap_free(pic, p + 1);
+    /* coalesce adjacent free blocks */
+    if (run == NULL) {
+      run = p;
+    } else {
+      run->s.size += p->s.size;
+    }
+  }
+  if (run != NULL) {
+    heap_free(pic, run);
   }
 
   return alive;
 }
 
+#if PIC_GENERATIONAL_GC
+
+static void
+gc_unmark_page(pic_state *PIC_UNUSED(pic), struct heap_page *page)
+{
+  union header *p, *end = page->basep + PAGE_UNITS;
+
+  for (p = page->basep; p != end; p += p->s.size) {
+    if (in_use(p)) {
+      ((struct object *)(p + 1))->u.basic.gc_mark = 0;
+    }
+  }
+}
+
+#endif
+
 #else
 
 static void *
@@ -748,10 +1132,36 @@ heap_alloc(pic_state *pic, size_t size)
   while (page) {
     size_t index;
     union header *h;
+    uint32_t *bitmap = page->bitmap;
+
+#if PIC_INCREMENTAL_GC
+    /*
+     * During marking the bitmap only holds marks, so the space taken is
+     * recorded in the shadow bitmap; the sweep clears it again.
+     */
+    if (pic->heap->phase == GC_MARK) {
+      bitmap = page->shadow;
+    }
+# define USED(page, i) ((page)->bitmap[i] | (page)->shadow[i])
+#else
+# define USED(page, i) ((page)->bitmap[i])
+#endif
 
     for (index = page->freep; index < PAGE_UNITS - nunits; ++index) {
+      if (USED(page, index / UNIT_SIZE) == ~(uint32_t)0) {
+        if (index == page->freep) {
+          page->freep += UNIT_SIZE - index % UNIT_SIZE; /* stays full until the next GC */
+        }
+        index += UNIT_SIZE - index % UNIT_SIZE - 1; /* skip a full word */
+        continue;
+      }
+#if PIC_INCREMENTAL_GC
+      if (is_marked_at(page->shadow, index, nunits)) {
+        continue;
+      }
+#endif
       if (! is_marked_at(page->bitmap, index, nunits)) {
-        mark_at(page, index, nunits);
+        mark_at(bitmap, index, nunits);
         h = index2header(page, index);
         h->s.size = nunits;
         page->freep = index + nunits;
@@ -761,6 +1171,8 @@ heap_alloc(pic_state *pic, size_t size)
     page = page->next;
   }
 
+#undef USED
+
   return NULL;
 }
 
@@ -775,6 +1187,10 @@ heap_morecore(pic_state *pic)
     pic_panic(pic, "memory exhausted");
 
   memset(page->bitmap, 0, sizeof(page->bitmap));
+  memset(page->shadow, 0, sizeof(page->shadow));
+#if PIC_GENERATIONAL_GC
+  memset(page->old, 0, sizeof(page->old));
+#endif
   page->freep = 0;
 
   page->next = pic->heap->pages;
@@ -792,43 +1208,77 @@ gc_sweep_page(pic_state *pic, struct heap_page *page)
     page->shadow[i] &= ~page->bitmap[i];
     inuse += popcount32(page->bitmap[i]);
   }
+#if PIC_GENERATIONAL_GC
+  memcpy(page->old, page->bitmap, sizeof(page->bitmap)); /* promote survivors */
+#endif
 
   for (index = 0; index < PAGE_UNITS; ++index) {
+    if (page->shadow[index / UNIT_SIZE] == 0) {
+      index += UNIT_SIZE - index % UNIT_SIZE - 1; /* nothing dies in this word */
+      continue;
+    }
     if (page->shadow[index / UNIT_SIZE] & (1 << (index % UNIT_SIZE))) {
       h = index2header(page, index);
       index += h->s.size - 1;
       gc_finalize_object(pic, (struct object *) (h + 1));
     }
   }
+#if PIC_INCREMENTAL_GC
+  memset(page->shadow, 0, sizeof(page->shadow));
+  page->freep = 0;
+#endif
   return inuse;
 }
 
 #endif
 
 static void
-gc_sweep_phase(pic_state *pic)
+gc_sweep_begin(pic_state *pic)
 {
-  struct heap_page *page;
   int it;
   khash_t(weak) *h;
   khash_t(oblist) *s = &pic->oblist;
   symbol *sym;
-  struct object *obj;
-  size_t total = 0, inuse = 0;
+  struct ephemeron *e;
+  size_t i;
+
+  /* weak map entries whose keys died */
+  for (i = 0; i < pic->heap->ephemerons.len; ++i) {
+    e = pic->heap->ephemerons.entries + i;
+    if (e->key == NULL)
+      continue;
+    h = &e->weak->hash;
+    it = kh_get(weak, h, e->key);
+    if (it != kh_end(h)) {
+      kh_del(weak, h, it);
+    }
+    e->key->u.basic.gc_waiting = 0;
+  }
+  pic->heap->ephemerons.len = 0;
+  kh_clear(waiting, &pic->heap->waiting);
 
   /* weak maps */
+  pic->heap->stats.weak_maps = pic->heap->stats.weak_entries = 0;
   while (pic->heap->weaks != NULL) {
-    h = &pic->heap->weaks->hash;
-    for (it = kh_begin(h); it != kh_end(h); ++it) {
-      if (! kh_exist(h, it))
-        continue;
-      obj = kh_key(h, it);
-      if (! is_marked(pic, obj)) {
-        kh_del(weak, h, it);
+    pic->heap->stats.weak_maps++;
+    pic->heap->stats.weak_entries += kh_size(&pic->heap->weaks->hash);
+    pic->heap->weaks = pic->heap->weaks->prev;
+  }
+
+#if PIC_GENERATIONAL_GC || PIC_INCREMENTAL_GC
+  /* tracked data objects */
+  {
+    struct objstack *set = &pic->heap->datas;
+    size_t i, j = 0;
+
+    for (i = 0; i < set->len; ++i) {
+      if (is_marked(pic, set->objs[i])) {
+        set->objs[j++] = set->objs[i];
       }
     }
-    pic->heap->weaks = pic->heap->weaks->prev;
+    set->len = j;
   }
+#endif
 
   /* symbol table */
   for (it = kh_begin(s); it != kh_end(s); ++it) {
@@ -840,6 +1290,52 @@ gc_sweep_phase(pic_state *pic)
     }
   }
 
+#if !PIC_BITMAP_GC
+  /* the sweep rebuilds the free lists */
+  for (it = 0; it <= SMALL_UNITS; ++it) {
+    pic->heap->freep[it] = NULL;
+  }
+  pic->heap->large = NULL;
+#endif
+}
+
+static void
+gc_sweep_end(pic_state *pic, size_t inuse, size_t total, bool minor)
+{
+  if (PIC_PAGE_REQUEST_THRESHOLD(total) <= inuse) {
+    heap_morecore(pic);
+    total += PAGE_UNITS;
+  }
+
+  pic->heap->stats.collections++;
+  if (minor) {
+    pic->heap->stats.minor_collections++;
+  }
+  pic->heap->stats.live = inuse * sizeof(union header);
+  pic->heap->collected = true;
+
+#if PIC_GENERATIONAL_GC
+  if (! minor) {
+    pic->heap->old_limit = PIC_MAJOR_GC_THRESHOLD(inuse);
+  }
+  pic->heap->major = pic->heap->old_limit < inuse;
+#endif
+
+#if PIC_INCREMENTAL_GC
+  /* keep half of the free space for what is allocated during the next cycle */
+  pic->heap->debt = 0;
+  pic->heap->threshold = (total - inuse) / 2;
+#endif
+}
+
+static void
+gc_sweep_phase(pic_state *pic, bool minor)
+{
+  struct heap_page *page;
+  size_t total = 0, inuse = 0;
+
+  gc_sweep_begin(pic);
+
   page = pic->heap->pages;
   while (page) {
     inuse += gc_sweep_page(pic, page);
@@ -847,13 +1343,11 @@ gc_sweep_phase(pic_state *pic)
     page = page->next;
   }
 
-  if (PIC_PAGE_REQUEST_THRESHOLD(total) <= inuse) {
-    heap_morecore(pic);
-  }
+  gc_sweep_end(pic, inuse, total, minor);
 }
 
-void
-gc_init(pic_state *PIC_UNUSED(pic))
+static void
+gc_init(pic_state *PIC_UNUSED(pic), bool PIC_UNUSED(minor))
 {
 #if PIC_BITMAP_GC
   struct heap_page *page;
@@ -862,24 +1356,238 @@ gc_init(pic_state *PIC_UNUSED(pic))
   while (page) {
     /* clear mark bits */
     memcpy(page->shadow, page->bitmap, sizeof(page->bitmap));
+# if PIC_GENERATIONAL_GC
+    if (minor) {
+      memcpy(page->bitmap, page->old, sizeof(page->bitmap)); /* old objects count as marked */
+    } else {
+      memset(page->bitmap, 0, sizeof(page->bitmap));
+    }
+# else
     memset(page->bitmap, 0, sizeof(page->bitmap));
-    page->freep = 0;
+# endif
+# if ! PIC_INCREMENTAL_GC
+    page->freep = 0;            /* an incremental sweep resets it page by page */
+# endif
     page = page->next;
   }
+#elif PIC_GENERATIONAL_GC
+  struct heap_page *page;
+
+  if (! minor) {
+    for (page = pic->heap->pages; page; page = page->next) {
+      gc_unmark_page(pic, page);
+    }
+  }
+#endif
+
+#if PIC_GENERATIONAL_GC
+  if (! minor) {
+    struct objstack *set = &pic->heap->remembered;
+    size_t i;
+
+    /* a major GC traces everything anyway */
+    for (i = 0; i < set->len; ++i) {
+      set->objs[i]->u.basic.gc_remembered = 0;
+    }
+    set->len = 0;
+  }
 #endif
 }
 
-void
-pic_gc(pic_state *pic)
+static void
+gc_pause_begin(pic_state *pic)
+{
+  pic->heap->pause = PIC_CLOCK(pic);
+}
+
+static void
+gc_pause_end(pic_state *pic)
+{
+  struct heap *heap = pic->heap;
+  double t = PIC_CLOCK(pic) - heap->pause;
+
+  heap->stats.total_pause += t;
+  if (heap->stats.max_pause < t) {
+    heap->stats.max_pause = t;
+  }
+  if (heap->collected) {
+    heap->collected = false;
+    if (heap->hook) {
+      heap->hook(pic, &heap->stats);
+    }
+  }
+}
+
+#if PIC_INCREMENTAL_GC
+
+static void
+gc_start(pic_state *pic)
+{
+  assert(pic->heap->weaks == NULL);
+
+  gc_init(pic, false);
+  gc_mark_roots(pic);
+
+  pic->heap->phase = GC_MARK;
+}
+
+static void
+gc_atomic(pic_state *pic)
+{
+  struct objstack *set = &pic->heap->datas;
+  size_t i;
+
+  /* roots have no write barrier */
+  gc_mark_roots(pic);
+
+  for (i = 0; i < set->len; ++i) {
+    if (is_marked(pic, set->objs[i])) {
+      objstack_push(pic, &pic->heap->gray, set->objs[i]);
+    }
+  }
+
+  gc_drain(pic, DRAIN_ALL);
+
+  gc_sweep_begin(pic);
+
+  pic->heap->phase = GC_SWEEP;
+  pic->heap->sweep = pic->heap->pages;
+  pic->heap->inuse = pic->heap->total = 0;
+}
+
+static void
+gc_step(pic_state *pic, size_t n)
+{
+  struct heap *heap = pic->heap;
+
+  switch (heap->phase) {
+  case GC_MARK:
+    if (gc_drain(pic, n)) {
+      gc_atomic(pic);
+    }
+    break;
+  case GC_SWEEP:
+    heap->inuse += gc_sweep_page(pic, heap->sweep);
+    heap->total += PAGE_UNITS;
+    heap->sweep = heap->sweep->next;
+    if (heap->sweep == NULL) {
+      heap->phase = GC_IDLE;
+      gc_sweep_end(pic, heap->inuse, heap->total, false);
+    }
+    break;
+  }
+}
+
+static void
+gc_finish(pic_state *pic)
+{
+  while (pic->heap->phase != GC_IDLE) {
+    gc_step(pic, DRAIN_ALL);
+  }
+}
+
+#endif
+
+static void
+gc_collect(pic_state *pic, bool minor)
 {
   if (! pic->gc_enable) {
     return;
   }
 
-  gc_init(pic);
+  gc_pause_begin(pic);
+
+#if PIC_INCREMENTAL_GC
+  gc_finish(pic);
+#endif
+
+  gc_init(pic, minor);
+
+  gc_mark_phase(pic, minor);
+  gc_sweep_phase(pic, minor);
+
+  gc_pause_end(pic);
+}
 
-  gc_mark_phase(pic);
-  gc_sweep_phase(pic);
+void
+pic_gc(pic_state *pic)
+{
+  gc_collect(pic, false);
+}
+
+int
+pic_gc_budget(pic_state *pic, int budget)
+{
+  int old = pic->heap->budget;
+
+  if (budget >= 0) {
+    pic->heap->budget = budget;
+  }
+#if PIC_INCREMENTAL_GC
+  if (budget == 0 && pic->heap->phase != GC_IDLE) {
+    gc_pause_begin(pic);
+    gc_finish(pic);
+    gc_pause_end(pic);
+  }
+#endif
+  return old;
+}
+
+void
+pic_gc_stats(pic_state *pic, struct pic_gc_stats *stats)
+{
+  struct heap_page *page;
+
+  *stats = pic->heap->stats;
+
+  stats->pages = 0;
+  for (page = pic->heap->pages; page; page = page->next) {
+    stats->pages++;
+  }
+  stats->heap = stats->pages * PIC_HEAP_PAGE_SIZE;
+}
+
+pic_gcf
+pic_atgc(pic_state *pic, pic_gcf f)
+{
+  pic_gcf old = pic->heap->hook;
+
+  pic->heap->hook = f;
+  return old;
+}
+
+static void *
+gc_reclaim(pic_state *pic, size_t size)
+{
+#if PIC_INCREMENTAL_GC
+  if (pic->heap->budget > 0 && pic->gc_enable) {
+    void *ptr = NULL;
+
+    gc_pause_begin(pic);
+    if (pic->heap->phase == GC_IDLE) {
+      gc_start(pic);
+    }
+    /* sweep lazily until something frees up; grow the heap rather than finish marking */
+    while (pic->heap->phase == GC_SWEEP) {
+      if ((ptr = heap_alloc(pic, size)) != NULL) {
+        break;
+      }
+      gc_step(pic, pic->heap->budget);
+    }
+    if (ptr == NULL && pic->heap->phase == GC_IDLE) {
+      ptr = heap_alloc(pic, size);
+    }
+    gc_pause_end(pic);
+    return ptr;
+  }
+#endif
+
+#if PIC_GENERATIONAL_GC
+  gc_collect(pic, ! pic->heap->major);
+#else
+  gc_collect(pic, false);
+#endif
+  return heap_alloc(pic, size);
 }
 
 struct object *
@@ -891,10 +1599,24 @@ pic_obj_alloc_unsafe(pic_state *pic, size_t size, int type)
   pic_gc(pic);
 #endif
 
+#if PIC_INCREMENTAL_GC
+  if (pic->heap->budget > 0 && pic->gc_enable) {
+    pic->heap->debt += (size + sizeof(union header) - 1) / sizeof(union header) + 1;
+    if (pic->heap->phase != GC_IDLE) {
+      gc_pause_begin(pic);
+      gc_step(pic, pic->heap->budget);
+      gc_pause_end(pic);
+    } else if (pic->heap->debt >= pic->heap->threshold) {
+      gc_pause_begin(pic);
+      gc_start(pic);
+      gc_pause_end(pic);
+    }
+  }
+#endif
+
   obj = (struct object *)heap_alloc(pic, size);
   if (obj == NULL) {
-    pic_gc(pic);
-    obj = (struct object *)heap_alloc(pic, size);
+    obj = (struct object *)gc_reclaim(pic, size);
     if (obj == NULL) {
       heap_morecore(pic);
       obj = (struct object *)heap_alloc(pic, size);
@@ -904,8 +1626,14 @@ pic_obj_alloc_unsafe(pic_state *pic, size_t size, int type)
   }
 #if !PIC_BITMAP_GC
   obj->u.basic.gc_mark = 0;
+#endif
+#if PIC_GENERATIONAL_GC
+  obj->u.basic.gc_remembered = 0;
 #endif
   obj->u.basic.tt = type;
+  obj->u.basic.gc_waiting = 0;
+
+  pic->heap->stats.allocated[type] += size;
 
   return obj;
 }
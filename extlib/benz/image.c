@@ -0,0 +1,1371 @@
+/**
+ * See Copyright Notice in picrin.h
+ */
+
+#include "picrin.h"
+#include "picrin/extra.h"
+#include "picrin/private/object.h"
+#include "picrin/private/state.h"
+
+/*
+ * Bytecode images.
+ *
+ * An image records what loading one piclib file did: each pic_eval run while
+ * the file was loaded, in order, along with its compiled thunk and the side
+ * effects its expansion had on the expander state (bindings, macros, global
+ * definitions, exports). Loading the image replays those instead of reading,
+ * expanding and compiling the source again. A form whose expansion evaluates
+ * other forms (define-library does) or whose results cannot be serialized is
+ * recorded as source and evaluated as usual; the forms it evaluates are
+ * replayed in turn. Whenever the replay diverges from the recording the rest
+ * of the file is evaluated from source.
+ *
+ *   image = "PIMG" version:1 size:u item*
+ *   item  = 'B' n:u shell*n fill*n        n new table entries
+ *         | 'S' kind:1 depth:u form:v lib:s
+ *         | 'P' ucnt:u ucnt:u n:u (kind:1 v v v)*n thunk:u
+ *         | 'E'
+ *
+ * u is an unsigned LEB128 number, v a value reference and s a length-prefixed
+ * byte string. Heap objects and ireps live in a table local to the image, so
+ * sharing and cycles within one file are preserved.
+ */
+
+#define IMAGE_VERSION 8
+
+enum {
+  IMAGE_DUMP,
+  IMAGE_LOAD
+};
+
+enum {
+  KIND_SOURCE,
+  KIND_COMPILED
+};
+
+enum {
+  REF_NONE,
+  REF_UNDEF,
+  REF_INVALID,
+  REF_NIL,
+  REF_TRUE,
+  REF_FALSE,
+  REF_EOF,
+  REF_INT,
+  REF_FLOAT,
+  REF_CHAR,
+  REF_OBJ
+};
+
+enum {
+  TAG_SYMBOL,
+  TAG_STRING,
+  TAG_BLOB,
+  TAG_PAIR,
+  TAG_VECTOR,
+  TAG_ID,
+  TAG_LIBENV,
+  TAG_ENV,
+  TAG_PROC,
+  TAG_CXT,
+  TAG_IREP
+};
+
+KHASH_DECLARE(image, void *, int)
+KHASH_DEFINE(image, void *, int, kh_ptr_hash_func, kh_ptr_hash_equal)
+
+struct entry {
+  void *ptr;                    /* struct object * or struct irep * */
+  unsigned char tag;
+};
+
+struct frame {
+  size_t kind;                  /* offset of the kind byte of 'S' */
+  int ucnt;
+  bool tainted, preparing;
+  pic_value effects;
+  pic_value globals;            /* cells and their values when it was entered */
+};
+
+struct image {
+  int mode;
+  bool active;                  /* inside pic_load_image */
+  int depth;                    /* nesting of pic_eval */
+
+  /* recording */
+  bool broken;
+  unsigned char *buf;
+  size_t len, capa;
+  khash_t(image) memo;
+  struct entry *entries;
+  int nentries, entcapa;
+  struct frame *frames;
+  int frcapa;
+  pic_value units;
+
+  /* replaying */
+  bool off;
+  const unsigned char *ip;
+  pic_value table;
+  struct irep **ireps;
+  unsigned char *tags;
+  int count, size;
+};
+
+static void
+image_dtor(pic_state *pic, void *data)
+{
+  struct image *img = data;
+
+  pic_free(pic, img->buf);
+  kh_destroy(image, &img->memo);
+  pic_free(pic, img->entries);
+  pic_free(pic, img->frames);
+  pic_free(pic, img->ireps);
+  pic_free(pic, img->tags);
+  pic_free(pic, img);
+}
+
+static void
+image_mark(pic_state *pic, void *data, void (*mark)(pic_state *, pic_value))
+{
+  struct image *img = data;
+  int i;
+
+  for (i = 0; i < img->nentries; ++i) {
+    if (img->entries[i].tag != TAG_IREP) {
+      mark(pic, pic_obj_value(img->entries[i].ptr));
+    }
+  }
+  if (img->active && img->mode == IMAGE_DUMP) {
+    for (i = 0; i < img->depth; ++i) {
+      mark(pic, img->frames[i].effects);
+      mark(pic, img->frames[i].globals);
+    }
+  }
+  mark(pic, img->units);
+  mark(pic, img->table);
+}
+
+static const pic_data_type image_type = { "image", image_dtor, image_mark };
+
+static pic_value
+make_image(pic_state *pic, int mode)
+{
+  struct image *img;
+
+  img = pic_calloc(pic, 1, sizeof(struct image));
+  img->mode = mode;
+  kh_init(image, &img->memo);
+  img->units = pic_nil_value(pic);
+  img->table = pic_undef_value(pic);
+
+  return pic_data_value(pic, img, &image_type);
+}
+
+/* whether an image is being recorded or replayed */
+bool
+pic_image_running(pic_state *pic)
+{
+  return pic_data_p(pic, pic->image, &image_type);
+}
+
+static struct image *
+current_image(pic_state *pic)
+{
+  struct image *img;
+
+  if (! pic_data_p(pic, pic->image, &image_type)) {
+    return NULL;
+  }
+  img = pic_data(pic, pic->image);
+  return img->active ? img : NULL;
+}
+
+/* recording */
+
+static void
+put_byte(pic_state *pic, struct image *img, int c)
+{
+  if (img->len == img->capa) {
+    img->capa = img->capa * 2 + 256;
+    img->buf = pic_realloc(pic, img->buf, img->capa);
+  }
+  img->buf[img->len++] = (unsigned char)c;
+}
+
+static void
+put_uint(pic_state *pic, struct image *img, size_t n)
+{
+  while (n >= 0x80) {
+    put_byte(pic, img, (int)(n & 0x7f) | 0x80);
+    n >>= 7;
+  }
+  put_byte(pic, img, (int)n);
+}
+
+static void
+put_int(pic_state *pic, struct image *img, int i)
+{
+  put_uint(pic, img, i < 0 ? ((size_t)-(i + 1) << 1) | 1 : (size_t)i << 1);
+}
+
+static void
+put_bytes(pic_state *pic, struct image *img, const void *ptr, size_t len)
+{
+  const unsigned char *p = ptr;
+
+  put_uint(pic, img, len);
+  while (len-- > 0) {
+    put_byte(pic, img, *p++);
+  }
+}
+
+static void
+put_float(pic_state *pic, struct image *img, double f)
+{
+  unsigned char b[sizeof(double)];
+  size_t i;
+
+  memcpy(b, &f, sizeof(double));
+  for (i = 0; i < sizeof(double); ++i) {
+    put_byte(pic, img, b[i]);
+  }
+}
+
+static int
+lookup(pic_state *pic, struct image *img, void *ptr)
+{
+  int it;
+
+  it = kh_get(image, &img->memo, ptr);
+  if (it == kh_end(&img->memo)) {
+    return -1;
+  }
+  return kh_val(&img->memo, it);
+}
+
+static void
+put_ptr(pic_state *pic, struct image *img, void *ptr)
+{
+  if (ptr == NULL) {
+    put_byte(pic, img, REF_NONE);
+  } else {
+    put_byte(pic, img, REF_OBJ);
+    put_uint(pic, img, lookup(pic, img, ptr));
+  }
+}
+
+static void
+put_ref(pic_state *pic, struct image *img, pic_value v)
+{
+  switch (pic_type(pic, v)) {
+  case PIC_TYPE_UNDEF:
+    put_byte(pic, img, REF_UNDEF);
+    break;
+  case PIC_TYPE_INVALID:
+    put_byte(pic, img, REF_INVALID);
+    break;
+  case PIC_TYPE_NIL:
+    put_byte(pic, img, REF_NIL);
+    break;
+  case PIC_TYPE_TRUE:
+    put_byte(pic, img, REF_TRUE);
+    break;
+  case PIC_TYPE_FALSE:
+    put_byte(pic, img, REF_FALSE);
+    break;
+  case PIC_TYPE_EOF:
+    put_byte(pic, img, REF_EOF);
+    break;
+  case PIC_TYPE_INT:
+    put_byte(pic, img, REF_INT);
+    put_int(pic, img, pic_int(pic, v));
+    break;
+  case PIC_TYPE_FLOAT:
+    put_byte(pic, img, REF_FLOAT);
+    put_float(pic, img, pic_float(pic, v));
+    break;
+  case PIC_TYPE_CHAR:
+    put_byte(pic, img, REF_CHAR);
+    put_byte(pic, img, (unsigned char)pic_char(pic, v));
+    break;
+  default:
+    put_ptr(pic, img, pic_obj_ptr(v));
+  }
+}
+
+static bool
+toplevel_env_p(pic_state *pic, struct env *env)
+{
+  const char *lib;
+
+  if (env->up != NULL || env->lib == NULL) {
+    return false;
+  }
+  lib = pic_str(pic, pic_obj_value(env->lib));
+  return pic_find_library(pic, lib) && pic_env_ptr(pic, pic_library_environment(pic, lib)) == env;
+}
+
+/* assigns a table entry to ptr; returns false if it cannot be serialized */
+static bool
+enter_ptr(pic_state *pic, struct image *img, void *ptr, int tag)
+{
+  int it, ret;
+
+  if (ptr == NULL || lookup(pic, img, ptr) >= 0) {
+    return true;
+  }
+  if (tag < 0) {
+    switch (((struct basic *)ptr)->tt) {
+    case PIC_TYPE_SYMBOL:
+      if (((symbol *)ptr)->base != NULL) {
+        return false;           /* uninterned */
+      }
+      tag = TAG_SYMBOL;
+      break;
+    case PIC_TYPE_STRING: tag = TAG_STRING; break;
+    case PIC_TYPE_BLOB: tag = TAG_BLOB; break;
+    case PIC_TYPE_PAIR: tag = TAG_PAIR; break;
+    case PIC_TYPE_VECTOR: tag = TAG_VECTOR; break;
+    case PIC_TYPE_ID: tag = TAG_ID; break;
+    case PIC_TYPE_ENV:
+      if (((struct env *)ptr)->up == NULL) {
+        if (! toplevel_env_p(pic, ptr)) {
+          return false;
+        }
+        tag = TAG_LIBENV;
+      } else {
+        tag = TAG_ENV;
+      }
+      break;
+    case PIC_TYPE_IREP: tag = TAG_PROC; break;
+    case PIC_TYPE_CXT:
+      if (((struct context *)ptr)->regs != ((struct context *)ptr)->storage) {
+        return false;           /* still on the VM stack */
+      }
+      tag = TAG_CXT;
+      break;
+    default:
+      return false;
+    }
+  }
+
+  if (img->nentries == img->entcapa) {
+    img->entcapa = img->entcapa * 2 + 64;
+    img->entries = pic_realloc(pic, img->entries, sizeof(struct entry) * img->entcapa);
+  }
+  img->entries[img->nentries].ptr = ptr;
+  img->entries[img->nentries].tag = (unsigned char)tag;
+
+  it = kh_put(image, &img->memo, ptr, &ret);
+  kh_val(&img->memo, it) = img->nentries++;
+
+  if (tag == TAG_IREP) {
+    pic_irep_incref(pic, ptr);
+  }
+  return true;
+}
+
+static bool
+enter_value(pic_state *pic, struct image *img, pic_value v)
+{
+  return pic_obj_p(pic, v) ? enter_ptr(pic, img, pic_obj_ptr(v), -1) : true;
+}
+
+static bool
+enter_children(pic_state *pic, struct image *img, struct entry *e)
+{
+  struct object *obj = e->ptr;
+  int i;
+
+  switch (e->tag) {
+  case TAG_PAIR: {
+    struct pair *pair = e->ptr;
+    return enter_value(pic, img, pair->car) && enter_value(pic, img, pair->cdr);
+  }
+  case TAG_VECTOR: {
+    struct vector *vec = e->ptr;
+    for (i = 0; i < vec->len; ++i) {
+      if (! enter_value(pic, img, vec->data[i]))
+        return false;
+    }
+    return true;
+  }
+  case TAG_ID: {
+    struct identifier *id = e->ptr;
+    return enter_ptr(pic, img, id->u.id, -1) && enter_ptr(pic, img, id->env, -1);
+  }
+  case TAG_ENV: {
+    struct env *env = e->ptr;
+    khash_t(env) *h = &env->map;
+    int it;
+
+    for (it = kh_begin(h); it != kh_end(h); ++it) {
+      if (kh_exist(h, it)) {
+        if (! enter_ptr(pic, img, kh_key(h, it), -1) || ! enter_ptr(pic, img, kh_val(h, it), -1))
+          return false;
+      }
+    }
+    return enter_ptr(pic, img, env->up, -1) && enter_ptr(pic, img, env->lib, -1);
+  }
+  case TAG_PROC: {
+    struct proc *proc = e->ptr;
+    return enter_ptr(pic, img, proc->u.i.irep, TAG_IREP) && enter_ptr(pic, img, proc->u.i.cxt, -1);
+  }
+  case TAG_CXT: {
+    struct context *cxt = e->ptr;
+    for (i = 0; i < cxt->regc; ++i) {
+      if (! enter_value(pic, img, cxt->regs[i]))
+        return false;
+    }
+    return enter_ptr(pic, img, cxt->up, -1);
+  }
+  case TAG_IREP: {
+    struct irep *irep = e->ptr;
+    size_t j;
+    for (j = 0; j < irep->npool; ++j) {
+      obj = irep->pool[j];
+      if (! enter_ptr(pic, img, ((struct basic *)obj)->tt == PIC_TYPE_CELL ? (void *)((struct cell *)obj)->uid : (void *)obj, -1))
+        return false;
+    }
+    for (j = 0; j < irep->nirep; ++j) {
+      if (! enter_ptr(pic, img, irep->irep[j], TAG_IREP))
+        return false;
+    }
+    return true;
+  }
+  default:
+    return true;
+  }
+}
+
+static void
+put_shell(pic_state *pic, struct image *img, struct entry *e)
+{
+  pic_value v = pic_obj_value(e->ptr);
+
+  put_byte(pic, img, e->tag);
+
+  switch (e->tag) {
+  case TAG_SYMBOL:
+    v = pic_sym_name(pic, v);
+    /* fall through */
+  case TAG_STRING:
+    put_bytes(pic, img, pic_str(pic, v), pic_str_len(pic, v));
+    break;
+  case TAG_BLOB: {
+    struct blob *blob = e->ptr;
+    put_bytes(pic, img, blob->data, blob->len);
+    break;
+  }
+  case TAG_VECTOR:
+    put_uint(pic, img, ((struct vector *)e->ptr)->len);
+    break;
+  case TAG_LIBENV:
+    v = pic_obj_value(((struct env *)e->ptr)->lib);
+    put_bytes(pic, img, pic_str(pic, v), pic_str_len(pic, v));
+    break;
+  case TAG_CXT:
+    put_uint(pic, img, ((struct context *)e->ptr)->regc);
+    break;
+  case TAG_IREP: {
+    struct irep *irep = e->ptr;
+    put_uint(pic, img, irep->argc);
+    put_uint(pic, img, irep->localc);
+    put_uint(pic, img, irep->capturec);
+    put_byte(pic, img, irep->varg);
+    put_uint(pic, img, irep->ncode);
+    put_uint(pic, img, irep->nnums);
+    put_uint(pic, img, irep->npool);
+    put_uint(pic, img, irep->nirep);
+    break;
+  }
+  }
+}
+
+static void
+put_fill(pic_state *pic, struct image *img, struct entry *e)
+{
+  int i;
+
+  switch (e->tag) {
+  case TAG_PAIR:
+    put_ref(pic, img, ((struct pair *)e->ptr)->car);
+    put_ref(pic, img, ((struct pair *)e->ptr)->cdr);
+    break;
+  case TAG_VECTOR: {
+    struct vector *vec = e->ptr;
+    for (i = 0; i < vec->len; ++i) {
+      put_ref(pic, img, vec->data[i]);
+    }
+    break;
+  }
+  case TAG_ID:
+    put_ptr(pic, img, ((struct identifier *)e->ptr)->u.id);
+    put_ptr(pic, img, ((struct identifier *)e->ptr)->env);
+    break;
+  case TAG_ENV: {
+    struct env *env = e->ptr;
+    khash_t(env) *h = &env->map;
+    int it;
+
+    put_ptr(pic, img, env->up);
+    put_ptr(pic, img, env->lib);
+    put_uint(pic, img, kh_size(h));
+    for (it = kh_begin(h); it != kh_end(h); ++it) {
+      if (kh_exist(h, it)) {
+        put_ptr(pic, img, kh_key(h, it));
+        put_ptr(pic, img, kh_val(h, it));
+      }
+    }
+    break;
+  }
+  case TAG_PROC:
+    put_uint(pic, img, lookup(pic, img, ((struct proc *)e->ptr)->u.i.irep));
+    put_ptr(pic, img, ((struct proc *)e->ptr)->u.i.cxt);
+    break;
+  case TAG_CXT: {
+    struct context *cxt = e->ptr;
+    for (i = 0; i < cxt->regc; ++i) {
+      put_ref(pic, img, cxt->regs[i]);
+    }
+    put_ptr(pic, img, cxt->up);
+    break;
+  }
+  case TAG_IREP: {
+    struct irep *irep = e->ptr;
+    struct object *obj;
+    size_t j;
+
+    for (j = 0; j < irep->ncode; ++j) {
+      put_byte(pic, img, irep->code[j]);
+    }
+    for (j = 0; j < irep->nnums; ++j) {
+      put_float(pic, img, irep->nums[j]);
+    }
+    for (j = 0; j < irep->npool; ++j) {
+      obj = irep->pool[j];
+      if (((struct basic *)obj)->tt == PIC_TYPE_CELL) {
+        put_byte(pic, img, 1);
+        put_ptr(pic, img, ((struct cell *)obj)->uid);
+      } else {
+        put_byte(pic, img, 0);
+        put_ptr(pic, img, obj);
+      }
+    }
+    for (j = 0; j < irep->nirep; ++j) {
+      put_uint(pic, img, lookup(pic, img, irep->irep[j]));
+    }
+    break;
+  }
+  }
+}
+
+static void
+rollback(pic_state *pic, struct image *img, int mark)
+{
+  struct entry *e;
+
+  while (img->nentries > mark) {
+    e = &img->entries[--img->nentries];
+    kh_del(image, &img->memo, kh_get(image, &img->memo, e->ptr));
+    if (e->tag == TAG_IREP) {
+      pic_irep_decref(pic, e->ptr);
+    }
+  }
+}
+
+/* writes out the entries from mark on, or drops them if any is unserializable */
+static bool
+put_batch(pic_state *pic, struct image *img, int mark)
+{
+  int i;
+
+  for (i = mark; i < img->nentries; ++i) {
+    if (! enter_children(pic, img, &img->entries[i])) {
+      rollback(pic, img, mark);
+      return false;
+    }
+  }
+  if (mark == img->nentries) {
+    return true;
+  }
+  put_byte(pic, img, 'B');
+  put_uint(pic, img, img->nentries - mark);
+  for (i = mark; i < img->nentries; ++i) {
+    put_shell(pic, img, &img->entries[i]);
+  }
+  for (i = mark; i < img->nentries; ++i) {
+    put_fill(pic, img, &img->entries[i]);
+  }
+  return true;
+}
+
+/*
+ * Rather than have every store to a global check for a running dump, the
+ * globals set while a form is expanded are found afterwards: those defined
+ * by the form, and those whose value differs from a snapshot taken before.
+ */
+static pic_value
+snapshot_globals(pic_state *pic)
+{
+  pic_value vec, uid, cell;
+  int i = 0, it = 0;
+
+  vec = pic_make_vec(pic, pic_weak_size(pic, pic->globals) * 2, NULL);
+  while (pic_weak_next(pic, pic->globals, &it, &uid, &cell)) {
+    pic_vec_set(pic, vec, i++, cell);
+    pic_vec_set(pic, vec, i++, pic_cell_ptr(pic, cell)->value);
+  }
+  return vec;
+}
+
+static void
+record_sets(pic_state *pic, struct frame *f)
+{
+  pic_value defined, uid, e, it;
+  struct cell *cell;
+  int i, len = pic_vec_len(pic, f->globals);
+
+  defined = pic_make_dict(pic);
+  pic_for_each (e, f->effects, it) {
+    if (pic_int(pic, pic_vec_ref(pic, e, 0)) != PIC_IMAGE_DEFINE) {
+      continue;
+    }
+    uid = pic_vec_ref(pic, e, 1);
+    if (pic_dict_has(pic, defined, uid)) {
+      continue;
+    }
+    pic_dict_set(pic, defined, uid, pic_true_value(pic));
+    cell = pic_global_cell(pic, uid);
+    if (! pic_invalid_p(pic, cell->value)) {
+      pic_image_effect(pic, PIC_IMAGE_SET, uid, cell->value, pic_undef_value(pic));
+    }
+  }
+
+  for (i = 0; i < len; i += 2) {
+    cell = pic_cell_ptr(pic, pic_vec_ref(pic, f->globals, i));
+    if (pic_eq_p(pic, cell->value, pic_vec_ref(pic, f->globals, i + 1)) || pic_invalid_p(pic, cell->value)) {
+      continue;
+    }
+    uid = pic_obj_value(cell->uid);
+    if (! pic_dict_has(pic, defined, uid)) {
+      pic_image_effect(pic, PIC_IMAGE_SET, uid, cell->value, pic_undef_value(pic));
+    }
+  }
+}
+
+static void
+dump_enter(pic_state *pic, struct image *img, pic_value program, const char *lib)
+{
+  struct frame *f;
+  int mark = img->nentries;
+
+  if (img->depth > 0 && img->frames[img->depth - 1].preparing) {
+    img->frames[img->depth - 1].tainted = true;
+  }
+  if (img->depth == img->frcapa) {
+    img->frcapa = img->frcapa * 2 + 8;
+    img->frames = pic_realloc(pic, img->frames, sizeof(struct frame) * img->frcapa);
+  }
+  f = &img->frames[img->depth++];
+  f->kind = 0;
+  f->ucnt = pic->ucnt;
+  f->tainted = false;
+  f->preparing = true;
+  f->effects = pic_nil_value(pic);
+  f->globals = pic_nil_value(pic);
+
+  if (img->broken) {
+    return;
+  }
+  f->globals = snapshot_globals(pic);
+  if (! enter_value(pic, img, program) || ! put_batch(pic, img, mark)) {
+    img->broken = true;
+    return;
+  }
+  put_byte(pic, img, 'S');
+  f->kind = img->len;
+  put_byte(pic, img, KIND_SOURCE);
+  put_uint(pic, img, img->depth - 1);
+  put_ref(pic, img, program);
+  put_bytes(pic, img, lib, strlen(lib));
+}
+
+static void
+dump_prepared(pic_state *pic, struct image *img, pic_value proc)
+{
+  struct frame *f = &img->frames[img->depth - 1];
+  struct irep *irep = pic_proc_ptr(pic, proc)->u.i.irep;
+  pic_value effects, e, it;
+  int mark = img->nentries, i;
+
+  if (img->broken || f->tainted) {
+    f->preparing = false;
+    return;
+  }
+  record_sets(pic, f);
+  f->globals = pic_nil_value(pic);
+  f->preparing = false;
+
+  effects = pic_reverse(pic, f->effects);
+  f->effects = pic_nil_value(pic);
+
+  pic_for_each (e, effects, it) {
+    for (i = 1; i < 4; ++i) {
+      if (! enter_value(pic, img, pic_vec_ref(pic, e, i))) {
+        rollback(pic, img, mark);
+        return;
+      }
+    }
+  }
+  if (! enter_ptr(pic, img, irep, TAG_IREP) || ! put_batch(pic, img, mark)) {
+    return;
+  }
+
+  put_byte(pic, img, 'P');
+  put_uint(pic, img, f->ucnt);
+  put_uint(pic, img, pic->ucnt);
+  put_uint(pic, img, pic_length(pic, effects));
+  pic_for_each (e, effects, it) {
+    put_byte(pic, img, pic_int(pic, pic_vec_ref(pic, e, 0)));
+    for (i = 1; i < 4; ++i) {
+      put_ref(pic, img, pic_vec_ref(pic, e, i));
+    }
+  }
+  put_uint(pic, img, lookup(pic, img, irep));
+
+  img->buf[f->kind] = KIND_COMPILED;
+}
+
+void
+pic_image_effect(pic_state *pic, int kind, pic_value a, pic_value b, pic_value c)
+{
+  struct image *img = current_image(pic);
+  struct frame *f;
+
+  if (img == NULL || img->mode != IMAGE_DUMP || img->depth == 0) {
+    return;
+  }
+  f = &img->frames[img->depth - 1];
+  if (f->preparing) {
+    pic_value v[4];
+
+    v[0] = pic_int_value(pic, kind);
+    v[1] = a;
+    v[2] = b;
+    v[3] = c;
+    f->effects = pic_cons(pic, pic_make_vec(pic, 4, v), f->effects);
+  }
+}
+
+static void
+dump_unit(pic_state *pic, struct image *img, const char *src)
+{
+  pic_value e, blob;
+  size_t size;
+  int i;
+
+  img->active = true;
+  img->broken = false;
+  img->depth = 0;
+  img->len = 0;
+
+  put_byte(pic, img, 'P');
+  put_byte(pic, img, 'I');
+  put_byte(pic, img, 'M');
+  put_byte(pic, img, 'G');
+  put_byte(pic, img, IMAGE_VERSION);
+  size = img->len;
+  for (i = 0; i < 5; ++i) {
+    put_byte(pic, img, 0);      /* room for the table size */
+  }
+
+  pic_try {
+    pic_load_cstr(pic, src);
+  }
+  pic_catch(e) {
+    img->active = false;
+    rollback(pic, img, 0);
+    pic_raise(pic, e);
+  }
+  put_byte(pic, img, 'E');
+
+  for (i = 0; i < 5; ++i) {
+    img->buf[size + i] = (unsigned char)(((img->nentries >> (7 * i)) & 0x7f) | (i < 4 ? 0x80 : 0));
+  }
+
+  img->active = false;
+  rollback(pic, img, 0);
+
+  blob = img->broken ? pic_false_value(pic) : pic_blob_value(pic, img->buf, (int)img->len);
+  img->units = pic_cons(pic, blob, img->units);
+}
+
+void
+pic_dump_begin(pic_state *pic)
+{
+  pic->image = make_image(pic, IMAGE_DUMP);
+}
+
+pic_value
+pic_dump_end(pic_state *pic)
+{
+  struct image *img = pic_data(pic, pic->image);
+  pic_value units = pic_reverse(pic, img->units);
+
+  pic->image = pic_undef_value(pic);
+  return units;
+}
+
+/* replaying */
+
+static size_t
+get_uint(struct image *img)
+{
+  size_t n = 0;
+  int shift = 0;
+
+  while (*img->ip & 0x80) {
+    n |= (size_t)(*img->ip++ & 0x7f) << shift;
+    shift += 7;
+  }
+  return n | (size_t)*img->ip++ << shift;
+}
+
+static int
+get_int(struct image *img)
+{
+  size_t n = get_uint(img);
+
+  return n & 1 ? -(int)(n >> 1) - 1 : (int)(n >> 1);
+}
+
+static const char *
+get_bytes(struct image *img, int *len)
+{
+  const char *p;
+
+  *len = (int)get_uint(img);
+  p = (const char *)img->ip;
+  img->ip += *len;
+  return p;
+}
+
+static double
+get_float(struct image *img)
+{
+  double f;
+
+  memcpy(&f, img->ip, sizeof(double));
+  img->ip += sizeof(double);
+  return f;
+}
+
+static void *
+get_ptr(pic_state *pic, struct image *img)
+{
+  if (*img->ip++ == REF_NONE) {
+    return NULL;
+  }
+  return pic_obj_ptr(pic_vec_ref(pic, img->table, (int)get_uint(img)));
+}
+
+static pic_value
+get_ref(pic_state *pic, struct image *img)
+{
+  switch (*img->ip++) {
+  case REF_UNDEF:
+    return pic_undef_value(pic);
+  case REF_INVALID:
+    return pic_invalid_value(pic);
+  case REF_NIL:
+    return pic_nil_value(pic);
+  case REF_TRUE:
+    return pic_true_value(pic);
+  case REF_FALSE:
+    return pic_false_value(pic);
+  case REF_EOF:
+    return pic_eof_object(pic);
+  case REF_INT:
+    return pic_int_value(pic, get_int(img));
+  case REF_FLOAT:
+    return pic_float_value(pic, get_float(img));
+  case REF_CHAR:
+    return pic_char_value(pic, (char)*img->ip++);
+  default:
+    return pic_vec_ref(pic, img->table, (int)get_uint(img));
+  }
+}
+
+static void
+get_shell(pic_state *pic, struct image *img, int i)
+{
+  struct object *obj = NULL;
+  pic_value v;
+  const char *str;
+  int len, tag;
+
+  tag = img->tags[i] = *img->ip++;
+
+  switch (tag) {
+  case TAG_SYMBOL:
+    str = get_bytes(img, &len);
+    v = pic_intern_str(pic, str, len);
+    break;
+  case TAG_STRING:
+    str = get_bytes(img, &len);
+    v = pic_str_value(pic, str, len);
+    break;
+  case TAG_BLOB:
+    str = get_bytes(img, &len);
+    v = pic_blob_value(pic, (const unsigned char *)str, len);
+    break;
+  case TAG_PAIR:
+    v = pic_cons(pic, pic_undef_value(pic), pic_undef_value(pic));
+    break;
+  case TAG_VECTOR:
+    v = pic_make_vec(pic, (int)get_uint(img), NULL);
+    break;
+  case TAG_ID:
+    obj = pic_obj_alloc(pic, sizeof(struct identifier), PIC_TYPE_ID);
+    ((struct identifier *)obj)->u.id = NULL;
+    ((struct identifier *)obj)->env = NULL;
+    v = pic_obj_value(obj);
+    break;
+  case TAG_LIBENV: {
+    pic_value name;
+
+    str = get_bytes(img, &len);
+    name = pic_str_value(pic, str, len);
+    if (! pic_find_library(pic, pic_str(pic, name))) {
+      pic_make_library(pic, pic_str(pic, name));
+    }
+    v = pic_library_environment(pic, pic_str(pic, name));
+    break;
+  }
+  case TAG_ENV:
+    obj = pic_obj_alloc(pic, sizeof(struct env), PIC_TYPE_ENV);
+    ((struct env *)obj)->up = NULL;
+    ((struct env *)obj)->lib = NULL;
+    kh_init(env, &((struct env *)obj)->map);
+    v = pic_obj_value(obj);
+    break;
+  case TAG_PROC:
+    obj = pic_obj_alloc(pic, offsetof(struct proc, locals), PIC_TYPE_IREP);
+    ((struct proc *)obj)->u.i.irep = NULL;
+    ((struct proc *)obj)->u.i.cxt = NULL;
+    v = pic_obj_value(obj);
+    break;
+  case TAG_CXT: {
+    struct context *cxt;
+    int regc = (int)get_uint(img), j;
+
+    cxt = (struct context *)pic_obj_alloc(pic, offsetof(struct context, storage) + sizeof(pic_value) * regc, PIC_TYPE_CXT);
+    cxt->regc = regc;
+    cxt->regs = cxt->storage;
+    cxt->up = NULL;
+    for (j = 0; j < regc; ++j) {
+      cxt->storage[j] = pic_undef_value(pic);
+    }
+    v = pic_obj_value(cxt);
+    break;
+  }
+  case TAG_IREP: {
+    struct irep *irep;
+
+    irep = pic_malloc(pic, sizeof(struct irep));
+    irep->list.next = irep->list.prev = 0;
+    irep->refc = 1;
+    irep->argc = (int)get_uint(img);
+    irep->localc = (int)get_uint(img);
+    irep->capturec = (int)get_uint(img);
+    irep->varg = *img->ip++;
+    irep->ncode = get_uint(img);
+    irep->nnums = get_uint(img);
+    irep->npool = get_uint(img);
+    irep->nirep = get_uint(img);
+    irep->code = pic_malloc(pic, irep->ncode);
+    irep->nums = pic_malloc(pic, sizeof(double) * irep->nnums);
+    irep->pool = pic_malloc(pic, sizeof(struct object *) * irep->npool);
+    irep->irep = pic_malloc(pic, sizeof(struct irep *) * irep->nirep);
+    img->ireps[i] = irep;
+    return;
+  }
+  default:
+    PIC_UNREACHABLE();
+  }
+  pic_vec_set(pic, img->table, i, v);
+}
+
+static void
+get_fill(pic_state *pic, struct image *img, int i)
+{
+  pic_value v = pic_vec_ref(pic, img->table, i);
+  int j;
+
+  switch (img->tags[i]) {
+  case TAG_PAIR:
+    pic_pair_ptr(pic, v)->car = get_ref(pic, img);
+    pic_pair_ptr(pic, v)->cdr = get_ref(pic, img);
+    break;
+  case TAG_VECTOR:
+    for (j = 0; j < pic_vec_len(pic, v); ++j) {
+      pic_vec_ptr(pic, v)->data[j] = get_ref(pic, img);
+    }
+    break;
+  case TAG_ID: {
+    struct identifier *id = (struct identifier *)pic_obj_ptr(v);
+    id->u.id = get_ptr(pic, img);
+    id->env = get_ptr(pic, img);
+    break;
+  }
+  case TAG_ENV: {
+    struct env *env = (struct env *)pic_obj_ptr(v);
+    struct identifier *key;
+    int n, it, ret;
+
+    env->up = get_ptr(pic, img);
+    env->lib = get_ptr(pic, img);
+    n = (int)get_uint(img);
+    while (n-- > 0) {
+      key = get_ptr(pic, img);
+      it = kh_put(env, &env->map, key, &ret);
+      kh_val(&env->map, it) = get_ptr(pic, img);
+    }
+    break;
+  }
+  case TAG_PROC: {
+    struct proc *proc = (struct proc *)pic_obj_ptr(v);
+    proc->u.i.irep = img->ireps[get_uint(img)];
+    proc->u.i.cxt = get_ptr(pic, img);
+    pic_irep_incref(pic, proc->u.i.irep);
+    break;
+  }
+  case TAG_CXT: {
+    struct context *cxt = (struct context *)pic_obj_ptr(v);
+    for (j = 0; j < cxt->regc; ++j) {
+      cxt->storage[j] = get_ref(pic, img);
+    }
+    cxt->up = get_ptr(pic, img);
+    break;
+  }
+  case TAG_IREP: {
+    struct irep *irep = img->ireps[i];
+    size_t k;
+
+    memcpy(irep->code, img->ip, irep->ncode);
+    img->ip += irep->ncode;
+    for (k = 0; k < irep->nnums; ++k) {
+      irep->nums[k] = get_float(img);
+    }
+    for (k = 0; k < irep->npool; ++k) {
+      if (*img->ip++) {
+        irep->pool[k] = (struct object *)pic_global_cell(pic, pic_obj_value(get_ptr(pic, img)));
+      } else {
+        irep->pool[k] = get_ptr(pic, img);
+      }
+    }
+    for (k = 0; k < irep->nirep; ++k) {
+      irep->irep[k] = img->ireps[get_uint(img)];
+      pic_irep_incref(pic, irep->irep[k]);
+    }
+    if (irep->npool > 0) {
+      irep->list.next = pic->ireps.next;
+      irep->list.prev = &pic->ireps;
+      irep->list.next->prev = &irep->list;
+      irep->list.prev->next = &irep->list;
+    }
+    break;
+  }
+  }
+}
+
+static void
+get_batch(pic_state *pic, struct image *img)
+{
+  bool gc_enable = pic->gc_enable;
+  size_t ai = pic_enter(pic);
+  int n, i;
+
+  while (*img->ip == 'B') {
+    img->ip++;
+    n = (int)get_uint(img);
+
+    /* shells are not safe to mark until they are filled */
+    pic->gc_enable = false;
+    for (i = 0; i < n; ++i) {
+      get_shell(pic, img, img->count + i);
+    }
+    for (i = 0; i < n; ++i) {
+      get_fill(pic, img, img->count + i);
+    }
+    pic->gc_enable = gc_enable;
+
+    img->count += n;
+    pic_leave(pic, ai);
+  }
+}
+
+static void
+skip_payload(pic_state *pic, struct image *img)
+{
+  int n;
+
+  get_uint(img);
+  n = (int)get_uint(img);
+  while (n-- > 0) {
+    img->ip++;
+    get_ref(pic, img);
+    get_ref(pic, img);
+    get_ref(pic, img);
+  }
+  get_uint(img);
+}
+
+static void
+replay_effect(pic_state *pic, int kind, pic_value a, pic_value b, pic_value c)
+{
+  switch (kind) {
+  case PIC_IMAGE_PUT:
+    pic_put_identifier(pic, a, b, c);
+    break;
+  case PIC_IMAGE_MACRO:
+    if (pic_weak_has(pic, pic->macros, a)) {
+      pic_warnf(pic, "redefining syntax variable: %s", pic_sym(pic, a));
+    }
+    pic_weak_set(pic, pic->macros, a, b);
+    break;
+  case PIC_IMAGE_SHADOW:
+    if (pic_weak_has(pic, pic->macros, a)) {
+      pic_weak_del(pic, pic->macros, a);
+    }
+    break;
+  case PIC_IMAGE_DEFINE: {
+    struct cell *cell = pic_global_cell(pic, a);
+
+    if (cell->defined) {
+      pic_warnf(pic, "redefining variable: %s", pic_sym(pic, a));
+      cell->templ = pic_false_value(pic);
+    }
+    cell->defined = true;
+    cell->value = pic_invalid_value(pic);
+    break;
+  }
+  case PIC_IMAGE_SET: {
+    struct cell *cell = pic_global_cell(pic, a);
+
+    cell->value = b;
+    pic_gc_write_barrier(pic, (struct object *)cell, b);
+    break;
+  }
+  case PIC_IMAGE_INLINE: {
+    struct cell *cell = pic_global_cell(pic, a);
+
+    cell->templ = b;
+    pic_gc_write_barrier(pic, (struct object *)cell, b);
+    break;
+  }
+  case PIC_IMAGE_LIBRARY:
+    if (! pic_find_library(pic, pic_str(pic, a))) {
+      pic_make_library(pic, pic_str(pic, a));
+    }
+    break;
+  case PIC_IMAGE_EXPORT:
+    pic_library_export(pic, pic_str(pic, a), b, c);
+    break;
+  }
+}
+
+static pic_value
+load_enter(pic_state *pic, struct image *img, pic_value program, const char *lib)
+{
+  pic_value form, a, b, c;
+  const char *name;
+  int kind, depth, len, n;
+  size_t ucnt;
+
+  depth = img->depth++;
+
+  if (img->off) {
+    return pic_false_value(pic);
+  }
+
+  get_batch(pic, img);
+  if (*img->ip != 'S') {
+    goto off;
+  }
+  img->ip++;
+  kind = *img->ip++;
+  if ((int)get_uint(img) != depth) {
+    goto off;
+  }
+  form = get_ref(pic, img);
+  name = get_bytes(img, &len);
+  if (! pic_eq_p(pic, form, program) || strlen(lib) != (size_t)len || memcmp(lib, name, len) != 0) {
+    goto off;
+  }
+  if (kind == KIND_SOURCE) {
+    return pic_false_value(pic);
+  }
+
+  get_batch(pic, img);
+  img->ip++;                    /* 'P' */
+  ucnt = get_uint(img);
+  if (ucnt != (size_t)pic->ucnt) {
+    skip_payload(pic, img);
+    goto off;
+  }
+  ucnt = get_uint(img);
+  n = (int)get_uint(img);
+  while (n-- > 0) {
+    kind = *img->ip++;
+    a = get_ref(pic, img);
+    b = get_ref(pic, img);
+    c = get_ref(pic, img);
+    replay_effect(pic, kind, a, b, c);
+  }
+  pic->ucnt = (int)ucnt;
+
+  return pic_make_proc_irep(pic, img->ireps[get_uint(img)], NULL);
+
+ off:
+  img->off = true;
+  return pic_false_value(pic);
+}
+
+/* moves to the next toplevel form; returns false at the end of the image */
+static bool
+next_toplevel(pic_state *pic, struct image *img, pic_value *form)
+{
+  const unsigned char *ip;
+  int depth, len;
+
+  while (1) {
+    get_batch(pic, img);
+
+    switch (*img->ip) {
+    case 'E':
+      return false;
+    case 'P':
+      img->ip++;
+      get_uint(img);
+      skip_payload(pic, img);
+      break;
+    case 'S':
+      ip = img->ip;
+      img->ip += 2;
+      depth = (int)get_uint(img);
+      *form = get_ref(pic, img);
+      get_bytes(img, &len);
+      if (depth == 0) {
+        if (! img->off) {
+          img->ip = ip;         /* left for load_enter */
+        }
+        return true;
+      }
+      break;
+    default:
+      PIC_UNREACHABLE();
+    }
+  }
+}
+
+static void
+load_unit(pic_state *pic, struct image *img)
+{
+  pic_value form;
+  size_t ai = pic_enter(pic);
+
+  img->active = true;
+
+  while (next_toplevel(pic, img, &form)) {
+    pic_eval(pic, form, pic_current_library(pic));
+
+    pic_leave(pic, ai);
+  }
+}
+
+static void
+release_ireps(pic_state *pic, struct image *img)
+{
+  int i;
+
+  for (i = 0; i < img->count; ++i) {
+    if (img->tags[i] == TAG_IREP) {
+      pic_irep_decref(pic, img->ireps[i]);
+    }
+  }
+  img->count = 0;
+}
+
+void
+pic_load_image(pic_state *pic, const unsigned char *image, const char *src)
+{
+  pic_value prev = pic->image, e;
+  struct image *img;
+
+  if (pic_data_p(pic, prev, &image_type) && ((struct image *)pic_data(pic, prev))->mode == IMAGE_DUMP) {
+    dump_unit(pic, pic_data(pic, prev), src);
+    return;
+  }
+  if (image == NULL || memcmp(image, "PIMG", 4) != 0 || image[4] != IMAGE_VERSION) {
+    pic_load_cstr(pic, src);
+    return;
+  }
+
+  pic->image = make_image(pic, IMAGE_LOAD);
+  img = pic_data(pic, pic->image);
+  img->ip = image + 5;
+  img->size = (int)get_uint(img);
+  img->table = pic_make_vec(pic, img->size, NULL);
+  img->ireps = pic_calloc(pic, img->size, sizeof(struct irep *));
+  img->tags = pic_calloc(pic, img->size, 1);
+
+  pic_try {
+    load_unit(pic, img);
+  }
+  pic_catch(e) {
+    release_ireps(pic, img);
+    pic->image = prev;
+    pic_raise(pic, e);
+  }
+  release_ireps(pic, img);
+  pic->image = prev;
+}
+
+pic_value
+pic_image_enter(pic_state *pic, pic_value program, const char *lib)
+{
+  struct image *img = current_image(pic);
+
+  if (img == NULL) {
+    return pic_false_value(pic);
+  }
+  if (img->mode == IMAGE_LOAD) {
+    return load_enter(pic, img, program, lib);
+  }
+  dump_enter(pic, img, program, lib);
+  return pic_false_value(pic);
+}
+
+void
+pic_image_prepared(pic_state *pic, pic_value proc)
+{
+  struct image *img = current_image(pic);
+
+  if (img != NULL && img->mode == IMAGE_DUMP) {
+    dump_prepared(pic, img, proc);
+  }
+}
+
+void
+pic_image_leave(pic_state *pic)
+{
+  struct image *img = current_image(pic);
+
+  if (img != NULL) {
+    img->depth--;
+  }
+}
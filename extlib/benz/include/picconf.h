@@ -16,6 +16,12 @@
 /* #define PIC_SETJMP(pic, buf) setjmp(buf) */
 /* #define PIC_LONGJMP(pic, buf, val) longjmp((buf), (val)) */
 /* #define PIC_ABORT(pic) abort() */
+/* #define PIC_CLOCK(pic) ((double)clock() / CLOCKS_PER_SEC) */
 
 /** I/O configuration */
 /* #define PIC_BUFSIZ 1024 */
+
+/** garbage collection */
+/* #define PIC_GENERATIONAL_GC 0 */
+/* #define PIC_INCREMENTAL_GC 0 */
+/* #define PIC_GC_BUDGET 64 */
@@ -64,16 +64,19 @@ void *pic_calloc(pic_state *, size_t, size_t);
 void pic_free(pic_state *, void *);
 
 typedef pic_value (*pic_func_t)(pic_state *);
+typedef pic_value (*pic_native_t)(pic_state *, int argc, pic_value *argv);
 
 void *pic_alloca(pic_state *, size_t);
 size_t pic_enter(pic_state *);
 void pic_leave(pic_state *, size_t);
 pic_value pic_protect(pic_state *, pic_value);
 void pic_gc(pic_state *);
+int pic_gc_budget(pic_state *, int budget); /* returns the old budget; negative only queries */
 
 int pic_get_args(pic_state *, const char *fmt, ...);
 
 void pic_defun(pic_state *, const char *name, pic_func_t f);
+void pic_defun_sig(pic_state *, const char *name, const char *sig, pic_native_t f);
 void pic_defvar(pic_state *, const char *name, pic_value v, pic_value conv);
 void pic_define(pic_state *, const char *lib, const char *name, pic_value v);
 pic_value pic_ref(pic_state *, const char *lib, const char *name);
@@ -170,9 +173,12 @@ enum {
   PIC_TYPE_CXT     = 30,
   PIC_TYPE_CP      = 31,
   PIC_TYPE_FUNC    = 32,
-  PIC_TYPE_IREP    = 33
+  PIC_TYPE_IREP    = 33,
+  PIC_TYPE_CELL    = 34
 };
 
+#define PIC_TYPE_MAX PIC_TYPE_CELL
+
 #define pic_invalid_p(pic,v) (pic_type(pic,v) == PIC_TYPE_INVALID)
 #define pic_undef_p(pic,v) (pic_type(pic,v) == PIC_TYPE_UNDEF)
 #define pic_int_p(pic,v) (pic_type(pic,v) == PIC_TYPE_INT)
@@ -246,12 +252,14 @@ pic_value pic_weak_ref(pic_state *, pic_value weak, pic_value key);
 void pic_weak_set(pic_state *, pic_value weak, pic_value key, pic_value val);
 void pic_weak_del(pic_state *, pic_value weak, pic_value key);
 bool pic_weak_has(pic_state *, pic_value weak, pic_value key);
+int pic_weak_size(pic_state *, pic_value weak);
+bool pic_weak_next(pic_state *, pic_value weak, int *iter, pic_value *key, pic_value *val);
 
 /* symbol */
 pic_value pic_intern(pic_state *, pic_value str);
-#define pic_intern_str(pic,s,i) pic_intern(pic, pic_str_value(pic, (s), (i)))
-#define pic_intern_cstr(pic,s) pic_intern(pic, pic_cstr_value(pic, (s)))
-#define pic_intern_lit(pic,lit) pic_intern(pic, pic_lit_value(pic, lit))
+pic_value pic_intern_str(pic_state *, const char *str, int len);
+#define pic_intern_cstr(pic,s) pic_intern_str(pic, (s), strlen(s))
+#define pic_intern_lit(pic,lit) pic_intern_str(pic, "" lit, -((int)sizeof lit - 1))
 pic_value pic_sym_name(pic_state *, pic_value sym);
 
 /* string */
@@ -262,6 +270,31 @@ pic_value pic_str_sub(pic_state *, pic_value str, int i, int j);
 int pic_str_cmp(pic_state *, pic_value str1, pic_value str2);
 int pic_str_hash(pic_state *, pic_value str);
 
+/* garbage collector */
+struct pic_gc_stats {
+  unsigned long collections;    /* completed collections */
+  unsigned long minor_collections; /* of which were minor (generational GC only) */
+  double total_pause;           /* seconds spent in the collector */
+  double max_pause;             /* longest single pause in seconds */
+  size_t allocated[PIC_TYPE_MAX + 1]; /* bytes allocated so far by type */
+  size_t live;                  /* bytes in use after the last collection */
+  size_t heap;                  /* bytes of heap pages */
+  size_t pages;                 /* number of heap pages */
+  size_t weak_maps;             /* weak maps seen by the last collection */
+  size_t weak_entries;          /* entries left in them */
+};
+
+typedef void (*pic_gcf)(pic_state *, const struct pic_gc_stats *);
+
+void pic_gc_stats(pic_state *, struct pic_gc_stats *);
+pic_gcf pic_atgc(pic_state *, pic_gcf f); /* f is called after each collection and must not allocate */
+
+/* sampling */
+typedef void (*pic_samplef)(pic_state *);
+
+pic_samplef pic_atsample(pic_state *, int period, pic_samplef f); /* f is called on every period-th procedure call or backward jump and must not allocate */
+void pic_sample_soon(pic_state *); /* sample at the next call or backward jump; safe to use from a signal handler */
+
 
 
 /* External I/O */
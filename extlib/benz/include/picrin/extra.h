@@ -20,9 +20,25 @@ pic_value pic_read_cstr(pic_state *, const char *);
 pic_value pic_expand(pic_state *, pic_value program, pic_value env);
 pic_value pic_eval(pic_state *, pic_value program, const char *lib);
 
+enum {
+  PIC_OPT_BETA = 1,             /* ((lambda (x ...) body) e ...) to defines */
+  PIC_OPT_INLINE = 2,           /* calls to small known procedures */
+  PIC_OPT_PROPAGATE = 4,        /* locals bound once to a constant */
+  PIC_OPT_FOLD = 8,             /* built-in procedures applied to constants */
+  PIC_OPT_DCE = 16,             /* dead if branches and unused bindings */
+  PIC_OPT_LIFT = 32,            /* lambda lifting */
+  PIC_OPT_ALL = 63
+};
+
+int pic_optimize_passes(pic_state *, int passes); /* returns the old set; negative only queries */
+
 void pic_load(pic_state *, pic_value port);
 void pic_load_cstr(pic_state *, const char *);
 
+void pic_load_image(pic_state *, const unsigned char *image, const char *src);
+void pic_dump_begin(pic_state *);
+pic_value pic_dump_end(pic_state *);
+
 #define pic_stdin(pic) pic_funcall(pic, "picrin.base", "current-input-port", 0)
 #define pic_stdout(pic) pic_funcall(pic, "picrin.base", "current-output-port", 0)
 #define pic_stderr(pic) pic_funcall(pic, "picrin.base", "current-error-port", 0)
@@ -30,6 +46,8 @@ void pic_load_cstr(pic_state *, const char *);
 #if PIC_USE_STDIO
 pic_value pic_fopen(pic_state *, FILE *, const char *mode);
 #endif
+/* output memory ports only append: buf and len are ignored, and seeking
+   anywhere but the current end fails with -1 */
 pic_value pic_fmemopen(pic_state *, const char *buf, int len, const char *mode);
 int pic_fgetbuf(pic_state *, pic_value port, const char **buf, int *len);
 
@@ -59,15 +77,15 @@ int pic_fgetbuf(pic_state *, pic_value port, const char **buf, int *len);
 #define pic_try pic_try_(PIC_GENSYM(cont), PIC_GENSYM(jmp))
 #define pic_try_(cont, jmp)                                             \
   do {                                                                  \
-    extern pic_value pic_start_try(pic_state *, PIC_JMPBUF *);          \
-    extern void pic_end_try(pic_state *, pic_value);                    \
+    extern void pic_start_try(pic_state *, PIC_JMPBUF *);               \
+    extern void pic_end_try(pic_state *);                               \
     extern pic_value pic_err(pic_state *);                              \
     PIC_JMPBUF jmp;                                                     \
     if (PIC_SETJMP(pic, jmp) == 0) {                                    \
-      pic_value pic_try_cookie_ = pic_start_try(pic, &jmp);
+      pic_start_try(pic, &jmp);
 #define pic_catch(e) pic_catch_(e, PIC_GENSYM(label))
 #define pic_catch_(e, label)                              \
-      pic_end_try(pic, pic_try_cookie_);                  \
+      pic_end_try(pic);                                   \
     } else {                                              \
       e = pic_err(pic);                                   \
       goto label;                                         \
@@ -80,6 +98,8 @@ int pic_fgetbuf(pic_state *, pic_value port, const char **buf, int *len);
 
 void pic_warnf(pic_state *, const char *, ...);
 pic_value pic_get_backtrace(pic_state *);
+pic_value pic_error_backtrace(pic_state *, pic_value err);
+int pic_backtrace_depth(pic_state *, int depth); /* returns the old depth; 0 disables capture, negative only queries */
 #if PIC_USE_WRITE
 void pic_print_error(pic_state *, pic_value port, pic_value err);
 #endif
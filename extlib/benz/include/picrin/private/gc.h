@@ -9,18 +9,48 @@
 extern "C" {
 #endif
 
+#if PIC_GENERATIONAL_GC
+# define GC_GENERATION_HEADER                    \
+  char gc_remembered;
+#else
+# define GC_GENERATION_HEADER
+#endif
+
 #if PIC_BITMAP_GC
 # define OBJECT_HEADER                           \
-  unsigned char tt;
+  unsigned char tt;                              \
+  char gc_waiting;                               \
+  GC_GENERATION_HEADER
 #else
 # define OBJECT_HEADER                           \
   unsigned char tt;                              \
-  char gc_mark;
+  char gc_mark;                                  \
+  char gc_waiting;                               \
+  GC_GENERATION_HEADER
 #endif
 
+struct object;
+
 struct heap *pic_heap_open(pic_state *);
 void pic_heap_close(pic_state *, struct heap *);
 
+/*
+ * Write barrier for the generational and incremental collectors. Every
+ * store of a value into a heap object that may already have survived a
+ * collection (or been marked by a running one) must go through
+ * pic_gc_write_barrier; pic_gc_remember is for bulk stores where checking
+ * each value would cost more than rescanning the object.
+ */
+#if PIC_GENERATIONAL_GC || PIC_INCREMENTAL_GC
+void pic_gc_write_barrier(pic_state *, struct object *, pic_value);
+void pic_gc_remember(pic_state *, struct object *);
+void pic_gc_track_data(pic_state *, struct object *);
+#else
+# define pic_gc_write_barrier(pic, obj, v) ((void)(pic), (void)(obj), (void)(v))
+# define pic_gc_remember(pic, obj) ((void)(pic), (void)(obj))
+# define pic_gc_track_data(pic, obj) ((void)(pic), (void)(obj))
+#endif
+
 #if defined(__cplusplus)
 }
 #endif
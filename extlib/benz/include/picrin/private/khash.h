@@ -56,6 +56,32 @@
   int kh_put_##name(pic_state *, kh_##name##_t *h, khkey_t key, int *ret); \
   void kh_del_##name(kh_##name##_t *h, int x);
 
+#define KHASH_GET_FUNC(fname, name, khkey_t, hash_func, hash_equal)     \
+  int fname(pic_state *pic, const kh_##name##_t *h, khkey_t key)        \
+  {                                                                     \
+    (void)pic;                                                          \
+    if (h->n_buckets) {                                                 \
+      int k, i, last, mask, step = 0;                                   \
+      mask = h->n_buckets - 1;                                          \
+      k = hash_func(key); i = k & mask;                                 \
+      last = i;                                                         \
+      while (!ac_isempty(h->flags, i) && (ac_isdel(h->flags, i) || !hash_equal(h->keys[i], key))) { \
+        i = (i + (++step)) & mask;                                      \
+        if (i == last) return h->n_buckets;                             \
+      }                                                                 \
+      return ac_iseither(h->flags, i)? h->n_buckets : i;		\
+    } else return 0;                                                    \
+  }
+
+/*
+ * kh_get_by(name, by, h, k) looks k up in a table of name through another
+ * representation of its keys, such as the bytes of a string key. hash_func
+ * must give k the hash the table gives the key equal to it, and
+ * hash_equal(key, k) compares a stored key with k.
+ */
+#define KHASH_DEFINE_GET_BY(name, by, lookup_t, hash_func, hash_equal)   \
+  static KHASH_GET_FUNC(kh_get_##name##_##by, name, lookup_t, hash_func, hash_equal)
+
 #define KHASH_DEFINE(name, khkey_t, khval_t, hash_func, hash_equal)     \
   KHASH_DEFINE2(name, khkey_t, khval_t, 1, hash_func, hash_equal)
 #define KHASH_DEFINE2(name, khkey_t, khval_t, kh_is_map, hash_func, hash_equal) \
@@ -75,21 +101,7 @@
       h->size = h->n_occupied = 0;                                      \
     }                                                                   \
   }                                                                     \
-  int kh_get_##name(pic_state *pic, const kh_##name##_t *h, khkey_t key) \
-  {                                                                     \
-    (void)pic;                                                          \
-    if (h->n_buckets) {                                                 \
-      int k, i, last, mask, step = 0;                                   \
-      mask = h->n_buckets - 1;                                          \
-      k = hash_func(key); i = k & mask;                                 \
-      last = i;                                                         \
-      while (!ac_isempty(h->flags, i) && (ac_isdel(h->flags, i) || !hash_equal(h->keys[i], key))) { \
-        i = (i + (++step)) & mask;                                      \
-        if (i == last) return h->n_buckets;                             \
-      }                                                                 \
-      return ac_iseither(h->flags, i)? h->n_buckets : i;		\
-    } else return 0;                                                    \
-  }                                                                     \
+  KHASH_GET_FUNC(kh_get_##name, name, khkey_t, hash_func, hash_equal) \
   void kh_resize_##name(pic_state *pic, kh_##name##_t *h, int new_n_buckets) \
   { /* This function uses 0.25*n_buckets bytes of working space instead of [sizeof(key_t+val_t)+.25]*n_buckets. */ \
     int *new_flags = 0;                                                 \
@@ -220,6 +232,7 @@ PIC_INLINE int kh_str_hash_func(const char *s) {
 #define kh_resize(name, h, s) kh_resize_##name(pic, h, s)
 #define kh_put(name, h, k, r) kh_put_##name(pic, h, k, r)
 #define kh_get(name, h, k) kh_get_##name(pic, h, k)
+#define kh_get_by(name, by, h, k) kh_get_##name##_##by(pic, h, k)
 #define kh_del(name, h, k) kh_del_##name(h, k)
 
 #define kh_exist(h, x) (!ac_iseither((h)->flags, (x)))
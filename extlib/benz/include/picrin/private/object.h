@@ -13,13 +13,14 @@ extern "C" {
 #include "picrin/private/khash.h"
 #include "picrin/private/gc.h"
 
-typedef struct identifier symbol;
+typedef struct symbol symbol;
 
 KHASH_DECLARE(env, struct identifier *, symbol *)
 KHASH_DECLARE(dict, symbol *, pic_value)
 KHASH_DECLARE(weak, struct object *, pic_value)
 
 struct object;              /* defined in gc.c */
+struct trace;               /* defined in debug.c */
 
 struct basic {
   OBJECT_HEADER
@@ -34,6 +35,13 @@ struct identifier {
   struct env *env;
 };
 
+struct symbol {
+  OBJECT_HEADER
+  struct string *str;           /* NULL until an uninterned symbol is named */
+  struct string *base;          /* uninterned symbols print as .base.num */
+  int num;
+};
+
 struct env {
   OBJECT_HEADER
   khash_t(env) map;
@@ -93,8 +101,12 @@ struct proc {
   OBJECT_HEADER
   union {
     struct {
-      pic_func_t func;
+      pic_func_t func;          /* holds a pic_native_t when sig is set */
       int localc;
+      unsigned char reqc, optc; /* arity parsed from sig */
+      char rest;                /* type of the rest arguments, 0 if none */
+      bool typed;               /* sig checks something besides arity */
+      const char *sig;          /* NULL unless defined by pic_defun_sig */
     } f;
     struct {
       struct irep *irep;
@@ -115,7 +127,8 @@ struct error {
   symbol *type;
   struct string *msg;
   pic_value irrs;
-  struct string *stack;
+  struct string *stack;         /* formatted from trace on first use */
+  struct trace *trace;          /* NULL when no frames were recorded */
 };
 
 struct port {
@@ -123,6 +136,17 @@ struct port {
   struct file file;
 };
 
+struct cell {
+  OBJECT_HEADER
+  pic_value value;              /* invalid until initialized */
+  symbol *uid;
+  bool defined;
+  pic_value templ;              /* lambda calls may be inlined with,
+                                   #f once assigned */
+  int vm_proc;                  /* instruction calls may compile to,
+                                   -1 if none, -2 until looked up */
+};
+
 struct checkpoint {
   OBJECT_HEADER
   struct proc *in;
@@ -131,6 +155,23 @@ struct checkpoint {
   struct checkpoint *prev;
 };
 
+struct cont {
+  PIC_JMPBUF *jmp;
+
+  struct checkpoint *cp;
+  ptrdiff_t sp_offset;
+  ptrdiff_t ci_offset;
+  size_t arena_idx;
+  pic_value handlers;           /* exception handler stack at entry */
+  pic_value trap;               /* handler stack pushed by a try block, or #f */
+  pic_value prompts;            /* active resets at entry */
+
+  int retc;
+  pic_value *retv;
+
+  struct cont *prev;
+};
+
 struct object *pic_obj_ptr(pic_value);
 
 #define pic_id_ptr(pic, o) (assert(pic_id_p(pic, o)), (struct identifier *)pic_obj_ptr(o))
@@ -147,11 +188,13 @@ struct object *pic_obj_ptr(pic_value);
 #define pic_port_ptr(pic, o) (assert(pic_port_p(pic, o)), (struct port *)pic_obj_ptr(o))
 #define pic_error_ptr(pic, o) (assert(pic_error_p(pic, o)), (struct error *)pic_obj_ptr(o))
 #define pic_rec_ptr(pic, o) (assert(pic_rec_p(pic, o)), (struct record *)pic_obj_ptr(o))
+#define pic_cell_ptr(pic, o) (assert(pic_cell_p(pic, o)), (struct cell *)pic_obj_ptr(o))
 
 #define pic_obj_p(pic,v) (pic_type(pic,v) > PIC_IVAL_END)
 #define pic_env_p(pic, v) (pic_type(pic, v) == PIC_TYPE_ENV)
 #define pic_error_p(pic, v) (pic_type(pic, v) == PIC_TYPE_ERROR)
 #define pic_rec_p(pic, v) (pic_type(pic, v) == PIC_TYPE_RECORD)
+#define pic_cell_p(pic, v) (pic_type(pic, v) == PIC_TYPE_CELL)
 
 pic_value pic_obj_value(void *ptr);
 struct object *pic_obj_alloc(pic_state *, size_t, int type);
@@ -195,9 +238,34 @@ pic_value pic_add_identifier(pic_state *, pic_value id, pic_value env);
 void pic_put_identifier(pic_state *, pic_value id, pic_value uid, pic_value env);
 pic_value pic_find_identifier(pic_state *, pic_value id, pic_value env);
 pic_value pic_id_name(pic_state *, pic_value id);
+pic_value pic_make_uid(pic_state *, pic_value name);
+#define pic_sym_interned_p(pic, sym) (pic_sym_ptr(pic, sym)->base == NULL)
+
+struct cell *pic_global_cell(pic_state *, pic_value uid);
+bool pic_global_defined_p(pic_state *, pic_value uid);
 
 struct rope *pic_rope_incref(struct rope *);
 void pic_rope_decref(pic_state *, struct rope *);
+bool pic_str_eq_buf(pic_state *, pic_value str, const char *buf, int len);
+int pic_str_hash_buf(const char *buf, int len);
+
+struct strbuf {
+  struct rope *rope;
+  int len, capa;
+};
+
+#define PIC_STRBUF_INIT { NULL, 0, 0 }
+
+void pic_strbuf_write(pic_state *, struct strbuf *, const char *buf, int len);
+void pic_strbuf_putc(pic_state *, struct strbuf *, int c);
+void pic_strbuf_vprintf(pic_state *, struct strbuf *, const char *fmt, va_list ap);
+pic_value pic_strbuf_value(pic_state *, struct strbuf *);
+void pic_strbuf_destroy(pic_state *, struct strbuf *);
+pic_value pic_strbuf_port(pic_state *, struct strbuf *);
+void pic_strbuf_port_close(pic_state *, struct strbuf *, pic_value port);
+
+struct trace *pic_trace_capture(pic_state *);
+void pic_trace_free(pic_state *, struct trace *);
 
 #define pic_func_p(pic, proc) (pic_type(pic, proc) == PIC_TYPE_FUNC)
 #define pic_irep_p(pic, proc) (pic_type(pic, proc) == PIC_TYPE_IREP)
@@ -206,12 +274,16 @@ struct cont *pic_alloca_cont(pic_state *);
 pic_value pic_make_cont(pic_state *, struct cont *);
 void pic_save_point(pic_state *, struct cont *, PIC_JMPBUF *);
 void pic_exit_point(pic_state *);
+void pic_load_point(pic_state *, struct cont *);
 void pic_wind(pic_state *, struct checkpoint *, struct checkpoint *);
 pic_value pic_dynamic_wind(pic_state *, pic_value in, pic_value thunk, pic_value out);
+pic_value pic_reset(pic_state *, pic_value thunk);
+pic_value pic_shift(pic_state *, pic_value proc);
 
 pic_value pic_dynamic_bind(pic_state *, pic_value var, pic_value val, pic_value thunk);
 
 pic_value pic_library_environment(pic_state *, const char *);
+void pic_library_export(pic_state *, const char *lib, pic_value alias, pic_value name);
 
 #if defined(__cplusplus)
 }
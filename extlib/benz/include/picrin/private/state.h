@@ -21,7 +21,7 @@ struct lib {
 
 struct callinfo {
   int argc, retc;
-  const struct code *ip;
+  const pic_code *ip;
   pic_value *fp;
   struct irep *irep;
   struct context *cxt;
@@ -30,7 +30,12 @@ struct callinfo {
   struct context *up;
 };
 
-KHASH_DECLARE(oblist, struct string *, struct identifier *)
+struct stack_block {
+  struct stack_block *prev;
+  pic_value *base;
+};
+
+KHASH_DECLARE(oblist, struct string *, struct symbol *)
 KHASH_DECLARE(ltable, const char *, struct lib)
 
 struct pic_state {
@@ -39,14 +44,20 @@ struct pic_state {
 
   struct checkpoint *cp;
   struct cont *cc;
+  pic_value handlers;           /* installed exception handlers, innermost first */
+  pic_value prompts;            /* active resets, innermost first */
 
   pic_value *sp;
   pic_value *stbase, *stend;
+  struct stack_block *stretired; /* outgrown stacks, freed at toplevel */
+  bool stoverflow;
 
   struct callinfo *ci;
   struct callinfo *cibase, *ciend;
 
-  const struct code *ip;
+  pic_samplef samplef;
+  int sample_period;             /* calls and loop iterations between samples */
+  volatile sig_atomic_t sample_count; /* left until the next, set by signal handlers */
 
   const char *lib;
 
@@ -54,7 +65,9 @@ struct pic_state {
 
   khash_t(oblist) oblist;       /* string to symbol */
   int ucnt;
-  pic_value globals;            /* weak */
+  int opt_passes;               /* PIC_OPT_* */
+  int backtrace_depth;          /* frames recorded in errors, 0 for none */
+  pic_value globals;            /* weak: uid to binding cell */
   pic_value macros;             /* weak */
   khash_t(ltable) ltable;
   struct list_head ireps;
@@ -66,9 +79,45 @@ struct pic_state {
 
   pic_value err;
 
+  pic_value image;              /* bytecode image being recorded or replayed */
+
   pic_panicf panicf;
 };
 
+void pic_vm_tear_off(pic_state *, struct callinfo *base);
+void pic_vm_grow(pic_state *, int sn, int cn);
+void pic_vm_recover(pic_state *);
+void pic_vm_release(pic_state *);
+pic_value pic_vm_resume(pic_state *, const pic_code *ip);
+
+extern const pic_code pic_vm_stop[];
+
+enum {
+  PIC_IMAGE_PUT,                /* id, uid, toplevel env */
+  PIC_IMAGE_MACRO,              /* uid, transformer */
+  PIC_IMAGE_SHADOW,             /* uid */
+  PIC_IMAGE_DEFINE,             /* uid */
+  PIC_IMAGE_SET,                /* uid, value */
+  PIC_IMAGE_LIBRARY,            /* name */
+  PIC_IMAGE_EXPORT,             /* library name, alias, name */
+  PIC_IMAGE_INLINE              /* uid, template */
+};
+
+pic_value pic_image_enter(pic_state *, pic_value program, const char *lib);
+void pic_image_prepared(pic_state *, pic_value proc);
+void pic_image_leave(pic_state *);
+void pic_image_effect(pic_state *, int kind, pic_value, pic_value, pic_value);
+bool pic_image_running(pic_state *);
+
+/* make room for sn more values and cn more callinfo frames */
+PIC_INLINE void
+pic_vm_reserve(pic_state *pic, int sn, int cn)
+{
+  if (pic->stend - pic->sp < sn || pic->ciend - pic->ci <= cn) {
+    pic_vm_grow(pic, sn, cn);
+  }
+}
+
 #if defined(__cplusplus)
 }
 #endif
@@ -0,0 +1,220 @@
+/**
+ * See Copyright Notice in picrin.h
+ */
+
+#ifndef PICRIN_VALUE_H
+#define PICRIN_VALUE_H
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*
+ * Inline versions of the value representation primitives. value.c builds
+ * the public API on top of these; the VM uses them directly on hot paths.
+ */
+
+#if PIC_NAN_BOXING
+
+/**
+ * value representation by nan-boxing:
+ *   float : FFFFFFFFFFFFFFFF FFFFFFFFFFFFFFFF FFFFFFFFFFFFFFFF FFFFFFFFFFFFFFFF
+ *   ptr   : 111111111111TTTT PPPPPPPPPPPPPPPP PPPPPPPPPPPPPPPP PPPPPPPPPPPPPPPP
+ *   int   : 111111111111TTTT 0000000000000000 IIIIIIIIIIIIIIII IIIIIIIIIIIIIIII
+ *   char  : 111111111111TTTT 0000000000000000 CCCCCCCCCCCCCCCC CCCCCCCCCCCCCCCC
+ */
+
+#define pic_init_value(v,vtype) (v = (0xfff0000000000000ul | ((uint64_t)(vtype) << 48)))
+
+PIC_INLINE int
+pic_vtype(pic_state *PIC_UNUSED(pic), pic_value v)
+{
+  return 0xfff0 >= (v >> 48) ? PIC_TYPE_FLOAT : ((v >> 48) & 0xf);
+}
+
+PIC_INLINE double
+pic_unbox_float(pic_value v)
+{
+  union { double f; uint64_t i; } u;
+  u.i = v;
+  return u.f;
+}
+
+PIC_INLINE int
+pic_unbox_int(pic_value v)
+{
+  union { int i; unsigned u; } u;
+  u.u = v & 0xfffffffful;
+  return u.i;
+}
+
+PIC_INLINE char
+pic_unbox_char(pic_value v)
+{
+  return v & 0xfffffffful;
+}
+
+PIC_INLINE pic_value
+pic_box_float(double f)
+{
+  union { double f; uint64_t i; } u;
+
+  if (f != f) {
+    return 0x7ff8000000000000ul;
+  } else {
+    u.f = f;
+    return u.i;
+  }
+}
+
+PIC_INLINE pic_value
+pic_box_int(int i)
+{
+  pic_value v;
+
+  pic_init_value(v, PIC_TYPE_INT);
+  v |= (unsigned)i;
+  return v;
+}
+
+PIC_INLINE pic_value
+pic_box_char(char c)
+{
+  pic_value v;
+
+  pic_init_value(v, PIC_TYPE_CHAR);
+  v |= (unsigned char)c;
+  return v;
+}
+
+#else
+
+#define pic_init_value(v,vtype) ((v).type = (vtype), (v).u.data = NULL)
+
+PIC_INLINE int
+pic_vtype(pic_state *PIC_UNUSED(pic), pic_value v)
+{
+  return (int)(v.type);
+}
+
+PIC_INLINE double
+pic_unbox_float(pic_value v)
+{
+  return v.u.f;
+}
+
+PIC_INLINE int
+pic_unbox_int(pic_value v)
+{
+  return v.u.i;
+}
+
+PIC_INLINE char
+pic_unbox_char(pic_value v)
+{
+  return v.u.c;
+}
+
+PIC_INLINE pic_value
+pic_box_float(double f)
+{
+  pic_value v;
+
+  pic_init_value(v, PIC_TYPE_FLOAT);
+  v.u.f = f;
+  return v;
+}
+
+PIC_INLINE pic_value
+pic_box_int(int i)
+{
+  pic_value v;
+
+  pic_init_value(v, PIC_TYPE_INT);
+  v.u.i = i;
+  return v;
+}
+
+PIC_INLINE pic_value
+pic_box_char(char c)
+{
+  pic_value v;
+
+  pic_init_value(v, PIC_TYPE_CHAR);
+  v.u.c = c;
+  return v;
+}
+
+#endif
+
+/* overflow-checked fixnum arithmetic; each returns false on overflow */
+
+#if defined(__has_builtin)
+# if __has_builtin(__builtin_add_overflow)
+#  define PIC_OVERFLOW_BUILTINS 1
+# endif
+#elif __GNUC__ >= 5
+# define PIC_OVERFLOW_BUILTINS 1
+#endif
+
+#if PIC_OVERFLOW_BUILTINS
+
+PIC_INLINE bool
+pic_checked_add(int a, int b, int *r)
+{
+  return ! __builtin_add_overflow(a, b, r);
+}
+
+PIC_INLINE bool
+pic_checked_sub(int a, int b, int *r)
+{
+  return ! __builtin_sub_overflow(a, b, r);
+}
+
+PIC_INLINE bool
+pic_checked_mul(int a, int b, int *r)
+{
+  return ! __builtin_mul_overflow(a, b, r);
+}
+
+#else
+
+PIC_INLINE bool
+pic_checked_add(int a, int b, int *r)
+{
+  if ((b > 0 && a > INT_MAX - b) || (b < 0 && a < INT_MIN - b)) {
+    return false;
+  }
+  *r = a + b;
+  return true;
+}
+
+PIC_INLINE bool
+pic_checked_sub(int a, int b, int *r)
+{
+  if ((b < 0 && a > INT_MAX + b) || (b > 0 && a < INT_MIN + b)) {
+    return false;
+  }
+  *r = a - b;
+  return true;
+}
+
+PIC_INLINE bool
+pic_checked_mul(int a, int b, int *r)
+{
+  double f = (double)a * (double)b; /* exact whenever the product fits */
+
+  if (f < INT_MIN || INT_MAX < f) {
+    return false;
+  }
+  *r = (int)f;
+  return true;
+}
+
+#endif
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif
@@ -34,6 +34,7 @@ enum {
   OP_TAILCALL,
   OP_RET,
   OP_LAMBDA,
+  OP_PROC,
   OP_CONS,
   OP_CAR,
   OP_CDR,
@@ -49,15 +50,79 @@ enum {
   OP_LE,
   OP_GT,
   OP_GE,
-  OP_STOP
-};
+  OP_EQP,
+  OP_EQVP,
+  OP_SETCAR,
+  OP_SETCDR,
+  OP_VECTORP,
+  OP_VREF,
+  OP_VSET,
+  OP_VLEN,
+  OP_STRINGP,
+  OP_SREF,
+  OP_SLEN,
+  OP_CHARP,
+  OP_CHAREQ,
+  OP_CHARLT,
+  OP_CHAR2INT,
+  OP_RECORDP,
+  OP_RECTYPE,
+  OP_RECDATUM,
+  OP_GTEMPL,
+  OP_STOP,
 
-struct code {
-  int insn;
-  int a;
-  int b;
+  /* superinstructions, chosen by the codegen */
+  OP_LCAR,                      /* LREF a; CAR */
+  OP_LCDR,                      /* LREF a; CDR */
+  OP_LPOP,                      /* LSET a; POP */
+  OP_LRET,                      /* LREF a; RET */
+  OP_ADDI,                      /* PUSHINT i; ADD */
+  OP_SUBI,                      /* PUSHINT i; SUB */
+  OP_JMPNOT,                    /* NOT; JMPIF */
+  OP_JMPNILP,                   /* NILP; JMPIF */
+  OP_JMPPAIRP,                  /* PAIRP; JMPIF */
+  OP_JMPEQ,                     /* EQ; JMPIF */
+  OP_JMPLT,                     /* LT; JMPIF */
+  OP_JMPLE,                     /* LE; JMPIF */
+  OP_JMPGT,                     /* GT; JMPIF */
+  OP_JMPGE,                     /* GE; JMPIF */
+  OP_JMPEQP,                    /* EQP; JMPIF */
+  OP_CCALL,                     /* PUSHCONST k; CALL n */
+  OP_LTAILCALL                  /* LREF a; TAILCALL n */
 };
 
+/*
+ * An instruction is a one-byte opcode followed by its operands. Integer
+ * operands (indices, counts, immediates) take one byte when they are in
+ * [0, 255) and five bytes otherwise: PIC_CODE_WIDE and then the value as
+ * a 32-bit integer, least significant byte first. Jump offsets are always
+ * four bytes, so that they can be patched, and count from the end of the
+ * instruction.
+ */
+
+typedef unsigned char pic_code;
+
+#define PIC_CODE_WIDE 0xff
+
+PIC_INLINE int
+pic_code_int32(const pic_code *p)
+{
+  uint32_t u = (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+
+  return u <= INT_MAX ? (int)u : -(int)~u - 1;
+}
+
+PIC_INLINE void
+pic_code_put_int32(pic_code *p, int i)
+{
+  uint32_t u = (uint32_t)i;
+
+  p[0] = u & 0xff;
+  p[1] = (u >> 8) & 0xff;
+  p[2] = (u >> 16) & 0xff;
+  p[3] = (u >> 24) & 0xff;
+}
+
 struct list_head {
   struct list_head *prev, *next;
 };
@@ -67,12 +132,11 @@ struct irep {
   unsigned refc;
   int argc, localc, capturec;
   bool varg;
-  struct code *code;
+  pic_code *code;
   struct irep **irep;
-  int *ints;
   double *nums;
   struct object **pool;
-  size_t ncode, nirep, nints, nnums, npool;
+  size_t ncode, nirep, nnums, npool; /* ncode is in bytes */
 };
 
 void pic_irep_incref(pic_state *, struct irep *);
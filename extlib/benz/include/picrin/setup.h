@@ -52,8 +52,28 @@ void abort(void);
 # define PIC_PAGE_REQUEST_THRESHOLD(total) ((total) * 77 / 100)
 #endif
 
+#ifndef PIC_MAJOR_GC_THRESHOLD
+# define PIC_MAJOR_GC_THRESHOLD(live) ((live) * 2)
+#endif
+
+#ifndef PIC_GC_BUDGET
+# define PIC_GC_BUDGET 64
+#endif
+
 #ifndef PIC_STACK_SIZE
-# define PIC_STACK_SIZE 2048
+# define PIC_STACK_SIZE 256
+#endif
+
+#ifndef PIC_STACK_MAX
+# define PIC_STACK_MAX (1024 * 1024)
+#endif
+
+#ifndef PIC_CALLINFO_SIZE
+# define PIC_CALLINFO_SIZE 64
+#endif
+
+#ifndef PIC_BACKTRACE_DEPTH
+# define PIC_BACKTRACE_DEPTH 256
 #endif
 
 #ifndef PIC_RESCUE_SIZE
@@ -168,11 +188,14 @@ typedef unsigned long uint32_t;
 #include <ctype.h>
 #include <assert.h>
 #include <stdlib.h>
+#include <signal.h>
 
 #else
 
 # define assert(v) (void)0
 
+typedef int sig_atomic_t;
+
 PIC_INLINE int
 isspace(int c)
 {
@@ -468,5 +491,42 @@ double PIC_CSTRING_TO_DOUBLE(const char *);
 #if PIC_USE_LIBC && (defined (__unix__) || (defined (__APPLE__) && defined (__MACH__)))
 # include <unistd.h>
 # define PIC_MEMALIGN(pic, buf, alignment, size) posix_memalign(buf, alignment, size)
-# define PIC_BITMAP_GC 1
+# ifndef PIC_BITMAP_GC
+#  define PIC_BITMAP_GC 1
+# endif
+#endif
+
+#ifndef PIC_CLOCK
+# if PIC_USE_LIBC
+#  include <time.h>
+#  if defined(CLOCK_MONOTONIC)
+
+PIC_INLINE double
+pic_monotonic_clock(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+#   define PIC_CLOCK(pic) pic_monotonic_clock()
+#  else
+#   define PIC_CLOCK(pic) ((double)clock() / CLOCKS_PER_SEC)
+#  endif
+# else
+#  define PIC_CLOCK(pic) 0.0
+# endif
+#endif
+
+#ifndef PIC_GENERATIONAL_GC
+# define PIC_GENERATIONAL_GC 0
+#endif
+
+#ifndef PIC_INCREMENTAL_GC
+# define PIC_INCREMENTAL_GC 0
+#endif
+
+#if PIC_GENERATIONAL_GC && PIC_INCREMENTAL_GC
+# error "PIC_GENERATIONAL_GC and PIC_INCREMENTAL_GC cannot be combined"
 #endif
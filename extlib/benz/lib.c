@@ -78,21 +78,19 @@ pic_value
 pic_add_identifier(pic_state *pic, pic_value id, pic_value env)
 {
   const char *name, *lib;
-  pic_value uid, str;
+  pic_value uid;
 
   if (search_scope(pic, id, env, &uid)) {
     return uid;
   }
 
-  name = pic_str(pic, pic_id_name(pic, id));
-
   if (pic_env_ptr(pic, env)->up == NULL && pic_sym_p(pic, id)) { /* toplevel & public */
+    name = pic_str(pic, pic_id_name(pic, id));
     lib = pic_str(pic, pic_obj_value(pic_env_ptr(pic, env)->lib));
-    str = pic_strf_value(pic, "%s/%s", lib, name);
+    uid = pic_intern(pic, pic_strf_value(pic, "%s/%s", lib, name));
   } else {
-    str = pic_strf_value(pic, ".%s.%d", name, pic->ucnt++);
+    uid = pic_make_uid(pic, pic_id_name(pic, id));
   }
-  uid = pic_intern(pic, str);
 
   pic_put_identifier(pic, id, uid, env);
 
@@ -106,6 +104,12 @@ pic_put_identifier(pic_state *pic, pic_value id, pic_value uid, pic_value env)
 
   it = kh_put(env, &pic_env_ptr(pic, env)->map, pic_id_ptr(pic, id), &ret);
   kh_val(&pic_env_ptr(pic, env)->map, it) = pic_sym_ptr(pic, uid);
+  pic_gc_write_barrier(pic, pic_obj_ptr(env), id);
+  pic_gc_write_barrier(pic, pic_obj_ptr(env), uid);
+
+  if (pic_env_ptr(pic, env)->up == NULL) {
+    pic_image_effect(pic, PIC_IMAGE_PUT, id, uid, env);
+  }
 }
 
 static struct lib *
@@ -176,6 +180,8 @@ pic_make_library(pic_state *pic, const char *lib)
   kh_val(h, it).name = pic_str_ptr(pic, name);
   kh_val(h, it).env = pic_env_ptr(pic, env);
   kh_val(h, it).exports = pic_dict_ptr(pic, exports);
+
+  pic_image_effect(pic, PIC_IMAGE_LIBRARY, name, pic_undef_value(pic), pic_undef_value(pic));
 }
 
 void
@@ -215,17 +221,25 @@ pic_import(pic_state *pic, const char *lib)
 
   while (pic_dict_next(pic, pic_obj_value(their->exports), &it, &name, &realname)) {
     uid = pic_find_identifier(pic, realname, pic_obj_value(their->env));
-    if (! pic_weak_has(pic, pic->globals, uid) && ! pic_weak_has(pic, pic->macros, uid)) {
+    if (! pic_global_defined_p(pic, uid) && ! pic_weak_has(pic, pic->macros, uid)) {
       pic_error(pic, "attempted to export undefined variable", 1, realname);
     }
     pic_put_identifier(pic, name, uid, pic_obj_value(our->env));
   }
 }
 
+void
+pic_library_export(pic_state *pic, const char *lib, pic_value alias, pic_value name)
+{
+  pic_dict_set(pic, pic_obj_value(get_library(pic, lib)->exports), alias, name);
+
+  pic_image_effect(pic, PIC_IMAGE_EXPORT, pic_cstr_value(pic, lib), alias, name);
+}
+
 void
 pic_export(pic_state *pic, pic_value name)
 {
-  pic_dict_set(pic, pic_obj_value(get_library(pic, pic->lib)->exports), name, name);
+  pic_library_export(pic, pic->lib, name, name);
 }
 
 static pic_value
@@ -291,7 +305,7 @@ pic_lib_library_import(pic_state *pic)
   }
 
   uid = pic_find_identifier(pic, realname, pic_obj_value(libp->env));
-  if (! pic_weak_has(pic, pic->globals, uid) && ! pic_weak_has(pic, pic->macros, uid)) {
+  if (! pic_global_defined_p(pic, uid) && ! pic_weak_has(pic, pic->macros, uid)) {
     pic_error(pic, "attempted to export undefined variable", 1, realname);
   }
 
@@ -312,7 +326,7 @@ pic_lib_library_export(pic_state *pic)
     alias = name;
   }
 
-  pic_dict_set(pic, pic_obj_value(get_library(pic, pic->lib)->exports), alias, name);
+  pic_library_export(pic, pic->lib, alias, name);
 
   return pic_undef_value(pic);
 }
@@ -235,14 +235,7 @@ pic_number_number_to_string(pic_state *pic)
     str = pic_str_value(pic, buf, ilen);
   }
   else {
-    pic_value port = pic_fmemopen(pic, NULL, 0, "w");
-    const char *buf;
-    int len;
-
-    pic_fprintf(pic, port, "%f", f);
-    pic_fgetbuf(pic, port, &buf, &len);
-    str = pic_str_value(pic, buf, len);
-    pic_fclose(pic, port);
+    str = pic_strf_value(pic, "%f", f);
   }
 
   return str;
@@ -43,6 +43,7 @@ pic_set_car(pic_state *pic, pic_value obj, pic_value val)
     pic_error(pic, "pair required", 0);
   }
   pic_pair_ptr(pic, obj)->car = val;
+  pic_gc_write_barrier(pic, pic_obj_ptr(obj), val);
 }
 
 void
@@ -52,6 +53,7 @@ pic_set_cdr(pic_state *pic, pic_value obj, pic_value val)
     pic_error(pic, "pair required", 0);
   }
   pic_pair_ptr(pic, obj)->cdr = val;
+  pic_gc_write_barrier(pic, pic_obj_ptr(obj), val);
 }
 
 pic_value
@@ -154,7 +156,7 @@ pic_list_ref(pic_state *pic, pic_value list, int i)
 void
 pic_list_set(pic_state *pic, pic_value list, int i, pic_value obj)
 {
-  pic_pair_ptr(pic, pic_list_tail(pic, list, i))->car = obj;
+  pic_set_car(pic, pic_list_tail(pic, list, i), obj);
 }
 
 pic_value
@@ -212,136 +214,89 @@ pic_append(pic_state *pic, pic_value xs, pic_value ys)
 }
 
 static pic_value
-pic_pair_pair_p(pic_state *pic)
+pic_pair_pair_p(pic_state *pic, int PIC_UNUSED(argc), pic_value *argv)
 {
-  pic_value v;
-
-  pic_get_args(pic, "o", &v);
-
-  return pic_bool_value(pic, pic_pair_p(pic, v));
+  return pic_bool_value(pic, pic_pair_p(pic, argv[0]));
 }
 
 static pic_value
-pic_pair_cons(pic_state *pic)
+pic_pair_cons(pic_state *pic, int PIC_UNUSED(argc), pic_value *argv)
 {
-  pic_value v,w;
-
-  pic_get_args(pic, "oo", &v, &w);
-
-  return pic_cons(pic, v, w);
+  return pic_cons(pic, argv[0], argv[1]);
 }
 
 static pic_value
-pic_pair_car(pic_state *pic)
+pic_pair_car(pic_state *pic, int PIC_UNUSED(argc), pic_value *argv)
 {
-  pic_value v;
-
-  pic_get_args(pic, "o", &v);
-
-  return pic_car(pic, v);
+  return pic_car(pic, argv[0]);
 }
 
 static pic_value
-pic_pair_cdr(pic_state *pic)
+pic_pair_cdr(pic_state *pic, int PIC_UNUSED(argc), pic_value *argv)
 {
-  pic_value v;
-
-  pic_get_args(pic, "o", &v);
-
-  return pic_cdr(pic, v);
+  return pic_cdr(pic, argv[0]);
 }
 
 static pic_value
-pic_pair_caar(pic_state *pic)
+pic_pair_caar(pic_state *pic, int PIC_UNUSED(argc), pic_value *argv)
 {
-  pic_value v;
-
-  pic_get_args(pic, "o", &v);
-
-  return pic_caar(pic, v);
+  return pic_caar(pic, argv[0]);
 }
 
 static pic_value
-pic_pair_cadr(pic_state *pic)
+pic_pair_cadr(pic_state *pic, int PIC_UNUSED(argc), pic_value *argv)
 {
-  pic_value v;
-
-  pic_get_args(pic, "o", &v);
-
-  return pic_cadr(pic, v);
+  return pic_cadr(pic, argv[0]);
 }
 
 static pic_value
-pic_pair_cdar(pic_state *pic)
+pic_pair_cdar(pic_state *pic, int PIC_UNUSED(argc), pic_value *argv)
 {
-  pic_value v;
-
-  pic_get_args(pic, "o", &v);
-
-  return pic_cdar(pic, v);
+  return pic_cdar(pic, argv[0]);
 }
 
 static pic_value
-pic_pair_cddr(pic_state *pic)
+pic_pair_cddr(pic_state *pic, int PIC_UNUSED(argc), pic_value *argv)
 {
-  pic_value v;
-
-  pic_get_args(pic, "o", &v);
-
-  return pic_cddr(pic, v);
+  return pic_cddr(pic, argv[0]);
 }
 
 static pic_value
-pic_pair_set_car(pic_state *pic)
+pic_pair_set_car(pic_state *pic, int PIC_UNUSED(argc), pic_value *argv)
 {
-  pic_value v,w;
-
-  pic_get_args(pic, "oo", &v, &w);
-
-  pic_set_car(pic, v, w);
+  pic_set_car(pic, argv[0], argv[1]);
 
   return pic_undef_value(pic);
 }
 
 static pic_value
-pic_pair_set_cdr(pic_state *pic)
+pic_pair_set_cdr(pic_state *pic, int PIC_UNUSED(argc), pic_value *argv)
 {
-  pic_value v,w;
-
-  pic_get_args(pic, "oo", &v, &w);
-
-  pic_set_cdr(pic, v, w);
+  pic_set_cdr(pic, argv[0], argv[1]);
 
   return pic_undef_value(pic);
 }
 
 static pic_value
-pic_pair_null_p(pic_state *pic)
+pic_pair_null_p(pic_state *pic, int PIC_UNUSED(argc), pic_value *argv)
 {
-  pic_value v;
-
-  pic_get_args(pic, "o", &v);
-
-  return pic_bool_value(pic, pic_nil_p(pic, v));
+  return pic_bool_value(pic, pic_nil_p(pic, argv[0]));
 }
 
 static pic_value
-pic_pair_list_p(pic_state *pic)
+pic_pair_list_p(pic_state *pic, int PIC_UNUSED(argc), pic_value *argv)
 {
-  pic_value v;
-
-  pic_get_args(pic, "o", &v);
-
-  return pic_bool_value(pic, pic_list_p(pic, v));
+  return pic_bool_value(pic, pic_list_p(pic, argv[0]));
 }
 
 static pic_value
-pic_pair_make_list(pic_state *pic)
+pic_pair_make_list(pic_state *pic, int argc, pic_value *argv)
 {
   int k, i;
-  pic_value list, fill = pic_undef_value(pic);
+  pic_value list, fill;
 
-  pic_get_args(pic, "i|o", &k, &fill);
+  k = pic_int(pic, argv[0]);
+  fill = argc > 1 ? argv[1] : pic_undef_value(pic);
 
   list = pic_nil_value(pic);
   for (i = 0; i < k; ++i) {
@@ -351,97 +306,64 @@ pic_pair_make_list(pic_state *pic)
 }
 
 static pic_value
-pic_pair_list(pic_state *pic)
+pic_pair_list(pic_state *pic, int argc, pic_value *argv)
 {
-  int argc;
-  pic_value *argv;
-
-  pic_get_args(pic, "*", &argc, &argv);
-
   return pic_make_list(pic, argc, argv);
 }
 
 static pic_value
-pic_pair_length(pic_state *pic)
+pic_pair_length(pic_state *pic, int PIC_UNUSED(argc), pic_value *argv)
 {
-  pic_value list;
-
-  pic_get_args(pic, "o", &list);
-
-  return pic_int_value(pic, pic_length(pic, list));
+  return pic_int_value(pic, pic_length(pic, argv[0]));
 }
 
 static pic_value
-pic_pair_append(pic_state *pic)
+pic_pair_append(pic_state *pic, int argc, pic_value *argv)
 {
-  int argc;
-  pic_value *args, list;
-
-  pic_get_args(pic, "*", &argc, &args);
+  pic_value list;
 
   if (argc == 0) {
     return pic_nil_value(pic);
   }
 
-  list = args[--argc];
+  list = argv[--argc];
 
   while (argc-- > 0) {
-    list = pic_append(pic, args[argc], list);
+    list = pic_append(pic, argv[argc], list);
   }
   return list;
 }
 
 static pic_value
-pic_pair_reverse(pic_state *pic)
+pic_pair_reverse(pic_state *pic, int PIC_UNUSED(argc), pic_value *argv)
 {
-  pic_value list;
-
-  pic_get_args(pic, "o", &list);
-
-  return pic_reverse(pic, list);
+  return pic_reverse(pic, argv[0]);
 }
 
 static pic_value
-pic_pair_list_tail(pic_state *pic)
+pic_pair_list_tail(pic_state *pic, int PIC_UNUSED(argc), pic_value *argv)
 {
-  pic_value list;
-  int i;
-
-  pic_get_args(pic, "oi", &list, &i);
-
-  return pic_list_tail(pic, list, i);
+  return pic_list_tail(pic, argv[0], pic_int(pic, argv[1]));
 }
 
 static pic_value
-pic_pair_list_ref(pic_state *pic)
+pic_pair_list_ref(pic_state *pic, int PIC_UNUSED(argc), pic_value *argv)
 {
-  pic_value list;
-  int i;
-
-  pic_get_args(pic, "oi", &list, &i);
-
-  return pic_list_ref(pic, list, i);
+  return pic_list_ref(pic, argv[0], pic_int(pic, argv[1]));
 }
 
 static pic_value
-pic_pair_list_set(pic_state *pic)
+pic_pair_list_set(pic_state *pic, int PIC_UNUSED(argc), pic_value *argv)
 {
-  pic_value list, obj;
-  int i;
-
-  pic_get_args(pic, "oio", &list, &i, &obj);
-
-  pic_list_set(pic, list, i, obj);
+  pic_list_set(pic, argv[0], pic_int(pic, argv[1]), argv[2]);
 
   return pic_undef_value(pic);
 }
 
 static pic_value
-pic_pair_list_copy(pic_state *pic)
+pic_pair_list_copy(pic_state *pic, int PIC_UNUSED(argc), pic_value *argv)
 {
-  pic_value list, head, tail, tmp;
-
-  pic_get_args(pic, "o", &list);
+  pic_value list = argv[0], head, tail, tmp;
 
   head = tail = pic_nil_value(pic);
 
@@ -464,16 +386,12 @@ pic_pair_list_copy(pic_state *pic)
 }
 
 static pic_value
-pic_pair_map(pic_state *pic)
+pic_pair_map(pic_state *pic, int argc, pic_value *argv)
 {
-  int argc, i;
-  pic_value proc, *args, *arg_list, ret;
-
-  pic_get_args(pic, "l*", &proc, &argc, &args);
-
-  if (argc == 0)
-    pic_error(pic, "map: wrong number of arguments (1 for at least 2)", 0);
+  int i;
+  pic_value proc = argv[0], *args = argv + 1, *arg_list, ret;
 
+  argc--;
   arg_list = pic_alloca(pic, sizeof(pic_value) * argc);
 
   ret = pic_nil_value(pic);
@@ -496,13 +414,12 @@ pic_pair_map(pic_state *pic)
 }
 
 static pic_value
-pic_pair_for_each(pic_state *pic)
+pic_pair_for_each(pic_state *pic, int argc, pic_value *argv)
 {
-  int argc, i;
-  pic_value proc, *args, *arg_list;
-
-  pic_get_args(pic, "l*", &proc, &argc, &args);
+  int i;
+  pic_value proc = argv[0], *args = argv + 1, *arg_list;
 
+  argc--;
   arg_list = pic_alloca(pic, sizeof(pic_value) * argc);
 
   do {
@@ -523,11 +440,9 @@ pic_pair_for_each(pic_state *pic)
 }
 
 static pic_value
-pic_pair_memq(pic_state *pic)
+pic_pair_memq(pic_state *pic, int PIC_UNUSED(argc), pic_value *argv)
 {
-  pic_value key, list;
-
-  pic_get_args(pic, "oo", &key, &list);
+  pic_value key = argv[0], list = argv[1];
 
   while (! pic_nil_p(pic, list)) {
     if (pic_eq_p(pic, key, pic_car(pic, list))) {
@@ -539,11 +454,9 @@ pic_pair_memq(pic_state *pic)
 }
 
 static pic_value
-pic_pair_memv(pic_state *pic)
+pic_pair_memv(pic_state *pic, int PIC_UNUSED(argc), pic_value *argv)
 {
-  pic_value key, list;
-
-  pic_get_args(pic, "oo", &key, &list);
+  pic_value key = argv[0], list = argv[1];
 
   while (! pic_nil_p(pic, list)) {
     if (pic_eqv_p(pic, key, pic_car(pic, list))) {
@@ -555,19 +468,16 @@ pic_pair_memv(pic_state *pic)
 }
 
 static pic_value
-pic_pair_member(pic_state *pic)
+pic_pair_member(pic_state *pic, int argc, pic_value *argv)
 {
-  pic_value key, list, proc;
-  int n;
-
-  n = pic_get_args(pic, "oo|l", &key, &list, &proc);
+  pic_value key = argv[0], list = argv[1];
 
   while (! pic_nil_p(pic, list)) {
-    if (n == 2) {
+    if (argc == 2) {
       if (pic_equal_p(pic, key, pic_car(pic, list)))
         return list;
     } else {
-      if (! pic_false_p(pic, pic_call(pic, proc, 2, key, pic_car(pic, list))))
+      if (! pic_false_p(pic, pic_call(pic, argv[2], 2, key, pic_car(pic, list))))
         return list;
     }
     list = pic_cdr(pic, list);
@@ -576,11 +486,9 @@ pic_pair_member(pic_state *pic)
 }
 
 static pic_value
-pic_pair_assq(pic_state *pic)
+pic_pair_assq(pic_state *pic, int PIC_UNUSED(argc), pic_value *argv)
 {
-  pic_value key, alist, cell;
-
-  pic_get_args(pic, "oo", &key, &alist);
+  pic_value key = argv[0], alist = argv[1], cell;
 
   while (! pic_nil_p(pic, alist)) {
     cell = pic_car(pic, alist);
@@ -593,11 +501,9 @@ pic_pair_assq(pic_state *pic)
 }
 
 static pic_value
-pic_pair_assv(pic_state *pic)
+pic_pair_assv(pic_state *pic, int PIC_UNUSED(argc), pic_value *argv)
 {
-  pic_value key, alist, cell;
-
-  pic_get_args(pic, "oo", &key, &alist);
+  pic_value key = argv[0], alist = argv[1], cell;
 
   while (! pic_nil_p(pic, alist)) {
     cell = pic_car(pic, alist);
@@ -610,20 +516,17 @@ pic_pair_assv(pic_state *pic)
 }
 
 static pic_value
-pic_pair_assoc(pic_state *pic)
+pic_pair_assoc(pic_state *pic, int argc, pic_value *argv)
 {
-  pic_value key, alist, proc, cell;
-  int n;
-
-  n = pic_get_args(pic, "oo|l", &key, &alist, &proc);
+  pic_value key = argv[0], alist = argv[1], cell;
 
   while (! pic_nil_p(pic, alist)) {
     cell = pic_car(pic, alist);
-    if (n == 2) {
+    if (argc == 2) {
       if (pic_equal_p(pic, key, pic_car(pic, cell)))
         return cell;
     } else {
-      if (! pic_false_p(pic, pic_call(pic, proc, 2, key, pic_car(pic, cell))))
+      if (! pic_false_p(pic, pic_call(pic, argv[2], 2, key, pic_car(pic, cell))))
         return cell;
     }
     alist = pic_cdr(pic, alist);
@@ -634,35 +537,35 @@ pic_pair_assoc(pic_state *pic)
 void
 pic_init_pair(pic_state *pic)
 {
-  pic_defun(pic, "pair?", pic_pair_pair_p);
-  pic_defun(pic, "cons", pic_pair_cons);
-  pic_defun(pic, "car", pic_pair_car);
-  pic_defun(pic, "cdr", pic_pair_cdr);
-  pic_defun(pic, "null?", pic_pair_null_p);
-
-  pic_defun(pic, "set-car!", pic_pair_set_car);
-  pic_defun(pic, "set-cdr!", pic_pair_set_cdr);
-
-  pic_defun(pic, "caar", pic_pair_caar);
-  pic_defun(pic, "cadr", pic_pair_cadr);
-  pic_defun(pic, "cdar", pic_pair_cdar);
-  pic_defun(pic, "cddr", pic_pair_cddr);
-  pic_defun(pic, "list?", pic_pair_list_p);
-  pic_defun(pic, "make-list", pic_pair_make_list);
-  pic_defun(pic, "list", pic_pair_list);
-  pic_defun(pic, "length", pic_pair_length);
-  pic_defun(pic, "append", pic_pair_append);
-  pic_defun(pic, "reverse", pic_pair_reverse);
-  pic_defun(pic, "list-tail", pic_pair_list_tail);
-  pic_defun(pic, "list-ref", pic_pair_list_ref);
-  pic_defun(pic, "list-set!", pic_pair_list_set);
-  pic_defun(pic, "list-copy", pic_pair_list_copy);
-  pic_defun(pic, "map", pic_pair_map);
-  pic_defun(pic, "for-each", pic_pair_for_each);
-  pic_defun(pic, "memq", pic_pair_memq);
-  pic_defun(pic, "memv", pic_pair_memv);
-  pic_defun(pic, "member", pic_pair_member);
-  pic_defun(pic, "assq", pic_pair_assq);
-  pic_defun(pic, "assv", pic_pair_assv);
-  pic_defun(pic, "assoc", pic_pair_assoc);
+  pic_defun_sig(pic, "pair?", "o", pic_pair_pair_p);
+  pic_defun_sig(pic, "cons", "oo", pic_pair_cons);
+  pic_defun_sig(pic, "car", "o", pic_pair_car);
+  pic_defun_sig(pic, "cdr", "o", pic_pair_cdr);
+  pic_defun_sig(pic, "null?", "o", pic_pair_null_p);
+
+  pic_defun_sig(pic, "set-car!", "oo", pic_pair_set_car);
+  pic_defun_sig(pic, "set-cdr!", "oo", pic_pair_set_cdr);
+
+  pic_defun_sig(pic, "caar", "o", pic_pair_caar);
+  pic_defun_sig(pic, "cadr", "o", pic_pair_cadr);
+  pic_defun_sig(pic, "cdar", "o", pic_pair_cdar);
+  pic_defun_sig(pic, "cddr", "o", pic_pair_cddr);
+  pic_defun_sig(pic, "list?", "o", pic_pair_list_p);
+  pic_defun_sig(pic, "make-list", "i|o", pic_pair_make_list);
+  pic_defun_sig(pic, "list", "*", pic_pair_list);
+  pic_defun_sig(pic, "length", "o", pic_pair_length);
+  pic_defun_sig(pic, "append", "*", pic_pair_append);
+  pic_defun_sig(pic, "reverse", "o", pic_pair_reverse);
+  pic_defun_sig(pic, "list-tail", "oi", pic_pair_list_tail);
+  pic_defun_sig(pic, "list-ref", "oi", pic_pair_list_ref);
+  pic_defun_sig(pic, "list-set!", "oio", pic_pair_list_set);
+  pic_defun_sig(pic, "list-copy", "o", pic_pair_list_copy);
+  pic_defun_sig(pic, "map", "lo*", pic_pair_map);
+  pic_defun_sig(pic, "for-each", "l*", pic_pair_for_each);
+  pic_defun_sig(pic, "memq", "oo", pic_pair_memq);
+  pic_defun_sig(pic, "memv", "oo", pic_pair_memv);
+  pic_defun_sig(pic, "member", "oo|l", pic_pair_member);
+  pic_defun_sig(pic, "assq", "oo", pic_pair_assq);
+  pic_defun_sig(pic, "assv", "oo", pic_pair_assv);
+  pic_defun_sig(pic, "assoc", "oo|l", pic_pair_assoc);
 }
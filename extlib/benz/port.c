@@ -285,7 +285,8 @@ pic_fwrite(pic_state *pic, const void *ptr, size_t size, size_t count, pic_value
     fp->ptr += fp->cnt;
     bptr += fp->cnt;
     nbytes -= fp->cnt;
-    if (flushbuf(pic, EOF, fp) == EOF) {
+    flushbuf(pic, EOF, fp);     /* returns EOF even when it succeeds */
+    if ((fp->flag & FILE_ERR) || fp->cnt <= 0) {
       return (size * count - nbytes) / size;
     }
   }
@@ -412,7 +413,7 @@ pic_fopen_null(pic_state *PIC_UNUSED(pic), const char *mode)
 
 #endif
 
-typedef struct { char *buf; long pos, end, capa; } xbuf_t;
+typedef struct { char *buf; long pos, end; } xbuf_t;
 
 static int
 string_read(pic_state *PIC_UNUSED(pic), void *cookie, char *ptr, int size)
@@ -426,22 +427,6 @@ string_read(pic_state *PIC_UNUSED(pic), void *cookie, char *ptr, int size)
   return size;
 }
 
-static int
-string_write(pic_state *pic, void *cookie, const char *ptr, int size)
-{
-  xbuf_t *m = cookie;
-
-  if (m->pos + size >= m->capa) {
-    m->capa = (m->pos + size) * 2;
-    m->buf = pic_realloc(pic, m->buf, m->capa);
-  }
-  memcpy(m->buf + m->pos, ptr, size);
-  m->pos += size;
-  if (m->end < m->pos)
-    m->end = m->pos;
-  return size;
-}
-
 static long
 string_seek(pic_state *PIC_UNUSED(pic), void *cookie, long pos, int whence)
 {
@@ -472,39 +457,106 @@ string_close(pic_state *pic, void *cookie)
   return 0;
 }
 
+/* output string ports write into a string builder */
+
+static int
+strbuf_write(pic_state *pic, void *cookie, const char *ptr, int size)
+{
+  pic_strbuf_write(pic, cookie, ptr, size);
+  return size;
+}
+
+static long
+strbuf_seek(pic_state *PIC_UNUSED(pic), void *cookie, long pos, int whence)
+{
+  struct strbuf *sb = cookie;
+
+  if (whence == PIC_SEEK_SET ? pos != sb->len : pos != 0) {
+    return -1;                  /* only appending is supported */
+  }
+  return sb->len;
+}
+
+static int
+strbuf_close(pic_state *pic, void *cookie)
+{
+  pic_strbuf_destroy(pic, cookie);
+  pic_free(pic, cookie);
+  return 0;
+}
+
+static struct strbuf *
+get_strbuf(pic_state *pic, pic_value port)
+{
+  struct file *fp = &pic_port_ptr(pic, port)->file;
+
+  pic_fflush(pic, port);
+
+  if (fp->vtable.write != strbuf_write) {
+    return NULL;
+  }
+  return fp->vtable.cookie;
+}
+
+/*
+ * A port taking over what sb holds so far, leaving sb empty. The port
+ * owns its builder, so an error thrown while writing to it leaks nothing.
+ */
+pic_value
+pic_strbuf_port(pic_state *pic, struct strbuf *sb)
+{
+  pic_value port = pic_fmemopen(pic, NULL, 0, "w");
+  struct strbuf *own = get_strbuf(pic, port);
+
+  *own = *sb;
+  sb->rope = NULL;
+  sb->len = sb->capa = 0;
+  return port;
+}
+
+/* moves the contents of a port made by pic_strbuf_port back into sb and closes it */
+void
+pic_strbuf_port_close(pic_state *pic, struct strbuf *sb, pic_value port)
+{
+  struct strbuf *own = get_strbuf(pic, port);
+
+  *sb = *own;
+  own->rope = NULL;
+  own->len = own->capa = 0;
+  pic_fclose(pic, port);
+}
+
 pic_value
 pic_fmemopen(pic_state *pic, const char *data, int size, const char *mode)
 {
   xbuf_t *m;
-
-  m = pic_malloc(pic, sizeof(xbuf_t));
-  m->buf = pic_malloc(pic, size);
-  m->pos = 0;
-  m->end = size;
-  m->capa = size;
+  struct strbuf *sb;
 
   if (*mode == 'r') {
+    m = pic_malloc(pic, sizeof(xbuf_t));
+    m->buf = pic_malloc(pic, size);
+    m->pos = 0;
+    m->end = size;
     memcpy(m->buf, data, size);
     return pic_funopen(pic, m, string_read, NULL, string_seek, string_close);
   } else {
-    return pic_funopen(pic, m, NULL, string_write, string_seek, string_close);
+    sb = pic_malloc(pic, sizeof(struct strbuf));
+    sb->rope = NULL;
+    sb->len = sb->capa = 0;
+    return pic_funopen(pic, sb, NULL, strbuf_write, strbuf_seek, strbuf_close);
   }
 }
 
 int
 pic_fgetbuf(pic_state *pic, pic_value port, const char **buf, int *len)
 {
-  struct file *fp = &pic_port_ptr(pic, port)->file;
-  xbuf_t *s;
-
-  pic_fflush(pic, port);
+  struct strbuf *sb;
 
-  if (fp->vtable.write != string_write) {
+  if ((sb = get_strbuf(pic, port)) == NULL) {
     return -1;
   }
-  s = fp->vtable.cookie;
-  *len = s->end;
-  *buf = s->buf;
+  *len = sb->len;
+  *buf = pic_str(pic, pic_strbuf_value(pic, sb));
   return 0;
 }
 
@@ -638,6 +690,22 @@ pic_port_get_output_bytevector(pic_state *pic)
   return pic_blob_value(pic, (unsigned char *)buf, len);
 }
 
+static pic_value
+pic_port_get_output_string(pic_state *pic)
+{
+  pic_value port;
+  struct strbuf *sb;
+
+  pic_get_args(pic, "p", &port);
+
+  assert_port_profile(port, FILE_WRITE, "get-output-string");
+
+  if ((sb = get_strbuf(pic, port)) == NULL) {
+    pic_error(pic, "port was not created by open-output-string", 0);
+  }
+  return pic_strbuf_value(pic, sb);
+}
+
 static pic_value
 pic_port_read_u8(pic_state *pic)
 {
@@ -808,4 +876,6 @@ pic_init_port(pic_state *pic)
   pic_defun(pic, "open-input-bytevector", pic_port_open_input_bytevector);
   pic_defun(pic, "open-output-bytevector", pic_port_open_output_bytevector);
   pic_defun(pic, "get-output-bytevector", pic_port_get_output_bytevector);
+  pic_defun(pic, "open-output-string", pic_port_open_output_bytevector);
+  pic_defun(pic, "get-output-string", pic_port_get_output_string);
 }
@@ -5,6 +5,7 @@
 #include "picrin.h"
 #include "picrin/extra.h"
 #include "picrin/private/object.h"
+#include "picrin/private/value.h"
 #include "picrin/private/vm.h"
 #include "picrin/private/state.h"
 
@@ -239,28 +240,176 @@ pic_get_args(pic_state *pic, const char *format, ...)
   return argc;
 }
 
-static pic_value
-global_ref(pic_state *pic, pic_value uid)
+/**
+ * Signatures given to pic_defun_sig use the object letters of
+ * pic_get_args (o i f c s m v b l p d r), then an optional '|' before
+ * the optional parameters and a '*' before the rest arguments, itself
+ * followed by the letter of every rest argument ("*" alone means "*o").
+ * The signature is parsed once at definition; the VM checks the arity
+ * and types on each call and converts 'i' and 'f' arguments in place.
+ * Unlike pic_get_args, 'i' refuses floats that are not integral.
+ * The string is kept by reference, so it must outlive the procedure.
+ */
+
+#define SIG_TYPES "oifcsmvblpdr"
+
+static void
+parse_sig(pic_state *pic, struct proc *proc, const char *sig)
+{
+  const char *p = sig;
+  int reqc = 0, optc = 0;
+  char rest = 0;
+  bool typed = false;
+
+  for (; *p != '\0' && *p != '|' && *p != '*'; ++p, ++reqc) {
+    if (strchr(SIG_TYPES, *p) == NULL) goto invalid;
+    typed = typed || *p != 'o';
+  }
+  if (*p == '|') {
+    for (++p; *p != '\0' && *p != '*'; ++p, ++optc) {
+      if (strchr(SIG_TYPES, *p) == NULL) goto invalid;
+      typed = typed || *p != 'o';
+    }
+    if (optc == 0) goto invalid;
+  }
+  if (*p == '*') {
+    rest = 'o';
+    if (*++p != '\0') {
+      if (strchr(SIG_TYPES, *p) == NULL) goto invalid;
+      rest = *p++;
+      typed = typed || rest != 'o';
+    }
+  }
+  if (*p != '\0' || reqc + optc > 255) goto invalid;
+
+  proc->u.f.reqc = (unsigned char)reqc;
+  proc->u.f.optc = (unsigned char)optc;
+  proc->u.f.rest = rest;
+  proc->u.f.typed = typed;
+  proc->u.f.sig = sig;
+  return;
+
+ invalid:
+  pic_error(pic, "pic_defun_sig: invalid signature", 1, pic_cstr_value(pic, sig));
+}
+
+#define SIG_CASE(c, type, name)                                         \
+  case c:                                                               \
+    if (! pic_##type##_p(pic, argv[i])) {                               \
+      pic_error(pic, name " required", 1, argv[i]);                     \
+    }                                                                   \
+    break
+
+static void
+check_sig(pic_state *pic, struct proc *proc, int argc, pic_value *argv)
+{
+  int reqc = proc->u.f.reqc, optc = proc->u.f.optc, i;
+  const char *sig = proc->u.f.sig;
+  char c;
+
+  if (argc < reqc || (reqc + optc < argc && ! proc->u.f.rest)) {
+    arg_error(pic, argc, proc->u.f.rest != 0, reqc);
+  }
+  if (! proc->u.f.typed) {
+    return;
+  }
+  for (i = 0; i < argc; ++i) {
+    if (i < reqc) {
+      c = sig[i];
+    } else if (i < reqc + optc) {
+      c = sig[i + 1];           /* skip '|' */
+    } else {
+      c = proc->u.f.rest;
+    }
+    switch (c) {
+    case 'o':
+      break;
+    case 'i':
+      if (pic_float_p(pic, argv[i])) {
+        double f = pic_float(pic, argv[i]);
+
+        /* out of range or NaN would make the cast undefined */
+        if (! (INT_MIN <= f && f <= INT_MAX) || f != (int)f) {
+          pic_error(pic, "integer required", 1, argv[i]);
+        }
+        argv[i] = pic_int_value(pic, (int)f);
+      } else if (! pic_int_p(pic, argv[i])) {
+        pic_error(pic, "integer required", 1, argv[i]);
+      }
+      break;
+    case 'f':
+      if (pic_int_p(pic, argv[i])) {
+        argv[i] = pic_float_value(pic, pic_int(pic, argv[i]));
+      } else if (! pic_float_p(pic, argv[i])) {
+        pic_error(pic, "float or int required", 1, argv[i]);
+      }
+      break;
+    SIG_CASE('c', char, "character");
+    SIG_CASE('s', str, "string");
+    SIG_CASE('m', sym, "symbol");
+    SIG_CASE('v', vec, "vector");
+    SIG_CASE('b', blob, "bytevector");
+    SIG_CASE('l', proc, "procedure");
+    SIG_CASE('p', port, "port");
+    SIG_CASE('d', dict, "dictionary");
+    SIG_CASE('r', rec, "record");
+    }
+  }
+}
+
+struct cell *
+pic_global_cell(pic_state *pic, pic_value uid)
 {
-  pic_value val;
+  struct cell *cell;
 
+  if (pic_weak_has(pic, pic->globals, uid)) {
+    return pic_cell_ptr(pic, pic_weak_ref(pic, pic->globals, uid));
+  }
+  cell = (struct cell *)pic_obj_alloc(pic, sizeof(struct cell), PIC_TYPE_CELL);
+  cell->value = pic_invalid_value(pic);
+  cell->uid = pic_sym_ptr(pic, uid);
+  cell->defined = false;
+  cell->templ = pic_undef_value(pic);
+  cell->vm_proc = -2;
+  pic_weak_set(pic, pic->globals, uid, pic_obj_value(cell));
+  return cell;
+}
+
+bool
+pic_global_defined_p(pic_state *pic, pic_value uid)
+{
   if (! pic_weak_has(pic, pic->globals, uid)) {
-    pic_error(pic, "undefined variable", 1, uid);
+    return false;
   }
-  val = pic_weak_ref(pic, pic->globals, uid);;
-  if (pic_invalid_p(pic, val)) {
-    pic_error(pic, "uninitialized global variable", 1, uid);
+  return pic_cell_ptr(pic, pic_weak_ref(pic, pic->globals, uid))->defined;
+}
+
+PIC_NORETURN static void
+global_unbound(pic_state *pic, struct cell *cell)
+{
+  if (! cell->defined) {
+    pic_error(pic, "undefined variable", 1, pic_obj_value(cell->uid));
   }
-  return val;
+  pic_error(pic, "uninitialized global variable", 1, pic_obj_value(cell->uid));
+}
+
+static pic_value
+global_ref(pic_state *pic, struct cell *cell)
+{
+  if (pic_invalid_p(pic, cell->value)) {
+    global_unbound(pic, cell);
+  }
+  return cell->value;
 }
 
 static void
-global_set(pic_state *pic, pic_value uid, pic_value value)
+global_set(pic_state *pic, struct cell *cell, pic_value value)
 {
-  if (! pic_weak_has(pic, pic->globals, uid)) {
-    pic_error(pic, "undefined variable", 1, uid);
+  if (! cell->defined) {
+    global_unbound(pic, cell);
   }
-  pic_weak_set(pic, pic->globals, uid, value);
+  cell->value = value;
+  pic_gc_write_barrier(pic, (struct object *)cell, value);
 }
 
 static void
@@ -275,7 +424,7 @@ vm_push_cxt(pic_state *pic)
 }
 
 static void
-vm_tear_off(struct callinfo *ci)
+vm_tear_off(pic_state *pic, struct callinfo *ci)
 {
   struct context *cxt;
   int i;
@@ -291,34 +440,179 @@ vm_tear_off(struct callinfo *ci)
     cxt->storage[i] = cxt->regs[i];
   }
   cxt->regs = cxt->storage;
+  pic_gc_remember(pic, (struct object *)cxt);
 }
 
 void
-pic_vm_tear_off(pic_state *pic)
+pic_vm_tear_off(pic_state *pic, struct callinfo *base)
 {
   struct callinfo *ci;
 
-  for (ci = pic->ci; ci > pic->cibase; ci--) {
+  for (ci = pic->ci; ci > base; ci--) {
     if (ci->cxt != NULL) {
-      vm_tear_off(ci);
+      vm_tear_off(pic, ci);
+    }
+  }
+}
+
+static void
+vm_grow_stack(pic_state *pic, size_t n)
+{
+  struct stack_block *old;
+  struct callinfo *ci;
+  pic_value *base;
+  size_t size, used, limit;
+
+  used = pic->sp - pic->stbase;
+  limit = PIC_STACK_MAX;
+  if (pic->stoverflow) {
+    limit += PIC_STACK_MAX / 16; /* leave room for the handlers */
+  }
+  if (used + n > limit) {
+    if (pic->stoverflow) {
+      pic_panic(pic, "VM stack overflow while handling VM stack overflow");
+    }
+    pic->stoverflow = true;
+    pic_error(pic, "VM stack overflow", 0);
+  }
+
+  size = pic->stend - pic->stbase;
+  while (size < used + n) {
+    size *= 2;
+  }
+  if (size > limit) {
+    size = limit;
+  }
+
+  base = pic_malloc(pic, sizeof(pic_value) * size);
+  memcpy(base, pic->stbase, sizeof(pic_value) * used);
+
+  for (ci = pic->ci; ci > pic->cibase; --ci) {
+    ci->fp = base + (ci->fp - pic->stbase);
+    if (ci->irep != NULL) {
+      if (ci->cxt != NULL && ci->cxt->regs == ci->regs) {
+        ci->cxt->regs = base + (ci->regs - pic->stbase);
+      }
+      ci->regs = base + (ci->regs - pic->stbase);
+    }
+  }
+
+  /* C functions may still hold argv pointers into the old block */
+  old = pic_malloc(pic, sizeof(struct stack_block));
+  old->base = pic->stbase;
+  old->prev = pic->stretired;
+  pic->stretired = old;
+
+  pic->stbase = base;
+  pic->sp = base + used;
+  pic->stend = base + size;
+}
+
+static void
+vm_grow_callinfo(pic_state *pic, size_t n)
+{
+  size_t size, used;
+
+  used = pic->ci - pic->cibase;
+  size = pic->ciend - pic->cibase;
+  while (size <= used + n) {
+    size *= 2;
+  }
+  pic->cibase = pic_realloc(pic, pic->cibase, sizeof(struct callinfo) * size);
+  pic->ci = pic->cibase + used;
+  pic->ciend = pic->cibase + size;
+}
+
+void
+pic_vm_grow(pic_state *pic, int sn, int cn)
+{
+  if (pic->stend - pic->sp < sn) {
+    vm_grow_stack(pic, sn);
+  }
+  if (pic->ciend - pic->ci <= cn) {
+    vm_grow_callinfo(pic, cn);
+  }
+}
+
+/* called once control escapes back to a saved point */
+void
+pic_vm_recover(pic_state *pic)
+{
+  if (pic->stoverflow && pic->sp - pic->stbase < PIC_STACK_MAX) {
+    pic->stoverflow = false;
+    if (pic->stend - pic->stbase > PIC_STACK_MAX) {
+      pic->stend = pic->stbase + PIC_STACK_MAX; /* hide the emergency area */
     }
   }
 }
 
+void
+pic_vm_release(pic_state *pic)
+{
+  struct stack_block *old;
+
+  while ((old = pic->stretired) != NULL) {
+    pic->stretired = old->prev;
+    pic_free(pic, old->base);
+    pic_free(pic, old);
+  }
+}
+
+pic_samplef
+pic_atsample(pic_state *pic, int period, pic_samplef f)
+{
+  pic_samplef old = pic->samplef;
+
+  pic->samplef = f;
+  pic->sample_period = f ? period : 0;
+  pic->sample_count = pic->sample_period;
+  return old;
+}
+
+void
+pic_sample_soon(pic_state *pic)
+{
+  if (pic->samplef) {
+    pic->sample_count = 1;
+  }
+}
+
+/* pic->ci is the frame running, after a call the new one */
+static void
+vm_sample(pic_state *pic)
+{
+  pic->sample_count = pic->sample_period;
+  pic->samplef(pic);
+}
+
+#define VM_SAMPLE() do {                                                \
+    if (pic->sample_count != 0 && --pic->sample_count == 0) {           \
+      vm_sample(pic);                                                   \
+    }                                                                   \
+  } while (0)
+
 #if PIC_DIRECT_THREADED_VM
-# define VM_LOOP JUMP;
+# define VM_LOOP NEXT;
 # define CASE(x) L_##x:
-# define NEXT pic->ip++; JUMP;
-# define JUMP c = *pic->ip; goto *oplabels[c.insn];
+# define NEXT goto *oplabels[*ip++]
 # define VM_LOOP_END
 #else
-# define VM_LOOP for (;;) { c = *pic->ip; switch (c.insn) {
+# define VM_LOOP for (;;) { switch (*ip++) {
 # define CASE(x) case x:
-# define NEXT pic->ip++; break
-# define JUMP break
+# define NEXT break
 # define VM_LOOP_END } }
 #endif
 
+/* operands; see vm.h for the encoding */
+#define READ_INT(x) do {                        \
+    (x) = *ip++;                                \
+    if ((x) == PIC_CODE_WIDE) {                 \
+      (x) = pic_code_int32(ip);                 \
+      ip += 4;                                  \
+    }                                           \
+  } while (0)
+#define READ_JMP(x) ((x) = pic_code_int32(ip), ip += 4)
+
 #define PUSH(v) (*pic->sp++ = (v))
 #define POP() (*--pic->sp)
 
@@ -336,14 +630,181 @@ bool pic_le(pic_state *, pic_value, pic_value);
 bool pic_gt(pic_state *, pic_value, pic_value);
 bool pic_ge(pic_state *, pic_value, pic_value);
 
+/* exact quotient only; anything else is left to pic_div */
+PIC_INLINE bool
+checked_div(int a, int b, int *r)
+{
+  if (b == 0 || (a == INT_MIN && b == -1) || a % b != 0) {
+    return false;
+  }
+  *r = a / b;
+  return true;
+}
+
+#define VM_BOTH_P(a, b, ty)                                             \
+  (pic_vtype(pic, a) == PIC_TYPE_##ty && pic_vtype(pic, b) == PIC_TYPE_##ty)
+
+#define VM_ARITH(checked, op, slow, a, b) do {                          \
+    int r;                                                              \
+    if (VM_BOTH_P(a, b, INT) && checked(pic_unbox_int(a), pic_unbox_int(b), &r)) { \
+      PUSH(pic_box_int(r));                                             \
+    } else if (VM_BOTH_P(a, b, FLOAT)) {                                \
+      PUSH(pic_box_float(pic_unbox_float(a) op pic_unbox_float(b)));    \
+    } else {                                                            \
+      PUSH(slow(pic, a, b));                                            \
+    }                                                                   \
+  } while (0)
+
+#define VM_AOP(checked, op, slow) do {                                  \
+    pic_value a, b;                                                     \
+    b = POP();                                                          \
+    a = POP();                                                          \
+    VM_ARITH(checked, op, slow, a, b);                                  \
+  } while (0)
+
+#define VM_AOPI(checked, op, slow) do {                                 \
+    pic_value a, b;                                                     \
+    int i;                                                              \
+    READ_INT(i);                                                        \
+    a = POP();                                                          \
+    b = pic_box_int(i);                                                 \
+    VM_ARITH(checked, op, slow, a, b);                                  \
+  } while (0)
+
+#define VM_TEST(op, slow, r) do {                                       \
+    pic_value a, b;                                                     \
+    b = POP();                                                          \
+    a = POP();                                                          \
+    if (VM_BOTH_P(a, b, INT)) {                                         \
+      r = pic_unbox_int(a) op pic_unbox_int(b);                         \
+    } else if (VM_BOTH_P(a, b, FLOAT)) {                                \
+      r = pic_unbox_float(a) op pic_unbox_float(b);                     \
+    } else {                                                            \
+      r = slow(pic, a, b);                                              \
+    }                                                                   \
+  } while (0)
+
+#define VM_CMP(op, slow) do {                                           \
+    bool r;                                                             \
+    VM_TEST(op, slow, r);                                               \
+    PUSH(pic_bool_value(pic, r));                                       \
+  } while (0)
+
+#define VM_JMPIF(cond) do {                                             \
+    int off;                                                            \
+    READ_JMP(off);                                                      \
+    if (cond) {                                                         \
+      ip += off;                                                        \
+    }                                                                   \
+  } while (0)
+
+#define VM_JMPCMP(op, slow) do {                                        \
+    bool r;                                                             \
+    VM_TEST(op, slow, r);                                               \
+    VM_JMPIF(r);                                                        \
+  } while (0)
+
+#define VM_PRED(p) do {                                                 \
+    pic_value v = POP();                                                \
+    PUSH(pic_bool_value(pic, p(pic, v)));                               \
+  } while (0)
+
+/*
+ * Inlined primitives take their fast path when the arguments are what the
+ * primitive expects; anything else is left to a call of the builtin itself,
+ * which raises the same errors it always does and replaces the operands
+ * on the stack with its result.
+ */
+static void
+vm_builtin(pic_state *pic, const char *name, int n)
+{
+  pic_value argv[3], r;
+  int i;
+
+  for (i = 0; i < n; ++i) {
+    argv[i] = pic->sp[i - n];   /* still on the stack for the GC */
+  }
+  r = pic_apply(pic, pic_ref(pic, "picrin.base", name), n, argv);
+  pic->sp -= n;
+  PUSH(r);
+}
+
+#define VM_INDEX_P(x, i, ty, len)                                       \
+  (pic_vtype(pic, i) == PIC_TYPE_INT && pic_type(pic, x) == PIC_TYPE_##ty \
+   && pic_unbox_int(i) >= 0 && pic_unbox_int(i) < len(pic, x))
+
+/* captured locals live in the context once the frame is torn off */
+PIC_INLINE pic_value *
+vm_local(struct callinfo *ci, int i)
+{
+  if (ci->cxt != NULL && ci->cxt->regs == ci->cxt->storage) {
+    if (i >= ci->irep->argc + ci->irep->localc) {
+      return &ci->cxt->regs[i - (ci->regs - ci->fp)];
+    }
+  }
+  return &ci->fp[i];
+}
+
+PIC_INLINE void
+vm_lset(pic_state *pic, int i, pic_value v)
+{
+  struct callinfo *ci = pic->ci;
+  pic_value *var;
+
+  var = vm_local(ci, i);
+  *var = v;
+  if (var != ci->fp + i) {      /* in the context */
+    pic_gc_write_barrier(pic, (struct object *)ci->cxt, v);
+  }
+}
+
+static pic_value vm_run(pic_state *, const pic_code *);
+
 pic_value
 pic_apply(pic_state *pic, pic_value proc, int argc, pic_value *argv)
 {
-  struct code c;
-  size_t ai = pic_enter(pic);
-  struct code boot[2];
+  pic_code boot[8];
   int i;
 
+  pic_vm_reserve(pic, argc + 1, 1);
+
+  PUSH(proc);
+
+  for (i = 0; i < argc; ++i) {
+    PUSH(argv[i]);
+  }
+
+  /* boot! */
+  boot[0] = OP_CALL;
+  if (argc + 1 < PIC_CODE_WIDE) {
+    boot[1] = (pic_code)(argc + 1);
+    boot[2] = OP_STOP;
+  } else {
+    boot[1] = PIC_CODE_WIDE;
+    pic_code_put_int32(boot + 2, argc + 1);
+    boot[6] = OP_STOP;
+  }
+
+  return vm_run(pic, boot);
+}
+
+/* frames already on the callinfo stack continue at ip; the bottom one must
+   return to pic_vm_stop */
+pic_value
+pic_vm_resume(pic_state *pic, const pic_code *ip)
+{
+  return vm_run(pic, ip);
+}
+
+const pic_code pic_vm_stop[] = { OP_STOP };
+
+static pic_value
+vm_run(pic_state *pic, const pic_code *ip)
+{
+  size_t ai = pic_enter(pic);
+  int a, b;
+  pic_value tail = pic_nil_value(pic); /* rest list handed over by apply */
+
 #if PIC_DIRECT_THREADED_VM
   static const void *oplabels[] = {
     &&L_OP_NOP, &&L_OP_POP, &&L_OP_PUSHUNDEF, &&L_OP_PUSHNIL, &&L_OP_PUSHTRUE,
@@ -351,25 +812,22 @@ pic_apply(pic_state *pic, pic_value proc, int argc, pic_value *argv)
     &&L_OP_PUSHCHAR, &&L_OP_PUSHEOF, &&L_OP_PUSHCONST,
     &&L_OP_GREF, &&L_OP_GSET, &&L_OP_LREF, &&L_OP_LSET, &&L_OP_CREF, &&L_OP_CSET,
     &&L_OP_JMP, &&L_OP_JMPIF, &&L_OP_NOT, &&L_OP_CALL, &&L_OP_TAILCALL, &&L_OP_RET,
-    &&L_OP_LAMBDA, &&L_OP_CONS, &&L_OP_CAR, &&L_OP_CDR, &&L_OP_NILP,
+    &&L_OP_LAMBDA, &&L_OP_PROC, &&L_OP_CONS, &&L_OP_CAR, &&L_OP_CDR, &&L_OP_NILP,
     &&L_OP_SYMBOLP, &&L_OP_PAIRP,
     &&L_OP_ADD, &&L_OP_SUB, &&L_OP_MUL, &&L_OP_DIV,
-    &&L_OP_EQ, &&L_OP_LT, &&L_OP_LE, &&L_OP_GT, &&L_OP_GE, &&L_OP_STOP
+    &&L_OP_EQ, &&L_OP_LT, &&L_OP_LE, &&L_OP_GT, &&L_OP_GE,
+    &&L_OP_EQP, &&L_OP_EQVP, &&L_OP_SETCAR, &&L_OP_SETCDR,
+    &&L_OP_VECTORP, &&L_OP_VREF, &&L_OP_VSET, &&L_OP_VLEN,
+    &&L_OP_STRINGP, &&L_OP_SREF, &&L_OP_SLEN,
+    &&L_OP_CHARP, &&L_OP_CHAREQ, &&L_OP_CHARLT, &&L_OP_CHAR2INT,
+    &&L_OP_RECORDP, &&L_OP_RECTYPE, &&L_OP_RECDATUM, &&L_OP_GTEMPL, &&L_OP_STOP,
+    &&L_OP_LCAR, &&L_OP_LCDR, &&L_OP_LPOP, &&L_OP_LRET, &&L_OP_ADDI, &&L_OP_SUBI,
+    &&L_OP_JMPNOT, &&L_OP_JMPNILP, &&L_OP_JMPPAIRP,
+    &&L_OP_JMPEQ, &&L_OP_JMPLT, &&L_OP_JMPLE, &&L_OP_JMPGT, &&L_OP_JMPGE,
+    &&L_OP_JMPEQP, &&L_OP_CCALL, &&L_OP_LTAILCALL
   };
 #endif
 
-  PUSH(proc);
-
-  for (i = 0; i < argc; ++i) {
-    PUSH(argv[i]);
-  }
-
-  /* boot! */
-  boot[0].insn = OP_CALL;
-  boot[0].a = argc + 1;
-  boot[1].insn = OP_STOP;
-  pic->ip = boot;
-
   VM_LOOP {
     CASE(OP_NOP) {
       NEXT;
@@ -395,15 +853,18 @@ pic_apply(pic_state *pic, pic_value proc, int argc, pic_value *argv)
       NEXT;
     }
     CASE(OP_PUSHINT) {
-      PUSH(pic_int_value(pic, pic->ci->irep->ints[c.a]));
+      READ_INT(a);
+      PUSH(pic_int_value(pic, a));
       NEXT;
     }
     CASE(OP_PUSHFLOAT) {
-      PUSH(pic_float_value(pic, pic->ci->irep->nums[c.a]));
+      READ_INT(a);
+      PUSH(pic_float_value(pic, pic->ci->irep->nums[a]));
       NEXT;
     }
     CASE(OP_PUSHCHAR) {
-      PUSH(pic_char_value(pic, pic->ci->irep->ints[c.a]));
+      READ_INT(a);
+      PUSH(pic_char_value(pic, (char)a));
       NEXT;
     }
     CASE(OP_PUSHEOF) {
@@ -411,115 +872,119 @@ pic_apply(pic_state *pic, pic_value proc, int argc, pic_value *argv)
       NEXT;
     }
     CASE(OP_PUSHCONST) {
-      PUSH(pic_obj_value(pic->ci->irep->pool[c.a]));
+      READ_INT(a);
+      PUSH(pic_obj_value(pic->ci->irep->pool[a]));
       NEXT;
     }
     CASE(OP_GREF) {
-      PUSH(global_ref(pic, pic_obj_value(pic->ci->irep->pool[c.a])));
+      READ_INT(a);
+      PUSH(global_ref(pic, (struct cell *)pic->ci->irep->pool[a]));
       NEXT;
     }
     CASE(OP_GSET) {
-      global_set(pic, pic_obj_value(pic->ci->irep->pool[c.a]), POP());
+      READ_INT(a);
+      global_set(pic, (struct cell *)pic->ci->irep->pool[a], POP());
       PUSH(pic_undef_value(pic));
       NEXT;
     }
+    CASE(OP_GTEMPL) {
+      READ_INT(a);
+      PUSH(pic_bool_value(pic, pic_pair_p(pic, ((struct cell *)pic->ci->irep->pool[a])->templ)));
+      NEXT;
+    }
     CASE(OP_LREF) {
-      struct callinfo *ci = pic->ci;
-      struct irep *irep = ci->irep;
-
-      if (ci->cxt != NULL && ci->cxt->regs == ci->cxt->storage) {
-        if (c.a >= irep->argc + irep->localc) {
-          PUSH(ci->cxt->regs[c.a - (ci->regs - ci->fp)]);
-          NEXT;
-        }
-      }
-      PUSH(pic->ci->fp[c.a]);
+      READ_INT(a);
+      PUSH(*vm_local(pic->ci, a));
       NEXT;
     }
     CASE(OP_LSET) {
-      struct callinfo *ci = pic->ci;
-      struct irep *irep = ci->irep;
-
-      if (ci->cxt != NULL && ci->cxt->regs == ci->cxt->storage) {
-        if (c.a >= irep->argc + irep->localc) {
-          ci->cxt->regs[c.a - (ci->regs - ci->fp)] = POP();
-          PUSH(pic_undef_value(pic));
-          NEXT;
-        }
-      }
-      pic->ci->fp[c.a] = POP();
+      READ_INT(a);
+      vm_lset(pic, a, POP());
       PUSH(pic_undef_value(pic));
       NEXT;
     }
     CASE(OP_CREF) {
-      int depth = c.a;
       struct context *cxt;
 
+      READ_INT(a);
+      READ_INT(b);
       cxt = pic->ci->up;
-      while (--depth) {
+      while (--a) {
 	cxt = cxt->up;
       }
-      PUSH(cxt->regs[c.b]);
+      PUSH(cxt->regs[b]);
       NEXT;
     }
     CASE(OP_CSET) {
-      int depth = c.a;
       struct context *cxt;
 
+      READ_INT(a);
+      READ_INT(b);
       cxt = pic->ci->up;
-      while (--depth) {
+      while (--a) {
 	cxt = cxt->up;
       }
-      cxt->regs[c.b] = POP();
+      cxt->regs[b] = POP();
+      pic_gc_write_barrier(pic, (struct object *)cxt, cxt->regs[b]);
       PUSH(pic_undef_value(pic));
       NEXT;
     }
     CASE(OP_JMP) {
-      pic->ip += c.a;
-      JUMP;
-    }
-    CASE(OP_JMPIF) {
-      pic_value v;
+      int off;
 
-      v = POP();
-      if (! pic_false_p(pic, v)) {
-	pic->ip += c.a;
-	JUMP;
+      READ_JMP(off);
+      ip += off;
+      if (off < 0) {            /* a loop, see emit_loop */
+        VM_SAMPLE();
       }
       NEXT;
     }
+    CASE(OP_JMPIF) {
+      VM_JMPIF(! pic_false_p(pic, POP()));
+      NEXT;
+    }
     CASE(OP_CALL) {
       pic_value x, v;
       struct callinfo *ci;
       struct proc *proc;
 
-      if (c.a == -1) {
+      READ_INT(a);
+      if (a == -1) {
         pic->sp += pic->ci[1].retc - 1;
-        c.a = pic->ci[1].retc + 1;
+        a = pic->ci[1].retc + 1;
       }
 
     L_CALL:
-      x = pic->sp[-c.a];
+      x = pic->sp[-a];
       if (! pic_proc_p(pic, x)) {
 	pic_error(pic, "invalid application", 1, x);
       }
       proc = pic_proc_ptr(pic, x);
 
-      if (pic->sp >= pic->stend) {
-        pic_panic(pic, "VM stack overflow");
+      /* room for the return value, or for the locals and operands of irep */
+      if (proc->tt == PIC_TYPE_FUNC) {
+        pic_vm_reserve(pic, 1, 1);
+      } else {
+        pic_vm_reserve(pic, proc->u.i.irep->localc + (int)proc->u.i.irep->ncode + 1, 1);
       }
 
       ci = PUSHCI();
-      ci->argc = c.a;
+      ci->argc = a;
       ci->retc = 1;
-      ci->ip = pic->ip;
-      ci->fp = pic->sp - c.a;
+      ci->ip = ip;
+      ci->fp = pic->sp - a;
       ci->irep = NULL;
       ci->cxt = NULL;
+      VM_SAMPLE();
       if (proc->tt == PIC_TYPE_FUNC) {
 
         /* invoke! */
-        v = proc->u.f.func(pic);
+        if (proc->u.f.sig == NULL) {
+          v = proc->u.f.func(pic);
+        } else {
+          check_sig(pic, proc, a - 1, ci->fp + 1);
+          v = ((pic_native_t)(void (*)(void))proc->u.f.func)(pic, a - 1, ci->fp + 1);
+        }
         pic->sp[0] = v;
         pic->sp += pic->ci->retc;
 
@@ -537,13 +1002,16 @@ pic_apply(pic_state *pic, pic_value proc, int argc, pic_value *argv)
             arg_error(pic, ci->argc - 1, irep->varg, irep->argc - 1);
 	  }
 	}
-	/* prepare rest args */
+	/* prepare rest args; each pair replaces its element on the stack */
 	if (irep->varg) {
-	  rest = pic_nil_value(pic);
-	  for (i = 0; i < ci->argc - irep->argc; ++i) {
-	    pic_protect(pic, v = POP());
-	    rest = pic_cons(pic, v, rest);
+	  rest = tail;
+	  tail = pic_nil_value(pic);
+	  pic_protect(pic, rest);
+	  for (i = 1; i <= ci->argc - irep->argc; ++i) {
+	    rest = pic_cons(pic, pic->sp[-i], rest);
+	    pic->sp[-i] = rest;
 	  }
+	  pic->sp -= ci->argc - irep->argc;
 	  PUSH(rest);
 	}
 	/* prepare local variable area */
@@ -562,44 +1030,71 @@ pic_apply(pic_state *pic, pic_value proc, int argc, pic_value *argv)
         ci->regc = irep->capturec;
         ci->regs = ci->fp + irep->argc + irep->localc;
 
-	pic->ip = irep->code;
+	ip = irep->code;
 	pic_leave(pic, ai);
-	JUMP;
+	NEXT;
       }
     }
     CASE(OP_TAILCALL) {
-      int i, argc;
+      int i;
       pic_value *argv;
       struct callinfo *ci;
 
+    L_TAILCALL:
       if (pic->ci->cxt != NULL) {
-        vm_tear_off(pic->ci);
+        vm_tear_off(pic, pic->ci);
       }
 
-      if (c.a == -1) {
+      READ_INT(a);
+      if (a < 0) {
         pic->sp += pic->ci[1].retc - 1;
-        c.a = pic->ci[1].retc + 1;
+        if (a == -2) {
+          /* from apply: the last value is the tail of the callee's rest list */
+          pic_protect(pic, tail = POP());
+          a = pic->ci[1].retc;
+        } else {
+          a = pic->ci[1].retc + 1;
+        }
       }
 
-      argc = c.a;
-      argv = pic->sp - argc;
-      for (i = 0; i < argc; ++i) {
+      argv = pic->sp - a;
+      for (i = 0; i < a; ++i) {
 	pic->ci->fp[i] = argv[i];
       }
       ci = POPCI();
-      pic->sp = ci->fp + argc;
-      pic->ip = ci->ip;
+      pic->sp = ci->fp + a;
+      ip = ci->ip;
 
-      /* c is not changed */
+      /* a is not changed */
+      goto L_CALL;
+    }
+    CASE(OP_CCALL) {
+      READ_INT(b);
+      PUSH(pic_obj_value(pic->ci->irep->pool[b]));
+      READ_INT(a);
       goto L_CALL;
     }
+    CASE(OP_LTAILCALL) {
+      READ_INT(b);
+      PUSH(*vm_local(pic->ci, b)); /* before the frame is torn off */
+      goto L_TAILCALL;
+    }
+    CASE(OP_LRET) {
+      pic_value v;
+
+      READ_INT(a);
+      v = *vm_local(pic->ci, a);
+      PUSH(v);
+      goto L_TEAR_OFF;
+    }
     CASE(OP_RET) {
       int i, retc;
       pic_value *retv;
       struct callinfo *ci;
 
+    L_TEAR_OFF:
       if (pic->ci->cxt != NULL) {
-        vm_tear_off(pic->ci);
+        vm_tear_off(pic, pic->ci);
       }
 
       assert(pic->ci->retc == 1);
@@ -615,16 +1110,23 @@ pic_apply(pic_state *pic, pic_value proc, int argc, pic_value *argv)
       }
       ci = POPCI();
       pic->sp = ci->fp + 1;     /* advance only one! */
-      pic->ip = ci->ip;
+      ip = ci->ip;
 
       NEXT;
     }
     CASE(OP_LAMBDA) {
+      READ_INT(a);
       if (pic->ci->cxt == NULL) {
         vm_push_cxt(pic);
       }
 
-      PUSH(pic_make_proc_irep(pic, pic->ci->irep->irep[c.a], pic->ci->cxt));
+      PUSH(pic_make_proc_irep(pic, pic->ci->irep->irep[a], pic->ci->cxt));
+      pic_leave(pic, ai);
+      NEXT;
+    }
+    CASE(OP_PROC) {
+      READ_INT(a);
+      PUSH(pic_make_proc_irep(pic, pic->ci->irep->irep[a], NULL));
       pic_leave(pic, ai);
       NEXT;
     }
@@ -649,6 +1151,21 @@ pic_apply(pic_state *pic, pic_value proc, int argc, pic_value *argv)
       PUSH(pic_cdr(pic, p));
       NEXT;
     }
+    CASE(OP_LCAR) {
+      READ_INT(a);
+      PUSH(pic_car(pic, *vm_local(pic->ci, a)));
+      NEXT;
+    }
+    CASE(OP_LCDR) {
+      READ_INT(a);
+      PUSH(pic_cdr(pic, *vm_local(pic->ci, a)));
+      NEXT;
+    }
+    CASE(OP_LPOP) {
+      READ_INT(a);
+      vm_lset(pic, a, POP());
+      NEXT;
+    }
     CASE(OP_NILP) {
       pic_value p;
       p = POP();
@@ -675,70 +1192,251 @@ pic_apply(pic_state *pic, pic_value proc, int argc, pic_value *argv)
     }
 
     CASE(OP_ADD) {
-      pic_value a, b;
-      b = POP();
-      a = POP();
-      PUSH(pic_add(pic, a, b));
+      VM_AOP(pic_checked_add, +, pic_add);
       NEXT;
     }
     CASE(OP_SUB) {
-      pic_value a, b;
-      b = POP();
-      a = POP();
-      PUSH(pic_sub(pic, a, b));
+      VM_AOP(pic_checked_sub, -, pic_sub);
       NEXT;
     }
     CASE(OP_MUL) {
-      pic_value a, b;
-      b = POP();
-      a = POP();
-      PUSH(pic_mul(pic, a, b));
+      VM_AOP(pic_checked_mul, *, pic_mul);
       NEXT;
     }
     CASE(OP_DIV) {
-      pic_value a, b;
-      b = POP();
-      a = POP();
-      PUSH(pic_div(pic, a, b));
+      VM_AOP(checked_div, /, pic_div);
+      NEXT;
+    }
+    CASE(OP_ADDI) {
+      VM_AOPI(pic_checked_add, +, pic_add);
+      NEXT;
+    }
+    CASE(OP_SUBI) {
+      VM_AOPI(pic_checked_sub, -, pic_sub);
       NEXT;
     }
     CASE(OP_EQ) {
-      pic_value a, b;
-      b = POP();
-      a = POP();
-      PUSH(pic_bool_value(pic, pic_eq(pic, a, b)));
+      VM_CMP(==, pic_eq);
       NEXT;
     }
     CASE(OP_LE) {
-      pic_value a, b;
-      b = POP();
-      a = POP();
-      PUSH(pic_bool_value(pic, pic_le(pic, a, b)));
+      VM_CMP(<=, pic_le);
       NEXT;
     }
     CASE(OP_LT) {
+      VM_CMP(<, pic_lt);
+      NEXT;
+    }
+    CASE(OP_GE) {
+      VM_CMP(>=, pic_ge);
+      NEXT;
+    }
+    CASE(OP_GT) {
+      VM_CMP(>, pic_gt);
+      NEXT;
+    }
+
+    CASE(OP_JMPNOT) {
+      VM_JMPIF(pic_false_p(pic, POP()));
+      NEXT;
+    }
+    CASE(OP_JMPNILP) {
+      VM_JMPIF(pic_nil_p(pic, POP()));
+      NEXT;
+    }
+    CASE(OP_JMPPAIRP) {
+      VM_JMPIF(pic_pair_p(pic, POP()));
+      NEXT;
+    }
+    CASE(OP_JMPEQ) {
+      VM_JMPCMP(==, pic_eq);
+      NEXT;
+    }
+    CASE(OP_JMPLT) {
+      VM_JMPCMP(<, pic_lt);
+      NEXT;
+    }
+    CASE(OP_JMPLE) {
+      VM_JMPCMP(<=, pic_le);
+      NEXT;
+    }
+    CASE(OP_JMPGT) {
+      VM_JMPCMP(>, pic_gt);
+      NEXT;
+    }
+    CASE(OP_JMPGE) {
+      VM_JMPCMP(>=, pic_ge);
+      NEXT;
+    }
+
+    CASE(OP_EQP) {
       pic_value a, b;
       b = POP();
       a = POP();
-      PUSH(pic_bool_value(pic, pic_lt(pic, a, b)));
+      PUSH(pic_bool_value(pic, pic_eq_p(pic, a, b)));
       NEXT;
     }
-    CASE(OP_GE) {
+    CASE(OP_EQVP) {
       pic_value a, b;
       b = POP();
       a = POP();
-      PUSH(pic_bool_value(pic, pic_ge(pic, a, b)));
+      PUSH(pic_bool_value(pic, pic_eqv_p(pic, a, b)));
       NEXT;
     }
-    CASE(OP_GT) {
+    CASE(OP_JMPEQP) {
       pic_value a, b;
       b = POP();
       a = POP();
-      PUSH(pic_bool_value(pic, pic_gt(pic, a, b)));
+      VM_JMPIF(pic_eq_p(pic, a, b));
+      NEXT;
+    }
+    CASE(OP_SETCAR) {
+      pic_value p = pic->sp[-2], v = pic->sp[-1];
+      if (pic_pair_p(pic, p)) {
+        pic->sp -= 2;
+        pic_pair_ptr(pic, p)->car = v;
+        pic_gc_write_barrier(pic, pic_obj_ptr(p), v);
+        PUSH(pic_undef_value(pic));
+      } else {
+        vm_builtin(pic, "set-car!", 2);
+      }
+      NEXT;
+    }
+    CASE(OP_SETCDR) {
+      pic_value p = pic->sp[-2], v = pic->sp[-1];
+      if (pic_pair_p(pic, p)) {
+        pic->sp -= 2;
+        pic_pair_ptr(pic, p)->cdr = v;
+        pic_gc_write_barrier(pic, pic_obj_ptr(p), v);
+        PUSH(pic_undef_value(pic));
+      } else {
+        vm_builtin(pic, "set-cdr!", 2);
+      }
+      NEXT;
+    }
+    CASE(OP_VECTORP) {
+      VM_PRED(pic_vec_p);
+      NEXT;
+    }
+    CASE(OP_VREF) {
+      pic_value x = pic->sp[-2], i = pic->sp[-1];
+      if (VM_INDEX_P(x, i, VECTOR, pic_vec_len)) {
+        pic->sp -= 2;
+        PUSH(pic_vec_ptr(pic, x)->data[pic_unbox_int(i)]);
+      } else {
+        vm_builtin(pic, "vector-ref", 2);
+      }
+      NEXT;
+    }
+    CASE(OP_VSET) {
+      pic_value x = pic->sp[-3], i = pic->sp[-2], v = pic->sp[-1];
+      if (VM_INDEX_P(x, i, VECTOR, pic_vec_len)) {
+        pic->sp -= 3;
+        pic_vec_ptr(pic, x)->data[pic_unbox_int(i)] = v;
+        pic_gc_write_barrier(pic, pic_obj_ptr(x), v);
+        PUSH(pic_undef_value(pic));
+      } else {
+        vm_builtin(pic, "vector-set!", 3);
+      }
+      NEXT;
+    }
+    CASE(OP_VLEN) {
+      pic_value x = pic->sp[-1];
+      if (pic_vec_p(pic, x)) {
+        pic->sp -= 1;
+        PUSH(pic_box_int(pic_vec_len(pic, x)));
+      } else {
+        vm_builtin(pic, "vector-length", 1);
+      }
+      NEXT;
+    }
+    CASE(OP_STRINGP) {
+      VM_PRED(pic_str_p);
+      NEXT;
+    }
+    CASE(OP_SREF) {
+      pic_value x = pic->sp[-2], i = pic->sp[-1];
+      if (VM_INDEX_P(x, i, STRING, pic_str_len)) {
+        pic->sp -= 2;
+        PUSH(pic_char_value(pic, pic_str_ref(pic, x, pic_unbox_int(i))));
+      } else {
+        vm_builtin(pic, "string-ref", 2);
+      }
+      NEXT;
+    }
+    CASE(OP_SLEN) {
+      pic_value x = pic->sp[-1];
+      if (pic_str_p(pic, x)) {
+        pic->sp -= 1;
+        PUSH(pic_box_int(pic_str_len(pic, x)));
+      } else {
+        vm_builtin(pic, "string-length", 1);
+      }
+      NEXT;
+    }
+    CASE(OP_CHARP) {
+      VM_PRED(pic_char_p);
+      NEXT;
+    }
+    CASE(OP_CHAREQ) {
+      pic_value a = pic->sp[-2], b = pic->sp[-1];
+      if (pic_char_p(pic, a) && pic_char_p(pic, b)) {
+        pic->sp -= 2;
+        PUSH(pic_bool_value(pic, pic_char(pic, a) == pic_char(pic, b)));
+      } else {
+        vm_builtin(pic, "char=?", 2);
+      }
+      NEXT;
+    }
+    CASE(OP_CHARLT) {
+      pic_value a = pic->sp[-2], b = pic->sp[-1];
+      if (pic_char_p(pic, a) && pic_char_p(pic, b)) {
+        pic->sp -= 2;
+        PUSH(pic_bool_value(pic, pic_char(pic, a) < pic_char(pic, b)));
+      } else {
+        vm_builtin(pic, "char<?", 2);
+      }
+      NEXT;
+    }
+    CASE(OP_CHAR2INT) {
+      pic_value c = pic->sp[-1];
+      if (pic_char_p(pic, c)) {
+        pic->sp -= 1;
+        PUSH(pic_box_int(pic_char(pic, c)));
+      } else {
+        vm_builtin(pic, "char->integer", 1);
+      }
+      NEXT;
+    }
+    CASE(OP_RECORDP) {
+      VM_PRED(pic_rec_p);
+      NEXT;
+    }
+    CASE(OP_RECTYPE) {
+      pic_value r = pic->sp[-1];
+      if (pic_rec_p(pic, r)) {
+        pic->sp -= 1;
+        PUSH(pic_rec_ptr(pic, r)->type);
+      } else {
+        vm_builtin(pic, "record-type", 1);
+      }
+      NEXT;
+    }
+    CASE(OP_RECDATUM) {
+      pic_value r = pic->sp[-1];
+      if (pic_rec_p(pic, r)) {
+        pic->sp -= 1;
+        PUSH(pic_rec_ptr(pic, r)->datum);
+      } else {
+        vm_builtin(pic, "record-datum", 1);
+      }
       NEXT;
     }
 
     CASE(OP_STOP) {
+      if (pic->ci == pic->cibase && pic->stretired != NULL) {
+        pic_vm_release(pic);
+      }
       return pic_protect(pic, POP());
     }
   } VM_LOOP_END;
@@ -747,11 +1445,13 @@ pic_apply(pic_state *pic, pic_value proc, int argc, pic_value *argv)
 pic_value
 pic_applyk(pic_state *pic, pic_value proc, int argc, pic_value *args)
 {
-  static const struct code iseq[2] = { { OP_NOP, 0, 0 }, { OP_TAILCALL, -1, 0 } };
+  static const pic_code iseq[] = { OP_TAILCALL, PIC_CODE_WIDE, 0xff, 0xff, 0xff, 0xff }; /* -1 */
   pic_value *sp;
   struct callinfo *ci;
   int i;
 
+  pic_vm_reserve(pic, argc + 1, 1);
+
   *pic->sp++ = proc;
 
   sp = pic->sp;
@@ -763,6 +1463,8 @@ pic_applyk(pic_state *pic, pic_value proc, int argc, pic_value *args)
   ci->ip = iseq;
   ci->fp = pic->sp;
   ci->retc = (int)argc;
+  ci->irep = NULL;
+  ci->cxt = NULL;
 
   if (ci->retc == 0) {
     return pic_undef_value(pic);
@@ -826,6 +1528,18 @@ pic_defun(pic_state *pic, const char *name, pic_func_t f)
   pic_export(pic, pic_intern_cstr(pic, name));
 }
 
+void
+pic_defun_sig(pic_state *pic, const char *name, const char *sig, pic_native_t f)
+{
+  pic_value proc;
+
+  /* natives share the func slot so that they keep a distinct identity */
+  proc = pic_make_proc(pic, (pic_func_t)(void (*)(void))f, 0, NULL);
+  parse_sig(pic, pic_proc_ptr(pic, proc), sig);
+  pic_define(pic, pic_current_library(pic), name, proc);
+  pic_export(pic, pic_intern_cstr(pic, name));
+}
+
 void
 pic_defvar(pic_state *pic, const char *name, pic_value init, pic_value conv)
 {
@@ -837,40 +1551,54 @@ void
 pic_define(pic_state *pic, const char *lib, const char *name, pic_value val)
 {
   pic_value sym, uid, env;
+  struct cell *cell;
 
   sym = pic_intern_cstr(pic, name);
 
   env = pic_library_environment(pic, lib);
 
   uid = pic_find_identifier(pic, sym, env);
-  if (pic_weak_has(pic, pic->globals, uid)) {
+  cell = pic_global_cell(pic, uid);
+  if (cell->defined) {
     pic_warnf(pic, "redefining variable: %s", pic_sym(pic, uid));
+    cell->templ = pic_false_value(pic);
   }
-  pic_weak_set(pic, pic->globals, uid, val);
+  cell->defined = true;
+  cell->value = val;
+  pic_gc_write_barrier(pic, (struct object *)cell, val);
 }
 
-pic_value
-pic_ref(pic_state *pic, const char *lib, const char *name)
+static struct cell *
+find_global(pic_state *pic, const char *lib, const char *name)
 {
-  pic_value sym, env;
+  pic_value sym, uid, env;
 
   sym = pic_intern_cstr(pic, name);
 
   env = pic_library_environment(pic, lib);
 
-  return global_ref(pic, pic_find_identifier(pic, sym, env));
+  uid = pic_find_identifier(pic, sym, env);
+  if (! pic_global_defined_p(pic, uid)) {
+    pic_error(pic, "undefined variable", 1, uid);
+  }
+  return pic_cell_ptr(pic, pic_weak_ref(pic, pic->globals, uid));
+}
+
+pic_value
+pic_ref(pic_state *pic, const char *lib, const char *name)
+{
+  return global_ref(pic, find_global(pic, lib, name));
 }
 
 void
 pic_set(pic_state *pic, const char *lib, const char *name, pic_value val)
 {
-  pic_value sym, env;
-
-  sym = pic_intern_cstr(pic, name);
-
-  env = pic_library_environment(pic, lib);
+  struct cell *cell = find_global(pic, lib, name);
 
-  global_set(pic, pic_find_identifier(pic, sym, env), val);
+  /* callers are inlined with the template only while it is the value */
+  cell->templ = pic_false_value(pic);
+  pic_image_effect(pic, PIC_IMAGE_INLINE, pic_obj_value(cell->uid), pic_false_value(pic), pic_undef_value(pic));
+  global_set(pic, cell, val);
 }
 
 pic_value
@@ -897,6 +1625,7 @@ pic_closure_set(pic_state *pic, int n, pic_value v)
     pic_error(pic, "pic_closure_ref: index out of range", 1, pic_int_value(pic, n));
   }
   pic_proc_ptr(pic, self)->locals[n] = v;
+  pic_gc_write_barrier(pic, pic_obj_ptr(self), v);
 }
 
 pic_value
@@ -929,7 +1658,6 @@ pic_irep_decref(pic_state *pic, struct irep *irep)
 
   if (--irep->refc == 0) {
     pic_free(pic, irep->code);
-    pic_free(pic, irep->ints);
     pic_free(pic, irep->nums);
     pic_free(pic, irep->pool);
 
@@ -956,6 +1684,7 @@ pic_make_proc(pic_state *pic, pic_func_t func, int n, pic_value *env)
   proc = (struct proc *)pic_obj_alloc(pic, offsetof(struct proc, locals) + sizeof(pic_value) * n, PIC_TYPE_FUNC);
   proc->u.f.func = func;
   proc->u.f.localc = n;
+  proc->u.f.sig = NULL;
   for (i = 0; i < n; ++i) {
     proc->locals[i] = env[i];
   }
@@ -975,43 +1704,68 @@ pic_make_proc_irep(pic_state *pic, struct irep *irep, struct context *cxt)
 }
 
 static pic_value
-pic_proc_proc_p(pic_state *pic)
+pic_proc_proc_p(pic_state *pic, int PIC_UNUSED(argc), pic_value *argv)
 {
-  pic_value v;
-
-  pic_get_args(pic, "o", &v);
-
-  return pic_bool_value(pic, pic_proc_p(pic, v));
+  return pic_bool_value(pic, pic_proc_p(pic, argv[0]));
 }
 
+/*
+ * The arguments are pushed straight onto the VM stack as the list is
+ * walked, so a list too long for the stack raises a stack overflow
+ * instead of exhausting the C heap. A procedure taking rest arguments
+ * gets the tail of the list itself once its required parameters are
+ * filled, which a rest list of the caller passes through unchanged.
+ */
 static pic_value
-pic_proc_apply(pic_state *pic)
+pic_proc_apply(pic_state *pic, int argc, pic_value *argv)
 {
-  pic_value proc, *args, *arg_list;
-  int argc, n, i;
-
-  pic_get_args(pic, "l*", &proc, &argc, &args);
+  static const pic_code iseq[] = { OP_TAILCALL, PIC_CODE_WIDE, 0xff, 0xff, 0xff, 0xff }; /* -1 */
+  static const pic_code iseq_rest[] = { OP_TAILCALL, PIC_CODE_WIDE, 0xfe, 0xff, 0xff, 0xff }; /* -2 */
+  pic_value proc = argv[0], list = argv[argc - 1];
+  struct proc *p = pic_proc_ptr(pic, proc);
+  struct callinfo *ci;
+  int i, n, reqc = 0;
+  bool rest;
 
-  if (argc == 0) {
-    pic_error(pic, "apply: wrong number of arguments", 0);
+  rest = p->tt == PIC_TYPE_IREP && p->u.i.irep->varg && pic_list_p(pic, list);
+  if (rest) {
+    reqc = p->u.i.irep->argc - 1;
   }
 
-  n = argc - 1 + pic_length(pic, args[argc - 1]);
-
-  arg_list = pic_alloca(pic, sizeof(pic_value) * n);
-  for (i = 0; i < argc - 1; ++i) {
-    arg_list[i] = args[i];
+  n = 0;
+  pic_vm_reserve(pic, argc, 1);
+  *pic->sp++ = proc;
+  for (i = 1; i < argc - 1; ++i) {
+    pic->sp[n++] = argv[i];
+  }
+  while (pic_pair_p(pic, list) && (! rest || n < reqc)) {
+    if (pic->stend - pic->sp <= n + 1) {
+      pic->sp += n;             /* keep them while the stack grows */
+      pic_vm_reserve(pic, n + 1, 1);
+      pic->sp -= n;
+    }
+    pic->sp[n++] = pic_pair_ptr(pic, list)->car;
+    list = pic_pair_ptr(pic, list)->cdr;
   }
-  while (i < n) {
-    arg_list[i] = pic_list_ref(pic, args[argc - 1], i - argc + 1);
-    i++;
+  if (rest) {
+    pic->sp[n++] = list;
+  } else if (! pic_nil_p(pic, list)) {
+    pic_error(pic, "apply: list required", 1, argv[argc - 1]);
   }
-  return pic_applyk(pic, proc, n, arg_list);
+
+  ci = PUSHCI();
+  ci->ip = rest ? iseq_rest : iseq;
+  ci->fp = pic->sp;
+  ci->retc = n;
+  ci->irep = NULL;
+  ci->cxt = NULL;
+
+  return n == 0 ? pic_undef_value(pic) : pic->sp[0];
 }
 
 void
 pic_init_proc(pic_state *pic)
 {
-  pic_defun(pic, "procedure?", pic_proc_proc_p);
-  pic_defun(pic, "apply", pic_proc_apply);
+  pic_defun_sig(pic, "procedure?", "o", pic_proc_proc_p);
+  pic_defun_sig(pic, "apply", "lo*", pic_proc_apply);
 }
@@ -531,8 +531,8 @@ read_label_set(pic_state *pic, pic_value port, int i, struct reader_control *p)
       kh_val(h, it) = val = pic_cons(pic, pic_undef_value(pic), pic_undef_value(pic));
 
       tmp = read_value(pic, port, c, p);
-      pic_pair_ptr(pic, val)->car = pic_car(pic, tmp);
-      pic_pair_ptr(pic, val)->cdr = pic_cdr(pic, tmp);
+      pic_set_car(pic, val, pic_car(pic, tmp));
+      pic_set_cdr(pic, val, pic_cdr(pic, tmp));
 
       return val;
     }
@@ -554,6 +554,7 @@ read_label_set(pic_state *pic, pic_value port, int i, struct reader_control *p)
         tmp = read_value(pic, port, c, p);
         PIC_SWAP(pic_value *, pic_vec_ptr(pic, tmp)->data, pic_vec_ptr(pic, val)->data);
         PIC_SWAP(int, pic_vec_ptr(pic, tmp)->len, pic_vec_ptr(pic, val)->len);
+        pic_gc_remember(pic, pic_obj_ptr(val));
 
         return val;
       }
@@ -182,20 +182,26 @@ pic_open(pic_allocf allocf, void *userdata)
   /* continuation chain */
   pic->cc = NULL;
 
+  /* exception handlers and delimiting prompts */
+  pic->handlers = pic_nil_value(pic);
+  pic->prompts = pic_nil_value(pic);
+
   /* root block */
   pic->cp = NULL;
 
   /* prepare VM stack */
   pic->stbase = pic->sp = allocf(userdata, NULL, PIC_STACK_SIZE * sizeof(pic_value));
   pic->stend = pic->stbase + PIC_STACK_SIZE;
+  pic->stretired = NULL;
+  pic->stoverflow = false;
 
   if (! pic->sp) {
     goto EXIT_SP;
   }
 
   /* callinfo */
-  pic->cibase = pic->ci = allocf(userdata, NULL, PIC_STACK_SIZE * sizeof(struct callinfo));
-  pic->ciend = pic->cibase + PIC_STACK_SIZE;
+  pic->cibase = pic->ci = allocf(userdata, NULL, PIC_CALLINFO_SIZE * sizeof(struct callinfo));
+  pic->ciend = pic->cibase + PIC_CALLINFO_SIZE;
 
   if (! pic->ci) {
     goto EXIT_CI;
@@ -210,6 +216,10 @@ pic_open(pic_allocf allocf, void *userdata)
     goto EXIT_ARENA;
   }
 
+  /* sampling hook */
+  pic->samplef = NULL;
+  pic->sample_period = pic->sample_count = 0;
+
   /* memory heap */
   pic->heap = pic_heap_open(pic);
 
@@ -219,6 +229,12 @@ pic_open(pic_allocf allocf, void *userdata)
   /* unique symbol count */
   pic->ucnt = 0;
 
+  /* optimizer passes */
+  pic->opt_passes = PIC_OPT_ALL;
+
+  /* backtraces of errors */
+  pic->backtrace_depth = PIC_BACKTRACE_DEPTH;
+
   /* global variables */
   pic->globals = pic_invalid_value(pic);
 
@@ -240,6 +256,9 @@ pic_open(pic_allocf allocf, void *userdata)
   pic->panicf = NULL;
   pic->err = pic_invalid_value(pic);
 
+  /* bytecode image */
+  pic->image = pic_undef_value(pic);
+
   /* root tables */
   pic->globals = pic_make_weak(pic);
   pic->macros = pic_make_weak(pic);
@@ -284,6 +303,9 @@ pic_close(pic_state *pic)
   pic->ci = pic->cibase;
   pic->arena_idx = 0;
   pic->err = pic_invalid_value(pic);
+  pic->handlers = pic_nil_value(pic);
+  pic->prompts = pic_nil_value(pic);
+  pic->image = pic_undef_value(pic);
   pic->globals = pic_invalid_value(pic);
   pic->macros = pic_invalid_value(pic);
   pic->features = pic_nil_value(pic);
@@ -298,6 +320,7 @@ pic_close(pic_state *pic)
   pic_heap_close(pic, pic->heap);
 
   /* free runtime context */
+  pic_vm_release(pic);
   allocf(pic->userdata, pic->stbase, 0);
   allocf(pic->userdata, pic->cibase, 0);
 
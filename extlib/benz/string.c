@@ -9,6 +9,9 @@
 struct rope {
   int refcnt;
   int weight;
+  int depth;                    /* 0 for leaves */
+  int hash;
+  bool hashed;
   bool isleaf;
   union {
     struct {
@@ -51,6 +54,8 @@ make_rope_leaf(pic_state *pic, const char *str, int len)
   rope = pic_malloc(pic, offsetof(struct rope, buf) + len + 1);
   rope->refcnt = 1;
   rope->weight = len;
+  rope->depth = 0;
+  rope->hashed = false;
   rope->isleaf = true;
   rope->u.leaf.owner = NULL;
   rope->u.leaf.str = rope->buf;
@@ -70,6 +75,8 @@ make_rope_lit(pic_state *pic, const char *str, int len)
   rope = pic_malloc(pic, offsetof(struct rope, buf));
   rope->refcnt = 1;
   rope->weight = len;
+  rope->depth = 0;
+  rope->hashed = false;
   rope->isleaf = true;
   rope->u.leaf.owner = NULL;
   rope->u.leaf.str = str;
@@ -91,6 +98,8 @@ make_rope_slice(pic_state *pic, struct rope *owner, int i, int j)
   rope = pic_malloc(pic, offsetof(struct rope, buf));
   rope->refcnt = 1;
   rope->weight = j - i;
+  rope->depth = 0;
+  rope->hashed = false;
   rope->isleaf = true;
   rope->u.leaf.owner = owner;
   rope->u.leaf.str = owner->u.leaf.str + i;
@@ -108,6 +117,8 @@ make_rope_node(pic_state *pic, struct rope *left, struct rope *right)
   rope = pic_malloc(pic, sizeof(struct rope));
   rope->refcnt = 1;
   rope->weight = left->weight + right->weight;
+  rope->depth = (left->depth > right->depth ? left->depth : right->depth) + 1;
+  rope->hashed = false;
   rope->isleaf = false;
   rope->u.node.left = pic_rope_incref(left);
   rope->u.node.right = pic_rope_incref(right);
@@ -126,15 +137,112 @@ make_str(pic_state *pic, struct rope *rope)
   return pic_obj_value(str);
 }
 
+static void
+copy(struct rope *rope, char *buf)
+{
+  while (! rope->isleaf) {
+    copy(rope->u.node.left, buf);
+    buf += rope->u.node.left->weight;
+    rope = rope->u.node.right;
+  }
+  memcpy(buf, rope->u.leaf.str, rope->weight);
+}
+
+/* leaves shorter than this are copied together rather than linked */
+#define ROPE_SHORT_LEAF 64
+
+static struct rope *
+merge_leaves(pic_state *pic, struct rope *left, struct rope *right)
+{
+  struct rope *rope;
+
+  rope = make_rope_leaf(pic, 0, left->weight + right->weight);
+  copy(left, rope->buf);
+  copy(right, rope->buf + left->weight);
+  return rope;
+}
+
+static struct rope *
+rotate(pic_state *pic, struct rope *a, struct rope *b, struct rope *c)
+{
+  struct rope *l, *rope;
+
+  l = make_rope_node(pic, a, b);
+  rope = make_rope_node(pic, l, c);
+  pic_rope_decref(pic, l);
+  return rope;
+}
+
+/* node(left, right) rebalanced so that sibling depths differ by at most one */
+static struct rope *
+join(pic_state *pic, struct rope *left, struct rope *right)
+{
+  struct rope *t, *x, *rope;
+
+  if (left->isleaf && right->isleaf && left->weight + right->weight <= ROPE_SHORT_LEAF) {
+    return merge_leaves(pic, left, right);
+  }
+
+  if (left->depth > right->depth + 1 && ! left->isleaf) {
+    t = join(pic, left->u.node.right, right);
+    if (t->depth <= left->u.node.left->depth + 1) {
+      rope = make_rope_node(pic, left->u.node.left, t);
+    } else if (t->u.node.left->depth <= t->u.node.right->depth) {
+      rope = rotate(pic, left->u.node.left, t->u.node.left, t->u.node.right);
+    } else {
+      x = make_rope_node(pic, t->u.node.left->u.node.right, t->u.node.right);
+      rope = rotate(pic, left->u.node.left, t->u.node.left->u.node.left, x);
+      pic_rope_decref(pic, x);
+    }
+    pic_rope_decref(pic, t);
+    return rope;
+  }
+
+  if (right->depth > left->depth + 1 && ! right->isleaf) {
+    t = join(pic, left, right->u.node.left);
+    if (t->depth <= right->u.node.right->depth + 1) {
+      rope = make_rope_node(pic, t, right->u.node.right);
+    } else if (t->u.node.right->depth <= t->u.node.left->depth) {
+      x = make_rope_node(pic, t->u.node.right, right->u.node.right);
+      rope = make_rope_node(pic, t->u.node.left, x);
+      pic_rope_decref(pic, x);
+    } else {
+      x = make_rope_node(pic, t->u.node.right->u.node.right, right->u.node.right);
+      rope = rotate(pic, t->u.node.left, t->u.node.right->u.node.left, x);
+      pic_rope_decref(pic, x);
+    }
+    pic_rope_decref(pic, t);
+    return rope;
+  }
+
+  /* appending a short leaf next to a short leaf extends it instead */
+  if (! left->isleaf && right->isleaf && left->u.node.right->isleaf
+      && left->u.node.right->weight + right->weight <= ROPE_SHORT_LEAF) {
+    t = merge_leaves(pic, left->u.node.right, right);
+    rope = make_rope_node(pic, left->u.node.left, t);
+    pic_rope_decref(pic, t);
+    return rope;
+  }
+  if (! right->isleaf && left->isleaf && right->u.node.left->isleaf
+      && left->weight + right->u.node.left->weight <= ROPE_SHORT_LEAF) {
+    t = merge_leaves(pic, left, right->u.node.left);
+    rope = make_rope_node(pic, t, right->u.node.right);
+    pic_rope_decref(pic, t);
+    return rope;
+  }
+
+  return make_rope_node(pic, left, right);
+}
+
 static struct rope *
 merge(pic_state *pic, struct rope *left, struct rope *right)
 {
-  if (left == 0)
+  if (left == 0 || left->weight == 0)
     return pic_rope_incref(right);
-  if (right == 0)
+  if (right == 0 || right->weight == 0)
     return pic_rope_incref(left);
 
-  return make_rope_node(pic, left, right);
+  return join(pic, left, right);
 }
 
 static struct rope *
@@ -186,18 +294,31 @@ flatten(pic_state *pic, struct rope *rope, struct rope *owner, char *buf)
     pic_rope_incref(owner);
     pic_rope_decref(pic, rope->u.node.left);
     pic_rope_decref(pic, rope->u.node.right);
+    rope->depth = 0;
     rope->isleaf = true;
     rope->u.leaf.owner = owner;
     rope->u.leaf.str = buf;
   }
 }
 
-static void
-str_update(pic_state *pic, pic_value dst, pic_value src)
+/* a flat buffer owned by str alone, which may be written in place */
+static char *
+str_mutable_buf(pic_state *pic, pic_value str)
 {
-  pic_rope_incref(pic_str_ptr(pic, src)->rope);
-  pic_rope_decref(pic, pic_str_ptr(pic, dst)->rope);
-  pic_str_ptr(pic, dst)->rope = pic_str_ptr(pic, src)->rope;
+  struct string *s = pic_str_ptr(pic, str);
+  struct rope *rope = s->rope, *r;
+
+  if (rope->isleaf && rope->refcnt == 1 && rope->u.leaf.owner == NULL && rope->u.leaf.str == rope->buf) {
+    rope->hashed = false;
+    return rope->buf;
+  }
+
+  r = make_rope_leaf(pic, 0, rope->weight);
+  copy(rope, r->buf);
+  pic_rope_decref(pic, rope);
+  s->rope = r;
+
+  return r->buf;
 }
 
 pic_value
@@ -232,19 +353,83 @@ pic_strf_value(pic_state *pic, const char *fmt, ...)
 pic_value
 pic_vstrf_value(pic_state *pic, const char *fmt, va_list ap)
 {
-  pic_value str, port;
-  const char *buf;
-  int len;
-
-  port = pic_fmemopen(pic, NULL, 0, "w");
+  struct strbuf sb = PIC_STRBUF_INIT;
+  pic_value str;
 
-  pic_vfprintf(pic, port, fmt, ap);
-  pic_fgetbuf(pic, port, &buf, &len);
-  str = pic_str_value(pic, buf, len);
-  pic_fclose(pic, port);
+  pic_strbuf_vprintf(pic, &sb, fmt, ap);
+  str = pic_strbuf_value(pic, &sb);
+  pic_strbuf_destroy(pic, &sb);
   return str;
 }
 
+/* string builder: appends into a growable leaf that strings share */
+
+void
+pic_strbuf_write(pic_state *pic, struct strbuf *sb, const char *buf, int len)
+{
+  struct rope *rope = sb->rope;
+
+  if (rope != NULL && rope->refcnt > 1) {
+    /* the text was handed out to a string; keep writing into a copy */
+    sb->capa = sb->len + len > sb->capa ? (sb->len + len) * 2 : sb->capa;
+    rope = make_rope_leaf(pic, NULL, sb->capa);
+    memcpy(rope->buf, sb->rope->buf, sb->len);
+    pic_rope_decref(pic, sb->rope);
+    sb->rope = rope;
+  } else if (sb->len + len > sb->capa) {
+    sb->capa = (sb->len + len) * 2 < 32 ? 32 : (sb->len + len) * 2;
+    rope = pic_realloc(pic, rope, offsetof(struct rope, buf) + sb->capa + 1);
+    rope->refcnt = 1;
+    rope->depth = 0;
+    rope->hashed = false;
+    rope->isleaf = true;
+    rope->u.leaf.owner = NULL;
+    rope->u.leaf.str = rope->buf;
+    sb->rope = rope;
+  }
+  memcpy(rope->buf + sb->len, buf, len);
+  sb->len += len;
+}
+
+void
+pic_strbuf_putc(pic_state *pic, struct strbuf *sb, int c)
+{
+  char ch = c;
+
+  if (sb->len < sb->capa && sb->rope->refcnt == 1) {
+    sb->rope->buf[sb->len++] = ch;
+  } else {
+    pic_strbuf_write(pic, sb, &ch, 1);
+  }
+}
+
+/* the text so far; the buffer is shared with the string, not copied */
+pic_value
+pic_strbuf_value(pic_state *pic, struct strbuf *sb)
+{
+  struct rope *rope = sb->rope;
+
+  if (rope == NULL) {
+    return pic_lit_value(pic, "");
+  }
+  if (rope->refcnt == 1) {
+    rope->weight = sb->len;
+    rope->hashed = false;
+    rope->buf[sb->len] = '\0';
+  }
+  return make_str(pic, pic_rope_incref(rope));
+}
+
+void
+pic_strbuf_destroy(pic_state *pic, struct strbuf *sb)
+{
+  if (sb->rope) {
+    pic_rope_decref(pic, sb->rope);
+  }
+  sb->rope = NULL;
+  sb->len = sb->capa = 0;
+}
+
 int
 pic_str_len(pic_state *PIC_UNUSED(pic), pic_value str)
 {
@@ -282,25 +467,104 @@ pic_str_sub(pic_state *pic, pic_value str, int s, int e)
   return make_str(pic, slice(pic, pic_str_ptr(pic, str)->rope, s, e));
 }
 
-int
-pic_str_cmp(pic_state *pic, pic_value str1, pic_value str2)
+/* the leaf text starting at index i */
+static const char *
+chunk(struct rope *rope, int i, int *len)
 {
-  return strcmp(pic_str(pic, str1), pic_str(pic, str2));
+  while (! rope->isleaf) {
+    if (i < rope->u.node.left->weight) {
+      rope = rope->u.node.left;
+    } else {
+      i -= rope->u.node.left->weight;
+      rope = rope->u.node.right;
+    }
+  }
+  *len = rope->weight - i;
+  return rope->u.leaf.str + i;
+}
+
+static int
+compare(struct rope *rope, struct rope *other, const char *buf, int len)
+{
+  const char *p, *q;
+  int i = 0, n, m, end, r;
+
+  end = rope->weight < len ? rope->weight : len;
+
+  while (i < end) {
+    p = chunk(rope, i, &n);
+    if (other) {
+      q = chunk(other, i, &m);
+      n = n < m ? n : m;
+    } else {
+      q = buf + i;
+    }
+    n = n < end - i ? n : end - i;
+    if ((r = memcmp(p, q, n)) != 0) {
+      return r;
+    }
+    i += n;
+  }
+  return rope->weight - len;
 }
 
 int
-pic_str_hash(pic_state *pic, pic_value str)
+pic_str_cmp(pic_state *PIC_UNUSED(pic), pic_value str1, pic_value str2)
 {
-  const char *s;
-  int h = 0;
+  struct rope *x = pic_str_ptr(pic, str1)->rope, *y = pic_str_ptr(pic, str2)->rope;
 
-  s = pic_str(pic, str);
-  while (*s) {
-    h = (h << 5) - h + *s++;
+  if (x == y) {
+    return 0;
+  }
+  return compare(x, y, NULL, y->weight);
+}
+
+bool
+pic_str_eq_buf(pic_state *PIC_UNUSED(pic), pic_value str, const char *buf, int len)
+{
+  struct rope *rope = pic_str_ptr(pic, str)->rope;
+
+  return rope->weight == len && compare(rope, NULL, buf, len) == 0;
+}
+
+static unsigned
+hash_buf(unsigned h, const char *buf, int len)
+{
+  while (len-- > 0) {
+    h = (h << 5) - h + *buf++;
   }
   return h;
 }
 
+static unsigned
+hash_rope(unsigned h, struct rope *rope)
+{
+  while (! rope->isleaf) {
+    h = hash_rope(h, rope->u.node.left);
+    rope = rope->u.node.right;
+  }
+  return hash_buf(h, rope->u.leaf.str, rope->weight);
+}
+
+/* pic_str_hash of a string holding these bytes: both fold hash_buf over them */
+int
+pic_str_hash_buf(const char *buf, int len)
+{
+  return (int)hash_buf(0, buf, len);
+}
+
+int
+pic_str_hash(pic_state *PIC_UNUSED(pic), pic_value str)
+{
+  struct rope *rope = pic_str_ptr(pic, str)->rope;
+
+  if (! rope->hashed) {
+    rope->hash = (int)hash_rope(0, rope);
+    rope->hashed = true;
+  }
+  return rope->hash;
+}
+
 const char *
 pic_str(pic_state *pic, pic_value str)
 {
@@ -318,28 +582,20 @@ pic_str(pic_state *pic, pic_value str)
 }
 
 static pic_value
-pic_str_string_p(pic_state *pic)
+pic_str_string_p(pic_state *pic, int PIC_UNUSED(argc), pic_value *argv)
 {
-  pic_value v;
-
-  pic_get_args(pic, "o", &v);
-
-  return pic_bool_value(pic, pic_str_p(pic, v));
+  return pic_bool_value(pic, pic_str_p(pic, argv[0]));
 }
 
 static pic_value
-pic_str_string(pic_state *pic)
+pic_str_string(pic_state *pic, int argc, pic_value *argv)
 {
-  int argc, i;
-  pic_value *argv;
+  int i;
   char *buf;
 
-  pic_get_args(pic, "*", &argc, &argv);
-
   buf = pic_alloca(pic, argc);
 
   for (i = 0; i < argc; ++i) {
-    TYPE_CHECK(pic, argv[i], char);
     buf[i] = pic_char(pic, argv[i]);
   }
 
@@ -347,13 +603,13 @@ pic_str_string(pic_state *pic)
 }
 
 static pic_value
-pic_str_make_string(pic_state *pic)
+pic_str_make_string(pic_state *pic, int argc, pic_value *argv)
 {
   int len;
-  char c = ' ';
-  char *buf;
+  char c, *buf;
 
-  pic_get_args(pic, "i|c", &len, &c);
+  len = pic_int(pic, argv[0]);
+  c = argc > 1 ? pic_char(pic, argv[1]) : ' ';
 
   if (len < 0) {
     pic_error(pic, "make-string: negative length given", 1, pic_int_value(pic, len));
@@ -367,58 +623,43 @@ pic_str_make_string(pic_state *pic)
 }
 
 static pic_value
-pic_str_string_length(pic_state *pic)
+pic_str_string_length(pic_state *pic, int PIC_UNUSED(argc), pic_value *argv)
 {
-  pic_value str;
-
-  pic_get_args(pic, "s", &str);
-
-  return pic_int_value(pic, pic_str_len(pic, str));
+  return pic_int_value(pic, pic_str_len(pic, argv[0]));
 }
 
 static pic_value
-pic_str_string_ref(pic_state *pic)
+pic_str_string_ref(pic_state *pic, int PIC_UNUSED(argc), pic_value *argv)
 {
-  pic_value str;
-  int k;
+  int k = pic_int(pic, argv[1]);
 
-  pic_get_args(pic, "si", &str, &k);
+  VALID_INDEX(pic, pic_str_len(pic, argv[0]), k);
 
-  VALID_INDEX(pic, pic_str_len(pic, str), k);
-
-  return pic_char_value(pic, pic_str_ref(pic, str, k));
+  return pic_char_value(pic, pic_str_ref(pic, argv[0], k));
 }
 
 static pic_value
-pic_str_string_set(pic_state *pic)
+pic_str_string_set(pic_state *pic, int PIC_UNUSED(argc), pic_value *argv)
 {
-  pic_value str, x, y, z;
+  pic_value str = argv[0];
   char c;
-  int k, len;
-
-  pic_get_args(pic, "sic", &str, &k, &c);
-
-  len = pic_str_len(pic, str);
+  int k;
 
-  VALID_INDEX(pic, len, k);
+  k = pic_int(pic, argv[1]);
+  c = pic_char(pic, argv[2]);
 
-  x = pic_str_sub(pic, str, 0, k);
-  y = pic_str_value(pic, &c, 1);
-  z = pic_str_sub(pic, str, k + 1, len);
+  VALID_INDEX(pic, pic_str_len(pic, str), k);
 
-  str_update(pic, str, pic_str_cat(pic, x, pic_str_cat(pic, y, z)));
+  str_mutable_buf(pic, str)[k] = c;
 
   return pic_undef_value(pic);
 }
 
 #define DEFINE_STRING_CMP(name, op)                             \
   static pic_value                                              \
-  pic_str_string_##name(pic_state *pic)                         \
+  pic_str_string_##name(pic_state *pic, int argc, pic_value *argv) \
   {                                                             \
-    int argc, i;                                                \
-    pic_value *argv;                                            \
-                                                                \
-    pic_get_args(pic, "*", &argc, &argv);                       \
+    int i;                                                      \
                                                                 \
     if (argc < 1 || ! pic_str_p(pic, argv[0])) {                \
       return pic_false_value(pic);                              \
@@ -442,122 +683,84 @@ DEFINE_STRING_CMP(le, <=)
 DEFINE_STRING_CMP(ge, >=)
 
 static pic_value
-pic_str_string_copy(pic_state *pic)
+pic_str_string_copy(pic_state *pic, int argc, pic_value *argv)
 {
-  pic_value str;
-  int n, start, end, len;
-
-  n = pic_get_args(pic, "s|ii", &str, &start, &end);
-
-  len = pic_str_len(pic, str);
+  int start, end, len;
 
-  switch (n) {
-  case 1:
-    start = 0;
-  case 2:
-    end = len;
-  }
+  len = pic_str_len(pic, argv[0]);
+  start = argc > 1 ? pic_int(pic, argv[1]) : 0;
+  end = argc > 2 ? pic_int(pic, argv[2]) : len;
 
   VALID_RANGE(pic, len, start, end);
 
-  return pic_str_sub(pic, str, start, end);
+  return pic_str_sub(pic, argv[0], start, end);
 }
 
 static pic_value
-pic_str_string_copy_ip(pic_state *pic)
+pic_str_string_copy_ip(pic_state *pic, int argc, pic_value *argv)
 {
-  pic_value to, from, x, y, z;
-  int n, at, start, end, tolen, fromlen;
-
-  n = pic_get_args(pic, "sis|ii", &to, &at, &from, &start, &end);
+  pic_value to = argv[0], from = argv[2];
+  int at, start, end, tolen, fromlen;
+  char *buf;
 
   tolen = pic_str_len(pic, to);
   fromlen = pic_str_len(pic, from);
-
-  switch (n) {
-  case 3:
-    start = 0;
-  case 4:
-    end = fromlen;
-  }
+  at = pic_int(pic, argv[1]);
+  start = argc > 3 ? pic_int(pic, argv[3]) : 0;
+  end = argc > 4 ? pic_int(pic, argv[4]) : fromlen;
 
   VALID_ATRANGE(pic, tolen, at, fromlen, start, end);
 
-  x = pic_str_sub(pic, to, 0, at);
-  y = pic_str_sub(pic, from, start, end);
-  z = pic_str_sub(pic, to, at + end - start, tolen);
-
-  str_update(pic, to, pic_str_cat(pic, x, pic_str_cat(pic, y, z)));
+  buf = str_mutable_buf(pic, to);
+  memmove(buf + at, pic_str(pic, from) + start, end - start);
 
   return pic_undef_value(pic);
 }
 
 static pic_value
-pic_str_string_fill_ip(pic_state *pic)
+pic_str_string_fill_ip(pic_state *pic, int argc, pic_value *argv)
 {
-  pic_value str, x, y, z;
-  char c, *buf;
-  int n, start, end, len;
-
-  n = pic_get_args(pic, "sc|ii", &str, &c, &start, &end);
+  pic_value str = argv[0];
+  char c;
+  int start, end, len;
 
+  c = pic_char(pic, argv[1]);
   len = pic_str_len(pic, str);
-
-  switch (n) {
-  case 2:
-    start = 0;
-  case 3:
-    end = len;
-  }
+  start = argc > 2 ? pic_int(pic, argv[2]) : 0;
+  end = argc > 3 ? pic_int(pic, argv[3]) : len;
 
   VALID_RANGE(pic, len, start, end);
 
-  buf = pic_alloca(pic, end - start);
-  memset(buf, c, end - start);
-
-  x = pic_str_sub(pic, str, 0, start);
-  y = pic_str_value(pic, buf, end - start);
-  z = pic_str_sub(pic, str, end, len);
-
-  str_update(pic, str, pic_str_cat(pic, x, pic_str_cat(pic, y, z)));
+  memset(str_mutable_buf(pic, str) + start, c, end - start);
 
   return pic_undef_value(pic);
 }
 
 static pic_value
-pic_str_string_append(pic_state *pic)
+pic_str_string_append(pic_state *pic, int argc, pic_value *argv)
 {
-  int argc, i;
-  pic_value *argv;
+  int i;
   pic_value str = pic_lit_value(pic, "");
 
-  pic_get_args(pic, "*", &argc, &argv);
-
   for (i = 0; i < argc; ++i) {
-    TYPE_CHECK(pic, argv[i], str);
     str = pic_str_cat(pic, str, argv[i]);
   }
   return str;
 }
 
 static pic_value
-pic_str_string_map(pic_state *pic)
+pic_str_string_map(pic_state *pic, int argc, pic_value *argv)
 {
-  pic_value proc, *argv, vals, val;
-  int argc, i, len, j;
+  pic_value proc = argv[0], vals, val;
+  int i, len, j;
   char *buf;
 
-  pic_get_args(pic, "l*", &proc, &argc, &argv);
-
-  if (argc == 0) {
-    pic_error(pic, "string-map: one or more strings expected, but got zero", 0);
-  }
+  argc--;
+  argv++;
 
   len = INT_MAX;
   for (i = 0; i < argc; ++i) {
-    int l;
-    TYPE_CHECK(pic, argv[i], str);
-    l = pic_str_len(pic, argv[i]);
+    int l = pic_str_len(pic, argv[i]);
     len = len < l ? len : l;
   }
 
@@ -579,22 +782,17 @@ pic_str_string_map(pic_state *pic)
 }
 
 static pic_value
-pic_str_string_for_each(pic_state *pic)
+pic_str_string_for_each(pic_state *pic, int argc, pic_value *argv)
 {
-  pic_value proc, *argv, vals;
-  int argc, i, len, j;
+  pic_value proc = argv[0], vals;
+  int i, len, j;
 
-  pic_get_args(pic, "l*", &proc, &argc, &argv);
-
-  if (argc == 0) {
-    pic_error(pic, "string-map: one or more strings expected, but got zero", 0);
-  }
+  argc--;
+  argv++;
 
   len = INT_MAX;
   for (i = 0; i < argc; ++i) {
-    int l;
-    TYPE_CHECK(pic, argv[i], str);
-    l = pic_str_len(pic, argv[i]);
+    int l = pic_str_len(pic, argv[i]);
     len = len < l ? len : l;
   }
 
@@ -610,18 +808,16 @@ pic_str_string_for_each(pic_state *pic)
 }
 
 static pic_value
-pic_str_list_to_string(pic_state *pic)
+pic_str_list_to_string(pic_state *pic, int PIC_UNUSED(argc), pic_value *argv)
 {
-  pic_value list, e, it;
+  pic_value e, it;
   int i;
   char *buf;
 
-  pic_get_args(pic, "o", &list);
-
-  buf = pic_alloca(pic, pic_length(pic, list));
+  buf = pic_alloca(pic, pic_length(pic, argv[0]));
 
   i = 0;
-  pic_for_each (e, list, it) {
+  pic_for_each (e, argv[0], it) {
     TYPE_CHECK(pic, e, char);
 
     buf[i++] = pic_char(pic, e);
@@ -631,27 +827,20 @@ pic_str_list_to_string(pic_state *pic)
 }
 
 static pic_value
-pic_str_string_to_list(pic_state *pic)
+pic_str_string_to_list(pic_state *pic, int argc, pic_value *argv)
 {
-  pic_value str, list;
-  int n, start, end, len, i;
-
-  n = pic_get_args(pic, "s|ii", &str, &start, &end);
+  pic_value list;
+  int start, end, len, i;
 
-  len = pic_str_len(pic, str);
-
-  switch (n) {
-  case 1:
-    start = 0;
-  case 2:
-    end = len;
-  }
+  len = pic_str_len(pic, argv[0]);
+  start = argc > 1 ? pic_int(pic, argv[1]) : 0;
+  end = argc > 2 ? pic_int(pic, argv[2]) : len;
 
   VALID_RANGE(pic, len, start, end);
 
   list = pic_nil_value(pic);
   for (i = start; i < end; ++i) {
-    pic_push(pic, pic_char_value(pic, pic_str_ref(pic, str, i)), list);
+    pic_push(pic, pic_char_value(pic, pic_str_ref(pic, argv[0], i)), list);
   }
   return pic_reverse(pic, list);
 }
@@ -659,24 +848,24 @@ pic_str_string_to_list(pic_state *pic)
 void
 pic_init_str(pic_state *pic)
 {
-  pic_defun(pic, "string?", pic_str_string_p);
-  pic_defun(pic, "string", pic_str_string);
-  pic_defun(pic, "make-string", pic_str_make_string);
-  pic_defun(pic, "string-length", pic_str_string_length);
-  pic_defun(pic, "string-ref", pic_str_string_ref);
-  pic_defun(pic, "string-set!", pic_str_string_set);
-  pic_defun(pic, "string-copy", pic_str_string_copy);
-  pic_defun(pic, "string-copy!", pic_str_string_copy_ip);
-  pic_defun(pic, "string-fill!", pic_str_string_fill_ip);
-  pic_defun(pic, "string-append", pic_str_string_append);
-  pic_defun(pic, "string-map", pic_str_string_map);
-  pic_defun(pic, "string-for-each", pic_str_string_for_each);
-  pic_defun(pic, "list->string", pic_str_list_to_string);
-  pic_defun(pic, "string->list", pic_str_string_to_list);
-
-  pic_defun(pic, "string=?", pic_str_string_eq);
-  pic_defun(pic, "string<?", pic_str_string_lt);
-  pic_defun(pic, "string>?", pic_str_string_gt);
-  pic_defun(pic, "string<=?", pic_str_string_le);
-  pic_defun(pic, "string>=?", pic_str_string_ge);
+  pic_defun_sig(pic, "string?", "o", pic_str_string_p);
+  pic_defun_sig(pic, "string", "*c", pic_str_string);
+  pic_defun_sig(pic, "make-string", "i|c", pic_str_make_string);
+  pic_defun_sig(pic, "string-length", "s", pic_str_string_length);
+  pic_defun_sig(pic, "string-ref", "si", pic_str_string_ref);
+  pic_defun_sig(pic, "string-set!", "sic", pic_str_string_set);
+  pic_defun_sig(pic, "string-copy", "s|ii", pic_str_string_copy);
+  pic_defun_sig(pic, "string-copy!", "sis|ii", pic_str_string_copy_ip);
+  pic_defun_sig(pic, "string-fill!", "sc|ii", pic_str_string_fill_ip);
+  pic_defun_sig(pic, "string-append", "*s", pic_str_string_append);
+  pic_defun_sig(pic, "string-map", "ls*s", pic_str_string_map);
+  pic_defun_sig(pic, "string-for-each", "ls*s", pic_str_string_for_each);
+  pic_defun_sig(pic, "list->string", "o", pic_str_list_to_string);
+  pic_defun_sig(pic, "string->list", "s|ii", pic_str_string_to_list);
+
+  pic_defun_sig(pic, "string=?", "*", pic_str_string_eq);
+  pic_defun_sig(pic, "string<?", "*", pic_str_string_lt);
+  pic_defun_sig(pic, "string>?", "*", pic_str_string_gt);
+  pic_defun_sig(pic, "string<=?", "*", pic_str_string_le);
+  pic_defun_sig(pic, "string>=?", "*", pic_str_string_ge);
 }
@@ -12,6 +12,16 @@
 
 KHASH_DEFINE(oblist, struct string *, symbol *, kh_pic_str_hash, kh_pic_str_cmp)
 
+struct strkey {
+  const char *buf;
+  int len;
+};
+
+#define kh_strkey_hash(a) (pic_str_hash_buf((a).buf, (a).len))
+#define kh_strkey_cmp(a, b) (pic_str_eq_buf(pic, pic_obj_value(a), (b).buf, (b).len))
+
+KHASH_DEFINE_GET_BY(oblist, buf, struct strkey, kh_strkey_hash, kh_strkey_cmp)
+
 pic_value
 pic_intern(pic_state *pic, pic_value str)
 {
@@ -29,13 +39,53 @@ pic_intern(pic_state *pic, pic_value str)
 
   kh_val(h, it) = NULL;         /* dummy */
 
-  sym = (symbol *)pic_obj_alloc(pic, offsetof(symbol, env), PIC_TYPE_SYMBOL);
-  sym->u.str = pic_str_ptr(pic, str);
+  sym = (symbol *)pic_obj_alloc(pic, sizeof(symbol), PIC_TYPE_SYMBOL);
+  sym->str = pic_str_ptr(pic, str);
+  sym->base = NULL;
+  sym->num = 0;
   kh_val(h, it) = sym;
 
   return pic_obj_value(sym);
 }
 
+/* looks the name up by its bytes, so that no string is made for known symbols */
+pic_value
+pic_intern_str(pic_state *pic, const char *str, int len)
+{
+  khash_t(oblist) *h = &pic->oblist;
+  struct strkey key;
+  symbol *sym;
+  int it;
+
+  key.buf = str;
+  key.len = len < 0 ? -len : len;
+  it = kh_get_by(oblist, buf, h, key);
+  if (it != kh_end(h) && (sym = kh_val(h, it)) != NULL) {
+    pic_protect(pic, pic_obj_value(sym));
+    return pic_obj_value(sym);
+  }
+  return pic_intern(pic, pic_str_value(pic, str, len));
+}
+
+/* a fresh uid named after name; its printed name is made on first use */
+pic_value
+pic_make_uid(pic_state *pic, pic_value name)
+{
+  symbol *sym;
+
+  if (pic_image_running(pic)) {
+    /* images refer to symbols by name */
+    return pic_intern(pic, pic_strf_value(pic, ".%s.%d", pic_str(pic, name), pic->ucnt++));
+  }
+
+  sym = (symbol *)pic_obj_alloc(pic, sizeof(symbol), PIC_TYPE_SYMBOL);
+  sym->str = NULL;
+  sym->base = pic_str_ptr(pic, name);
+  sym->num = pic->ucnt++;
+
+  return pic_obj_value(sym);
+}
+
 pic_value
 pic_make_identifier(pic_state *pic, pic_value base, pic_value env)
 {
@@ -49,9 +99,17 @@ pic_make_identifier(pic_state *pic, pic_value base, pic_value env)
 }
 
 pic_value
-pic_sym_name(pic_state *PIC_UNUSED(pic), pic_value sym)
+pic_sym_name(pic_state *pic, pic_value sym)
 {
-  return pic_obj_value(pic_sym_ptr(pic, sym)->u.str);
+  symbol *s = pic_sym_ptr(pic, sym);
+  pic_value str;
+
+  if (s->str == NULL) {
+    str = pic_strf_value(pic, ".%s.%d", pic_str(pic, pic_obj_value(s->base)), s->num);
+    s->str = pic_str_ptr(pic, str);
+    pic_gc_write_barrier(pic, pic_obj_ptr(sym), str);
+  }
+  return pic_obj_value(s->str);
 }
 
 pic_value
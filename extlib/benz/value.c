@@ -4,91 +4,52 @@
 
 #include "picrin.h"
 #include "picrin/private/object.h"
-
-#if PIC_NAN_BOXING
-
-/**
- * value representation by nan-boxing:
- *   float : FFFFFFFFFFFFFFFF FFFFFFFFFFFFFFFF FFFFFFFFFFFFFFFF FFFFFFFFFFFFFFFF
- *   ptr   : 111111111111TTTT PPPPPPPPPPPPPPPP PPPPPPPPPPPPPPPP PPPPPPPPPPPPPPPP
- *   int   : 111111111111TTTT 0000000000000000 IIIIIIIIIIIIIIII IIIIIIIIIIIIIIII
- *   char  : 111111111111TTTT 0000000000000000 CCCCCCCCCCCCCCCC CCCCCCCCCCCCCCCC
- */
-
-#define pic_init_value(v,vtype) (v = (0xfff0000000000000ul | ((uint64_t)(vtype) << 48)))
-
-int
-pic_vtype(pic_state *PIC_UNUSED(pic), pic_value v)
-{
-  return 0xfff0 >= (v >> 48) ? PIC_TYPE_FLOAT : ((v >> 48) & 0xf);
-}
+#include "picrin/private/value.h"
 
 double
 pic_float(pic_state *PIC_UNUSED(pic), pic_value v)
 {
-  union { double f; uint64_t i; } u;
-  u.i = v;
-  return u.f;
+  return pic_unbox_float(v);
 }
 
 int
 pic_int(pic_state *PIC_UNUSED(pic), pic_value v)
 {
-  union { int i; unsigned u; } u;
-  u.u = v & 0xfffffffful;
-  return u.i;
+  return pic_unbox_int(v);
 }
 
 char
 pic_char(pic_state *PIC_UNUSED(pic), pic_value v)
 {
-  return v & 0xfffffffful;
+  return pic_unbox_char(v);
 }
 
-struct object *
-pic_obj_ptr(pic_value v)
-{
-  return (struct object *)(0xfffffffffffful & v);
-}
-
-#else
-
-#define pic_init_value(v,vtype) ((v).type = (vtype), (v).u.data = NULL)
-
-int
-pic_vtype(pic_state *PIC_UNUSED(pic), pic_value v)
+pic_value
+pic_float_value(pic_state *PIC_UNUSED(pic), double f)
 {
-  return (int)(v.type);
+  return pic_box_float(f);
 }
 
-double
-pic_float(pic_state *PIC_UNUSED(pic), pic_value v)
+pic_value
+pic_int_value(pic_state *PIC_UNUSED(pic), int i)
 {
-  return v.u.f;
+  return pic_box_int(i);
 }
 
-int
-pic_int(pic_state *PIC_UNUSED(pic), pic_value v)
+pic_value
+pic_char_value(pic_state *PIC_UNUSED(pic), char c)
 {
-  return v.u.i;
+  return pic_box_char(c);
 }
 
-char
-pic_char(pic_state *PIC_UNUSED(pic), pic_value v)
-{
-  return v.u.c;
-}
+#if PIC_NAN_BOXING
 
 struct object *
 pic_obj_ptr(pic_value v)
 {
-  return (struct object *)(v.u.data);
+  return (struct object *)(0xfffffffffffful & v);
 }
 
-#endif
-
-#if PIC_NAN_BOXING
-
 pic_value
 pic_obj_value(void *ptr)
 {
@@ -99,41 +60,14 @@ pic_obj_value(void *ptr)
   return v;
 }
 
-pic_value
-pic_float_value(pic_state *PIC_UNUSED(pic), double f)
-{
-  union { double f; uint64_t i; } u;
-
-  if (f != f) {
-    return 0x7ff8000000000000ul;
-  } else {
-    u.f = f;
-    return u.i;
-  }
-}
-
-pic_value
-pic_int_value(pic_state *PIC_UNUSED(pic), int i)
-{
-  pic_value v;
-
-  pic_init_value(v, PIC_TYPE_INT);
-  v |= (unsigned)i;
-  return v;
-}
+#else
 
-pic_value
-pic_char_value(pic_state *PIC_UNUSED(pic), char c)
+struct object *
+pic_obj_ptr(pic_value v)
 {
-  pic_value v;
-
-  pic_init_value(v, PIC_TYPE_CHAR);
-  v |= (unsigned char)c;
-  return v;
+  return (struct object *)(v.u.data);
 }
 
-#else
-
 pic_value
 pic_obj_value(void *ptr)
 {
@@ -144,36 +78,6 @@ pic_obj_value(void *ptr)
   return v;
 }
 
-pic_value
-pic_float_value(pic_state *PIC_UNUSED(pic), double f)
-{
-  pic_value v;
-
-  pic_init_value(v, PIC_TYPE_FLOAT);
-  v.u.f = f;
-  return v;
-}
-
-pic_value
-pic_int_value(pic_state *PIC_UNUSED(pic), int i)
-{
-  pic_value v;
-
-  pic_init_value(v, PIC_TYPE_INT);
-  v.u.i = i;
-  return v;
-}
-
-pic_value
-pic_char_value(pic_state *PIC_UNUSED(pic), char c)
-{
-  pic_value v;
-
-  pic_init_value(v, PIC_TYPE_CHAR);
-  v.u.c = c;
-  return v;
-}
-
 #endif
 
 #define DEFVAL(name, type)                      \
@@ -255,6 +159,8 @@ pic_typename(pic_state *pic, int type)
     return "record";
   case PIC_TYPE_CP:
     return "checkpoint";
+  case PIC_TYPE_CELL:
+    return "cell";
   default:
     pic_error(pic, "pic_typename: invalid type given", 1, pic_int_value(pic, type));
   }
@@ -51,6 +51,7 @@ dynamic_set(pic_state *pic)
   val = pic_closure_ref(pic, 1);
 
   pic_proc_ptr(pic, var)->locals[0] = val;
+  pic_gc_write_barrier(pic, pic_obj_ptr(var), val);
 
   return pic_undef_value(pic);
 }
@@ -32,9 +32,10 @@ pic_vec_ref(pic_state *PIC_UNUSED(pic), pic_value vec, int k)
 }
 
 void
-pic_vec_set(pic_state *PIC_UNUSED(pic), pic_value vec, int k, pic_value val)
+pic_vec_set(pic_state *pic, pic_value vec, int k, pic_value val)
 {
   pic_vec_ptr(pic, vec)->data[k] = val;
+  pic_gc_write_barrier(pic, pic_obj_ptr(vec), val);
 }
 
 int
@@ -44,143 +45,108 @@ pic_vec_len(pic_state *PIC_UNUSED(pic), pic_value vec)
 }
 
 static pic_value
-pic_vec_vector_p(pic_state *pic)
+pic_vec_vector_p(pic_state *pic, int PIC_UNUSED(argc), pic_value *argv)
 {
-  pic_value v;
-
-  pic_get_args(pic, "o", &v);
-
-  return pic_bool_value(pic, pic_vec_p(pic, v));
+  return pic_bool_value(pic, pic_vec_p(pic, argv[0]));
 }
 
 static pic_value
-pic_vec_vector(pic_state *pic)
+pic_vec_vector(pic_state *pic, int argc, pic_value *argv)
 {
-  int argc;
-  pic_value *argv;
-
-  pic_get_args(pic, "*", &argc, &argv);
-
   return pic_make_vec(pic, argc, argv);
 }
 
 static pic_value
-pic_vec_make_vector(pic_state *pic)
+pic_vec_make_vector(pic_state *pic, int argc, pic_value *argv)
 {
-  pic_value vec, init;
-  int n, k, i;
+  pic_value vec;
+  int k, i;
 
-  n = pic_get_args(pic, "i|o", &k, &init);
+  k = pic_int(pic, argv[0]);
 
   if (k < 0) {
     pic_error(pic, "make-vector: negative length given", 1, pic_int_value(pic, k));
   }
 
   vec = pic_make_vec(pic, k, NULL);
-  if (n == 2) {
+  if (argc == 2) {
     for (i = 0; i < k; ++i) {
-      pic_vec_set(pic, vec, i, init);
+      pic_vec_set(pic, vec, i, argv[1]);
     }
   }
   return vec;
 }
 
 static pic_value
-pic_vec_vector_length(pic_state *pic)
+pic_vec_vector_length(pic_state *pic, int PIC_UNUSED(argc), pic_value *argv)
 {
-  pic_value v;
-
-  pic_get_args(pic, "v", &v);
-
-  return pic_int_value(pic, pic_vec_len(pic, v));
+  return pic_int_value(pic, pic_vec_len(pic, argv[0]));
 }
 
 static pic_value
-pic_vec_vector_ref(pic_state *pic)
+pic_vec_vector_ref(pic_state *pic, int PIC_UNUSED(argc), pic_value *argv)
 {
-  pic_value v;
-  int k;
-
-  pic_get_args(pic, "vi", &v, &k);
+  int k = pic_int(pic, argv[1]);
 
-  VALID_INDEX(pic, pic_vec_len(pic, v), k);
+  VALID_INDEX(pic, pic_vec_len(pic, argv[0]), k);
 
-  return pic_vec_ref(pic, v, k);
+  return pic_vec_ref(pic, argv[0], k);
 }
 
 static pic_value
-pic_vec_vector_set(pic_state *pic)
+pic_vec_vector_set(pic_state *pic, int PIC_UNUSED(argc), pic_value *argv)
 {
-  pic_value v, o;
-  int k;
+  int k = pic_int(pic, argv[1]);
 
-  pic_get_args(pic, "vio", &v, &k, &o);
+  VALID_INDEX(pic, pic_vec_len(pic, argv[0]), k);
 
-  VALID_INDEX(pic, pic_vec_len(pic, v), k);
-
-  pic_vec_set(pic, v, k, o);
+  pic_vec_set(pic, argv[0], k, argv[2]);
 
   return pic_undef_value(pic);
 }
 
 static pic_value
-pic_vec_vector_copy_i(pic_state *pic)
+pic_vec_vector_copy_i(pic_state *pic, int argc, pic_value *argv)
 {
-  pic_value to, from;
-  int n, at, start, end, tolen, fromlen;
-
-  n = pic_get_args(pic, "viv|ii", &to, &at, &from, &start, &end);
+  pic_value to = argv[0], from = argv[2];
+  int at, start, end, tolen, fromlen;
 
   tolen = pic_vec_len(pic, to);
   fromlen = pic_vec_len(pic, from);
-
-  switch (n) {
-  case 3:
-    start = 0;
-  case 4:
-    end = fromlen;
-  }
+  at = pic_int(pic, argv[1]);
+  start = argc > 3 ? pic_int(pic, argv[3]) : 0;
+  end = argc > 4 ? pic_int(pic, argv[4]) : fromlen;
 
   VALID_ATRANGE(pic, tolen, at, fromlen, start, end);
 
   memmove(pic_vec_ptr(pic, to)->data + at, pic_vec_ptr(pic, from)->data + start, sizeof(pic_value) * (end - start));
+  pic_gc_remember(pic, pic_obj_ptr(to));
 
   return pic_undef_value(pic);
 }
 
 static pic_value
-pic_vec_vector_copy(pic_state *pic)
+pic_vec_vector_copy(pic_state *pic, int argc, pic_value *argv)
 {
-  pic_value from;
-  int n, start, end, fromlen;
-
-  n = pic_get_args(pic, "v|ii", &from, &start, &end);
-
-  fromlen = pic_vec_len(pic, from);
+  int start, end, fromlen;
 
-  switch (n) {
-  case 1:
-    start = 0;
-  case 2:
-    end = fromlen;
-  }
+  fromlen = pic_vec_len(pic, argv[0]);
+  start = argc > 1 ? pic_int(pic, argv[1]) : 0;
+  end = argc > 2 ? pic_int(pic, argv[2]) : fromlen;
 
   VALID_RANGE(pic, fromlen, start, end);
 
-  return pic_make_vec(pic, end - start, pic_vec_ptr(pic, from)->data + start);
+  return pic_make_vec(pic, end - start, pic_vec_ptr(pic, argv[0])->data + start);
 }
 
 static pic_value
-pic_vec_vector_append(pic_state *pic)
+pic_vec_vector_append(pic_state *pic, int argc, pic_value *argv)
 {
-  pic_value *argv, vec;
-  int argc, i, len;
-
-  pic_get_args(pic, "*", &argc, &argv);
+  pic_value vec;
+  int i, len;
 
   len = 0;
   for (i = 0; i < argc; ++i) {
-    TYPE_CHECK(pic, argv[i], vec);
     len += pic_vec_len(pic, argv[i]);
   }
 
@@ -197,48 +163,35 @@ pic_vec_vector_append(pic_state *pic)
 }
 
 static pic_value
-pic_vec_vector_fill_i(pic_state *pic)
+pic_vec_vector_fill_i(pic_state *pic, int argc, pic_value *argv)
 {
-  pic_value vec, obj;
-  int n, start, end, len;
+  int start, end, len;
 
-  n = pic_get_args(pic, "vo|ii", &vec, &obj, &start, &end);
-
-  len = pic_vec_len(pic, vec);
-
-  switch (n) {
-  case 2:
-    start = 0;
-  case 3:
-    end = len;
-  }
+  len = pic_vec_len(pic, argv[0]);
+  start = argc > 2 ? pic_int(pic, argv[2]) : 0;
+  end = argc > 3 ? pic_int(pic, argv[3]) : len;
 
   VALID_RANGE(pic, len, start, end);
 
   while (start < end) {
-    pic_vec_set(pic, vec, start++, obj);
+    pic_vec_set(pic, argv[0], start++, argv[1]);
   }
 
   return pic_undef_value(pic);
 }
 
 static pic_value
-pic_vec_vector_map(pic_state *pic)
+pic_vec_vector_map(pic_state *pic, int argc, pic_value *argv)
 {
-  int argc, i, len, j;
-  pic_value proc, *argv, vec, vals;
-
-  pic_get_args(pic, "l*", &proc, &argc, &argv);
+  int i, len, j;
+  pic_value proc = argv[0], vec, vals;
 
-  if (argc == 0) {
-    pic_error(pic, "vector-map: wrong number of arguments (1 for at least 2)", 0);
-  }
+  argc--;
+  argv++;
 
   len = INT_MAX;
   for (i = 0; i < argc; ++i) {
-    int l;
-    TYPE_CHECK(pic, argv[i], vec);
-    l = pic_vec_len(pic, argv[i]);
+    int l = pic_vec_len(pic, argv[i]);
     len = len < l ? len : l;
   }
 
@@ -257,22 +210,17 @@ pic_vec_vector_map(pic_state *pic)
 }
 
 static pic_value
-pic_vec_vector_for_each(pic_state *pic)
+pic_vec_vector_for_each(pic_state *pic, int argc, pic_value *argv)
 {
-  int argc, i, len, j;
-  pic_value proc, *argv, vals;
-
-  pic_get_args(pic, "l*", &proc, &argc, &argv);
+  int i, len, j;
+  pic_value proc = argv[0], vals;
 
-  if (argc == 0) {
-    pic_error(pic, "vector-for-each: wrong number of arguments (1 for at least 2)", 0);
-  }
+  argc--;
+  argv++;
 
   len = INT_MAX;
   for (i = 0; i < argc; ++i) {
-    int l;
-    TYPE_CHECK(pic, argv[i], vec);
-    l = pic_vec_len(pic, argv[i]);
+    int l = pic_vec_len(pic, argv[i]);
     len = len < l ? len : l;
   }
 
@@ -289,72 +237,55 @@ pic_vec_vector_for_each(pic_state *pic)
 }
 
 static pic_value
-pic_vec_list_to_vector(pic_state *pic)
+pic_vec_list_to_vector(pic_state *pic, int PIC_UNUSED(argc), pic_value *argv)
 {
-  pic_value list, vec, e, it;
+  pic_value vec, e, it;
   int len, i = 0;
 
-  pic_get_args(pic, "o", &list);
-
-  len = pic_length(pic, list);
+  len = pic_length(pic, argv[0]);
 
   vec = pic_make_vec(pic, len, NULL);
-  pic_for_each (e, list, it) {
+  pic_for_each (e, argv[0], it) {
     pic_vec_set(pic, vec, i++, e);
   }
   return vec;
 }
 
 static pic_value
-pic_vec_vector_to_list(pic_state *pic)
+pic_vec_vector_to_list(pic_state *pic, int argc, pic_value *argv)
 {
-  pic_value vec;
   pic_value list;
-  int n, start, end, i, len;
-
-  n = pic_get_args(pic, "v|ii", &vec, &start, &end);
+  int start, end, i, len;
 
-  len = pic_vec_len(pic, vec);
-
-  switch (n) {
-  case 1:
-    start = 0;
-  case 2:
-    end = len;
-  }
+  len = pic_vec_len(pic, argv[0]);
+  start = argc > 1 ? pic_int(pic, argv[1]) : 0;
+  end = argc > 2 ? pic_int(pic, argv[2]) : len;
 
   VALID_RANGE(pic, len, start, end);
 
   list = pic_nil_value(pic);
   for (i = start; i < end; ++i) {
-    pic_push(pic, pic_vec_ref(pic, vec, i), list);
+    pic_push(pic, pic_vec_ref(pic, argv[0], i), list);
   }
   return pic_reverse(pic, list);
 }
 
 static pic_value
-pic_vec_vector_to_string(pic_state *pic)
+pic_vec_vector_to_string(pic_state *pic, int argc, pic_value *argv)
 {
-  pic_value vec, t;
+  pic_value t;
   char *buf;
-  int n, start, end, i, len;
-
-  n = pic_get_args(pic, "v|ii", &vec, &start, &end);
+  int start, end, i, len;
 
-  len = pic_vec_len(pic, vec);
-
-  switch (n) {
-  case 1:
-    start = 0;
-  case 2:
-    end = len;
-  }
+  len = pic_vec_len(pic, argv[0]);
+  start = argc > 1 ? pic_int(pic, argv[1]) : 0;
+  end = argc > 2 ? pic_int(pic, argv[2]) : len;
 
   VALID_RANGE(pic, len, start, end);
 
   buf = pic_alloca(pic, end - start);
   for (i = start; i < end; ++i) {
-    t = pic_vec_ref(pic, vec, i);
+    t = pic_vec_ref(pic, argv[0], i);
 
     TYPE_CHECK(pic, t, char);
 
@@ -365,28 +296,21 @@ pic_vec_vector_to_string(pic_state *pic)
 }
 
 static pic_value
-pic_vec_string_to_vector(pic_state *pic)
+pic_vec_string_to_vector(pic_state *pic, int argc, pic_value *argv)
 {
-  pic_value str, vec;
-  int n, start, end, len, i;
-
-  n = pic_get_args(pic, "s|ii", &str, &start, &end);
-
-  len = pic_str_len(pic, str);
+  pic_value vec;
+  int start, end, len, i;
 
-  switch (n) {
-  case 1:
-    start = 0;
-  case 2:
-    end = len;
-  }
+  len = pic_str_len(pic, argv[0]);
+  start = argc > 1 ? pic_int(pic, argv[1]) : 0;
+  end = argc > 2 ? pic_int(pic, argv[2]) : len;
 
   VALID_RANGE(pic, len, start, end);
 
   vec = pic_make_vec(pic, end - start, NULL);
 
   for (i = 0; i < end - start; ++i) {
-    pic_vec_set(pic, vec, i, pic_char_value(pic, pic_str_ref(pic, str, i + start)));
+    pic_vec_set(pic, vec, i, pic_char_value(pic, pic_str_ref(pic, argv[0], i + start)));
   }
   return vec;
 }
@@ -394,20 +318,20 @@ pic_vec_string_to_vector(pic_state *pic)
 void
 pic_init_vector(pic_state *pic)
 {
-  pic_defun(pic, "vector?", pic_vec_vector_p);
-  pic_defun(pic, "vector", pic_vec_vector);
-  pic_defun(pic, "make-vector", pic_vec_make_vector);
-  pic_defun(pic, "vector-length", pic_vec_vector_length);
-  pic_defun(pic, "vector-ref", pic_vec_vector_ref);
-  pic_defun(pic, "vector-set!", pic_vec_vector_set);
-  pic_defun(pic, "vector-copy!", pic_vec_vector_copy_i);
-  pic_defun(pic, "vector-copy", pic_vec_vector_copy);
-  pic_defun(pic, "vector-append", pic_vec_vector_append);
-  pic_defun(pic, "vector-fill!", pic_vec_vector_fill_i);
-  pic_defun(pic, "vector-map", pic_vec_vector_map);
-  pic_defun(pic, "vector-for-each", pic_vec_vector_for_each);
-  pic_defun(pic, "list->vector", pic_vec_list_to_vector);
-  pic_defun(pic, "vector->list", pic_vec_vector_to_list);
-  pic_defun(pic, "string->vector", pic_vec_string_to_vector);
-  pic_defun(pic, "vector->string", pic_vec_vector_to_string);
+  pic_defun_sig(pic, "vector?", "o", pic_vec_vector_p);
+  pic_defun_sig(pic, "vector", "*", pic_vec_vector);
+  pic_defun_sig(pic, "make-vector", "i|o", pic_vec_make_vector);
+  pic_defun_sig(pic, "vector-length", "v", pic_vec_vector_length);
+  pic_defun_sig(pic, "vector-ref", "vi", pic_vec_vector_ref);
+  pic_defun_sig(pic, "vector-set!", "vio", pic_vec_vector_set);
+  pic_defun_sig(pic, "vector-copy!", "viv|ii", pic_vec_vector_copy_i);
+  pic_defun_sig(pic, "vector-copy", "v|ii", pic_vec_vector_copy);
+  pic_defun_sig(pic, "vector-append", "*v", pic_vec_vector_append);
+  pic_defun_sig(pic, "vector-fill!", "vo|ii", pic_vec_vector_fill_i);
+  pic_defun_sig(pic, "vector-map", "lv*v", pic_vec_vector_map);
+  pic_defun_sig(pic, "vector-for-each", "lv*v", pic_vec_vector_for_each);
+  pic_defun_sig(pic, "list->vector", "o", pic_vec_list_to_vector);
+  pic_defun_sig(pic, "vector->list", "v|ii", pic_vec_vector_to_list);
+  pic_defun_sig(pic, "string->vector", "s|ii", pic_vec_string_to_vector);
+  pic_defun_sig(pic, "vector->string", "v|ii", pic_vec_vector_to_string);
 }
@@ -41,6 +41,8 @@ pic_weak_set(pic_state *pic, pic_value weak, pic_value key, pic_value val)
 
   it = kh_put(weak, h, pic_obj_ptr(key), &ret);
   kh_val(h, it) = val;
+  pic_gc_write_barrier(pic, pic_obj_ptr(weak), key);
+  pic_gc_write_barrier(pic, pic_obj_ptr(weak), val);
 }
 
 bool
@@ -64,6 +66,28 @@ pic_weak_del(pic_state *pic, pic_value weak, pic_value key)
   kh_del(weak, h, it);
 }
 
+int
+pic_weak_size(pic_state *PIC_UNUSED(pic), pic_value weak)
+{
+  return kh_size(&pic_weak_ptr(pic, weak)->hash);
+}
+
+bool
+pic_weak_next(pic_state *PIC_UNUSED(pic), pic_value weak, int *iter, pic_value *key, pic_value *val)
+{
+  khash_t(weak) *h = &pic_weak_ptr(pic, weak)->hash;
+  int it;
+
+  for (it = *iter; it != kh_end(h); ++it) {
+    if (kh_exist(h, it)) {
+      if (key) *key = pic_obj_value(kh_key(h, it));
+      if (val) *val = kh_val(h, it);
+      *iter = ++it;
+      return true;
+    }
+  }
+  return false;
+}
 
 static pic_value
 weak_call(pic_state *pic)
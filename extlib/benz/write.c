@@ -25,41 +25,75 @@ struct writer_control {
 static void write_value(pic_state *pic, pic_value obj, pic_value port, int mode, int op);
 #endif
 
+/* formatted output goes to a port, or straight into a string builder */
+struct fmt_out {
+  pic_value port;
+  struct strbuf *sb;            /* NULL once output moved to a port,
+                                   which then holds what sb did */
+};
+
+static void
+put_str(pic_state *pic, struct fmt_out *out, const char *s, int len)
+{
+  if (out->sb) {
+    pic_strbuf_write(pic, out->sb, s, len);
+  } else {
+    pic_fwrite(pic, s, 1, len, out->port);
+  }
+}
+
+static void
+put_char(pic_state *pic, struct fmt_out *out, int c)
+{
+  if (out->sb) {
+    pic_strbuf_putc(pic, out->sb, c);
+  } else {
+    pic_fputc(pic, c, out->port);
+  }
+}
+
+#if PIC_USE_WRITE
+static pic_value
+out_port(pic_state *pic, struct fmt_out *out)
+{
+  if (out->sb) {
+    out->port = pic_strbuf_port(pic, out->sb);
+    out->sb = NULL;
+  }
+  return out->port;
+}
+#endif
+
 static void
-print_int(pic_state *pic, pic_value port, long x, int base)
+print_int(pic_state *pic, struct fmt_out *out, long x, int base)
 {
   static const char digits[] = "0123456789abcdef";
-  char buf[20];
+  char buf[24];
   int i, neg;
+  unsigned long u;
 
-  neg = 0;
-  if (x < 0) {
-    neg = 1;
-    x = -x;
-  }
+  neg = x < 0;
+  u = neg ? -(unsigned long)x : (unsigned long)x;
 
-  i = 0;
+  i = sizeof buf;
   do {
-    buf[i++] = digits[x % base];
-  } while ((x /= base) != 0);
+    buf[--i] = digits[u % base];
+  } while ((u /= base) != 0);
 
   if (neg) {
-    buf[i++] = '-';
+    buf[--i] = '-';
   }
 
-  while (i-- > 0) {
-    pic_fputc(pic, buf[i], port);
-  }
+  put_str(pic, out, buf + i, sizeof buf - i);
 }
 
-int
-pic_vfprintf(pic_state *pic, pic_value port, const char *fmt, va_list ap)
+static void
+vformat(pic_state *pic, struct fmt_out *out, const char *fmt, va_list ap)
 {
   const char *p;
   char *sval;
   int ival;
   void *vp;
-  long start = pic_fseek(pic, port, 0, PIC_SEEK_CUR);
 
   for (p = fmt; *p; p++) {
 
@@ -67,16 +101,16 @@ pic_vfprintf(pic_state *pic, pic_value port, const char *fmt, va_list ap)
     if (*p == '~') {
       switch (*++p) {
       default:
-        pic_fputc(pic, *(p-1), port);
+        put_char(pic, out, *(p-1));
         break;
       case '%':
-        pic_fputc(pic, '\n', port);
+        put_char(pic, out, '\n');
         break;
       case 'a':
-        write_value(pic, va_arg(ap, pic_value), port, DISPLAY_MODE, OP_WRITE);
+        write_value(pic, va_arg(ap, pic_value), out_port(pic, out), DISPLAY_MODE, OP_WRITE);
         break;
       case 's':
-        write_value(pic, va_arg(ap, pic_value), port, WRITE_MODE, OP_WRITE);
+        write_value(pic, va_arg(ap, pic_value), out_port(pic, out), WRITE_MODE, OP_WRITE);
         break;
       }
       continue;
@@ -84,46 +118,70 @@ pic_vfprintf(pic_state *pic, pic_value port, const char *fmt, va_list ap)
 #endif
 
     if (*p != '%') {
-      pic_fputc(pic, *p, port);
+      put_char(pic, out, *p);
       continue;
     }
     switch (*++p) {
     case 'd':
     case 'i':
       ival = va_arg(ap, int);
-      print_int(pic, port, ival, 10);
+      print_int(pic, out, ival, 10);
       break;
     case 'f': {
       char buf[64];
       PIC_DOUBLE_TO_CSTRING(va_arg(ap, double), buf);
-      pic_fputs(pic, buf, port);
+      put_str(pic, out, buf, strlen(buf));
       break;
     }
     case 'c':
       ival = va_arg(ap, int);
-      pic_fputc(pic, ival, port);
+      put_char(pic, out, ival);
       break;
     case 's':
       sval = va_arg(ap, char*);
-      pic_fputs(pic, sval, port);
+      put_str(pic, out, sval, strlen(sval));
       break;
     case 'p':
       vp = va_arg(ap, void*);
-      pic_fputs(pic, "0x", port);
-      print_int(pic, port, (long)vp, 16);
+      put_str(pic, out, "0x", 2);
+      print_int(pic, out, (long)vp, 16);
       break;
     case '%':
-      pic_fputc(pic, *(p-1), port);
+      put_char(pic, out, *(p-1));
       break;
     default:
-      pic_fputc(pic, '%', port);
-      pic_fputc(pic, *(p-1), port);
+      put_char(pic, out, '%');
+      put_char(pic, out, *(p-1));
       break;
     }
   }
+}
+
+int
+pic_vfprintf(pic_state *pic, pic_value port, const char *fmt, va_list ap)
+{
+  struct fmt_out out;
+  long start = pic_fseek(pic, port, 0, PIC_SEEK_CUR);
+
+  out.port = port;
+  out.sb = NULL;
+  vformat(pic, &out, fmt, ap);
   return pic_fseek(pic, port, 0, PIC_SEEK_CUR) - start;
 }
 
+void
+pic_strbuf_vprintf(pic_state *pic, struct strbuf *sb, const char *fmt, va_list ap)
+{
+  struct fmt_out out;
+
+  out.port = pic_invalid_value(pic);
+  out.sb = sb;
+  vformat(pic, &out, fmt, ap);
+  if (out.sb == NULL) {
+    pic_strbuf_port_close(pic, sb, out.port);
+  }
+}
+
 int
 pic_fprintf(pic_state *pic, pic_value port, const char *fmt, ...)
 {
@@ -0,0 +1,39 @@
+/**
+ *                                !!NOTICE!!
+ * This file was automatically generated by mkinit.pl, and includes all of
+ * the prelude files required by Picrin. PLEASE DO NOT EDIT THIS FILE, changes
+ * will be overwritten the next time the script runs.
+ */
+
+#include "picrin.h"
+
+void
+pic_init_contrib(pic_state *pic)
+{
+  void pic_init_callcc(pic_state *);
+  void pic_init_gc(pic_state *);
+  void pic_init_math(pic_state *);
+  void pic_init_optimize(pic_state *);
+  void pic_init_profile(pic_state *);
+  void pic_init_r7rs(pic_state *);
+  void pic_init_partcont(pic_state *);
+  void pic_init_random(pic_state *);
+  void pic_init_regexp(pic_state *);
+  void pic_init_srfi_0(pic_state *);
+  void pic_init_srfi_106(pic_state *);
+  void pic_init_srfi_125(pic_state *);
+  void pic_init_repl(pic_state *);
+  pic_init_callcc(pic);
+  pic_init_gc(pic);
+  pic_init_math(pic);
+  pic_init_optimize(pic);
+  pic_init_profile(pic);
+  pic_init_r7rs(pic);
+  pic_init_partcont(pic);
+  pic_init_random(pic);
+  pic_init_regexp(pic);
+  pic_init_srfi_0(pic);
+  pic_init_srfi_106(pic);
+  pic_init_srfi_125(pic);
+  pic_init_repl(pic);
+}
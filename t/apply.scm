@@ -0,0 +1,31 @@
+(import (scheme base)
+        (picrin test))
+
+(test-begin)
+
+(define (rest . xs) xs)
+(define (two a b . xs) (list a b xs))
+(define (add a b) (+ a b))
+
+(test '(1 2 3) (apply rest '(1 2 3)))
+(test '(0 1 (2 3)) (apply two 0 '(1 2 3)))
+(test '(0 1 (2 3 4)) (apply two 0 1 2 '(3 4)))
+(test 3 (apply add 1 '(2)))
+(test 0 (apply + '()))
+
+;; a rest list is handed over without being copied
+(define l (list 1 2 3))
+(test #t (eq? l (apply rest l)))
+
+(test #t (error-object? (guard (e (#t e)) (apply two '(1)))))
+(test #t (error-object? (guard (e (#t e)) (apply add 1 '(2 . 3)))))
+
+;; long argument lists are spread in linear time
+(define (iota n)
+  (let lp ((i n) (acc '()))
+    (if (= i 0) acc (lp (- i 1) (cons i acc)))))
+
+(test 100000 (length (apply list (iota 100000))))
+(test 200000 (string-length (apply string-append (map (lambda (x) "ab") (iota 100000)))))
+
+(test-end)
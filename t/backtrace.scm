@@ -0,0 +1,22 @@
+(import (scheme base)
+        (picrin base)
+        (picrin test))
+
+(test-begin)
+
+(define (fail x) (car x))
+
+(define e (guard (e (#t e)) (fail 5)))
+
+(test #t (string? (error-object-backtrace e)))
+(test #t (< 0 (string-length (error-object-backtrace e))))
+(test #t (eq? (error-object-backtrace e) (error-object-backtrace e)))
+
+;; capture can be turned off
+(define old (backtrace-depth 0))
+
+(test "" (error-object-backtrace (guard (e (#t e)) (fail 5))))
+(test 0 (backtrace-depth old))
+(test old (backtrace-depth))
+
+(test-end)
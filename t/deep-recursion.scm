@@ -0,0 +1,26 @@
+(import (scheme base)
+        (picrin test))
+
+(test-begin)
+
+(define (count n)
+  (if (= n 0)
+      0
+      (+ 1 (count (- n 1)))))
+
+(test 100000 (count 100000))
+
+(define (diverge n)
+  (+ 1 (diverge n)))
+
+(test "VM stack overflow"
+      (guard (c ((error-object? c) (error-object-message c)))
+             (diverge 0)))
+
+(test "VM stack overflow"
+      (guard (c ((error-object? c) (error-object-message c)))
+             (diverge 0)))
+
+(test 10 (count 10))
+
+(test-end)
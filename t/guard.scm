@@ -0,0 +1,44 @@
+(import (scheme base)
+        (picrin test))
+
+(test-begin)
+
+(test '(1 2 3) (call-with-values (lambda () (guard (e (#t 0)) (values 1 2 3))) list))
+
+(test 42 (guard (e ((assq 'a e) => cdr) ((assq 'b e))) (raise (list (cons 'a 42)))))
+
+(test '(b . 23) (guard (e ((assq 'a e) => cdr) ((assq 'b e))) (raise (list (cons 'b 23)))))
+
+(test 'outer (guard (e ((string? e) 'outer)) (guard (e ((number? e) 'inner)) (raise "s"))))
+
+;; a condition raised by a clause test goes to the outer handler
+(test '(outer from-test)
+      (guard (e ((symbol? e) (list 'outer e)))
+        (guard (e ((raise 'from-test) 'no))
+          (raise 1))))
+
+;; clauses run in the guard's dynamic environment, re-raising returns to
+;; the one of raise-continuable
+(define trail '())
+
+(test 11 (with-exception-handler
+          (lambda (e) (set! trail (cons 'handler trail)) 10)
+          (lambda ()
+            (guard (e ((string? e) 'no))
+              (dynamic-wind
+                  (lambda () (set! trail (cons 'in trail)))
+                  (lambda () (+ 1 (raise-continuable 'c)))
+                  (lambda () (set! trail (cons 'out trail))))))))
+
+(test '(in out in handler out) (reverse trail))
+
+;; clause bodies are in tail position
+(define (unwind n)
+  (if (= n 0)
+      'done
+      (guard (e (#t (unwind (- n 1))))
+        (raise n))))
+
+(test 'done (unwind 100000))
+
+(test-end)
@@ -0,0 +1,45 @@
+(import (scheme base)
+        (picrin test))
+
+(test-begin)
+
+(define-syntax swap!
+  (syntax-rules ()
+    ((_ a b) (let ((tmp a)) (set! a b) (set! b tmp)))))
+
+(define (swapped)
+  (let ((tmp 1) (x 2))
+    (swap! tmp x)
+    (list tmp x)))
+
+(test '(2 1) (swapped))
+
+;; renamed identifiers are uninterned, so their printed names do not read back as them
+(define early-error #f)
+
+(define-syntax define-early
+  (syntax-rules ()
+    ((_ get)
+     (begin
+       (define (get) tmp)
+       (define tmp (guard (e (#t (set! early-error e) 0)) (get)))))))
+
+(define-early get-early)
+
+(define renamed (car (error-object-irritants early-error)))
+
+(test #t (symbol? renamed))
+(test #f (eq? renamed (string->symbol (symbol->string renamed))))
+
+(define-syntax my-or
+  (syntax-rules ()
+    ((_) #f)
+    ((_ e) e)
+    ((_ e r ...) (let ((t e)) (if t t (my-or r ...))))))
+
+(define (try t)
+  (my-or #f t))
+
+(test 5 (try 5))
+
+(test-end)
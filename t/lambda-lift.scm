@@ -0,0 +1,42 @@
+(import (scheme base)
+        (picrin test))
+
+(test-begin)
+
+(define (parity n k)
+  (define (ev? n) (if (= n 0) #t (od? (- n 1))))
+  (define (od? n) (if (= n 0) #f (ev? (- n 1))))
+  (define (fact n) (if (= n 0) 1 (* n (fact (- n 1)))))
+  (define (tag . xs) (cons k xs))
+  (list (ev? n) (od? n) (fact 5) (tag 1 2)))
+
+(test '(#t #f 120 (k 1 2)) (parity 10 'k))
+
+;; free variables assigned after their definition are not copied
+(define (late x)
+  (define y 1)
+  (define (get) (+ x y))
+  (set! y 10)
+  (get))
+
+(test 15 (late 5))
+
+(define (assigned x)
+  (define (get) x)
+  (set! x 7)
+  (get))
+
+(test 7 (assigned 5))
+
+;; a lifted procedure may itself be passed around
+(define (sums l)
+  (define (total a)
+    (let loop ((l l) (acc a))
+      (if (null? l)
+          acc
+          (loop (cdr l) (+ acc (car l))))))
+  (map total '(0 10)))
+
+(test '(6 16) (sums '(1 2 3)))
+
+(test-end)
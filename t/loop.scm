@@ -0,0 +1,49 @@
+(import (scheme base)
+        (picrin test))
+
+(test-begin)
+
+(define (sum-to n)
+  (let lp ((i 0) (s 0))
+    (if (= i n)
+        s
+        (lp (+ i 1) (+ s i)))))
+
+(test 49995000 (sum-to 10000))
+
+;; arguments are assigned in parallel
+(define (fib n)
+  (let lp ((n n) (a 0) (b 1))
+    (if (= n 0)
+        a
+        (lp (- n 1) b (+ a b)))))
+
+(test 55 (fib 10))
+
+;; captured variables are fresh in every iteration
+(define (thunks n)
+  (let lp ((i 0) (acc '()))
+    (if (= i n)
+        (map (lambda (f) (f)) acc)
+        (lp (+ i 1) (cons (lambda () i) acc)))))
+
+(test '(2 1 0) (thunks 3))
+
+(define (count . xs)
+  (define (lp xs n)
+    (if (null? xs)
+        n
+        (lp (cdr xs) (+ n 1))))
+  (lp xs 0))
+
+(test 3 (count 'a 'b 'c))
+
+(define (wrong-arity)
+  (define (lp x)
+    (if x (lp) 'done))
+  (lp #t))
+
+(test #t (guard (e (#t (error-object? e)))
+           (wrong-arity)))
+
+(test-end)
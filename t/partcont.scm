@@ -0,0 +1,31 @@
+(import (scheme base)
+        (picrin control)
+        (picrin test))
+
+(test-begin)
+
+(test 3 (+ 1 (reset (+ 1 (shift k 2)))))
+
+(test 11 (+ 1 (reset (+ 1 (shift k (k (k 8)))))))
+
+;; a captured continuation may be invoked many times after reset returns
+(define saved #f)
+(test 0 (reset (+ 1 (shift k (set! saved k) 0))))
+(test '(2 11 101) (list (saved 1) (saved 10) (saved 100)))
+
+;; nested resets delimit independently
+(test '(a b c)
+      (reset (cons 'a (reset (list 'b (shift k (k 'c)))))))
+
+;; shift through a native frame falls back to the full implementation
+(test '(1 2 3)
+      (reset (map (lambda (x) (shift k (k x))) '(1 2 3))))
+
+(define (walk l)
+  (reset
+   (for-each (lambda (x) (shift k (cons x (k #f)))) l)
+   '()))
+
+(test '(x y z) (walk '(x y z)))
+
+(test-end)
@@ -0,0 +1,91 @@
+(import (scheme base)
+        (picrin base)
+        (picrin test))
+
+(test-begin)
+
+(define (error? thunk)
+  (guard (e (#t (error-object? e)))
+    (thunk)
+    #f))
+
+(define v (vector 1 2 3))
+(define s "abc")
+(define p (list 1 2))
+
+(test 2 (vector-ref v 1))
+(test 3 (vector-length v))
+(test '#(1 x 3) (begin (vector-set! v 1 'x) v))
+(test #t (error? (lambda () (vector-ref v 3))))
+(test #t (error? (lambda () (vector-ref v -1))))
+(test #t (error? (lambda () (vector-ref p 0))))
+(test #t (error? (lambda () (vector-set! v 1.5 0))))
+(test #t (error? (lambda () (vector-length s))))
+
+(test #\b (string-ref s 1))
+(test 3 (string-length s))
+(test #t (error? (lambda () (string-ref s 3))))
+(test #t (error? (lambda () (string-length v))))
+
+(test #t (char=? #\a (string-ref s 0)))
+(test #f (char<? #\b #\a))
+(test 97 (char->integer #\a))
+(test #t (error? (lambda () (char=? #\a 1))))
+(test #t (error? (lambda () (char->integer "a"))))
+
+(test '(3 2) (begin (set-car! p 3) p))
+(test '(2 . 4) (begin (set-cdr! (cdr p) 4) (cdr p)))
+(test #t (error? (lambda () (set-car! '() 1))))
+
+;; the slow path leaves the builtin's result in place of its operands
+(test '(x b #\c y) (list 'x (vector-ref (vector 'a 'b) 1.0) (string-ref s 2.0) 'y))
+
+(test #t (eq? 'a 'a))
+(test #t (eqv? 1.5 1.5))
+(test '(#t #f #t #t) (map (lambda (x) (if (eq? x 'a) #t #f)) '(a b a a)))
+
+(define-record-type point (make-point x y) point? (x point-x set-point-x!) (y point-y))
+
+(define pt (make-point 1 2))
+
+(test 1 (point-x pt))
+(test 5 (begin (set-point-x! pt 5) (point-x pt)))
+(test #t (error? (lambda () (point-y v))))
+
+;; n-ary arithmetic and comparisons
+(define (sum3 a b c) (+ a b c))
+(define (prod4 a b c d) (* a b c d))
+(define (between? a b c) (< a b c))
+(define (all= a b c d) (= a b c d))
+
+(test 6 (sum3 1 2 3))
+(test 6.5 (sum3 1 2 3.5))
+(test 24 (prod4 1 2 3 4))
+(test #t (between? 1 2 3))
+(test #f (between? 1 3 2))
+(test #f (between? 3 2 1))
+(test #t (all= 1 1 1 1))
+(test #f (all= 1 1 2 1))
+(test #t (error? (lambda () (sum3 1 'a 2))))
+
+;; a shadowed name is not the builtin
+(define (shadow vector-ref)
+  (vector-ref 1 2))
+
+(test 3 (shadow +))
+
+;; arguments of natives are checked against their signatures
+(test 2 (vector-ref (vector 1 2) 1.0))
+(test #t (error? (lambda () (vector-ref v 1e300))))
+(test #t (error? (lambda () (vector-ref v (/ 0. 0.)))))
+(test #t (error? (lambda () (vector-ref v))))
+(test #t (error? (lambda () (vector-ref v 0 1))))
+(test #t (error? (lambda () (string-append "a" 'b))))
+(test #t (error? (lambda () (char<? #\a #\b 1))))
+(test #t (error? (lambda () (map car))))
+(test '(x x) (make-list 2 'x))
+(test "el" (string-copy "hello" 1 3))
+(test #u8(2 3) (bytevector-copy (bytevector 1 2 3) 1))
+(test '(2) (member 2.0 '(1 2) =))
+
+(test-end)
@@ -0,0 +1,83 @@
+(import (scheme base)
+        (picrin test))
+
+(test-begin)
+
+;; in-place mutation does not leak into strings sharing the same text
+(define s (make-string 5 #\a))
+(define t (string-append s "b"))
+(define u (string-copy s 1 3))
+(string-set! s 0 #\x)
+(test "xaaaa" s)
+(test "aaaaab" t)
+(test "aa" u)
+
+(string-fill! s #\z 2 4)
+(test "xazza" s)
+
+(define lit "hello")
+(define v (string-copy lit))
+(string-set! v 0 #\j)
+(test "hello" lit)
+(test "jello" v)
+
+;; string-copy! handles overlapping ranges within one string
+(define w (string-copy "abcdefgh"))
+(string-copy! w 2 w 0 4)
+(test "ababcdgh" w)
+(string-copy! w 0 "XY")
+(test "XYabcdgh" w)
+
+;; long chains of appends stay indexable
+(define (build n)
+  (let lp ((i 0) (acc ""))
+    (if (= i n)
+        acc
+        (lp (+ i 1) (string-append acc (string (integer->char (+ 97 (modulo i 26)))))))))
+
+(define long (build 10000))
+(test 10000 (string-length long))
+(test #\a (string-ref long 0))
+(test #\p (string-ref long 9999))
+(test "xyzab" (substring long 23 28))
+
+(define (build-left n)
+  (let lp ((i 0) (acc ""))
+    (if (= i n)
+        acc
+        (lp (+ i 1) (string-append (string (integer->char (+ 97 (modulo i 26)))) acc)))))
+
+(define long2 (build-left 10000))
+(test #\p (string-ref long2 0))
+(test #\a (string-ref long2 9999))
+(test (list->string (reverse (string->list long))) long2)
+
+(let lp ((i 0))
+  (when (< i 10000)
+    (string-set! long i #\-)
+    (lp (+ i 2))))
+(test "-b-d-" (substring long 0 5))
+
+;; comparison and interning see through rope structure
+(define a (string-append (make-string 100 #\x) "a" (make-string 100 #\y)))
+(define b (string-append (make-string 100 #\x) (string-append "a" (make-string 100 #\y))))
+(test #t (string=? a b))
+(test #t (eq? (string->symbol a) (string->symbol b)))
+(test #t (string<? (substring a 0 100) a))
+(test #t (string<? a (string-append (make-string 100 #\x) "b")))
+(test #f (string=? a (string-append a "")  (substring a 1 201)))
+(test 'car (string->symbol (string-append "c" "ar")))
+
+;; output string ports may be read out and written to again
+(define out (open-output-string))
+(test "" (get-output-string out))
+(write-string "abc" out)
+(define abc (get-output-string out))
+(write 12 out)
+(test "abc" abc)
+(test "abc12" (get-output-string out))
+(string-set! abc 0 #\x)
+(test "abc12" (get-output-string out))
+(test "3.5" (number->string 3.5))
+
+(test-end)